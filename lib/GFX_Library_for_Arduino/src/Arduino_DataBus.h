@@ -142,6 +142,14 @@ typedef volatile ARDUINOGFX_PORT_t *PORTreg_t;
 #define GFX_INLINE inline
 #endif // !defined(LITTLE_FOOT_PRINT)
 
+// Per-pixel and bus paths that stall on flash cache misses; build with
+// -DGFX_IRAM_HOT to run them from IRAM instead
+#if defined(ESP32) && defined(GFX_IRAM_HOT)
+#define GFX_IRAM_ATTR IRAM_ATTR
+#else
+#define GFX_IRAM_ATTR
+#endif // defined(ESP32) && defined(GFX_IRAM_HOT)
+
 #if defined(ESP32) && (CONFIG_IDF_TARGET_ESP32S3)
 #if (!defined(ESP_ARDUINO_VERSION_MAJOR)) || (ESP_ARDUINO_VERSION_MAJOR < 3)
 #include <esp_lcd_panel_io.h>
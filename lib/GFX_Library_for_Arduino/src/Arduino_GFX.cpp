@@ -9,6 +9,7 @@
 #include "Arduino_GFX.h"
 #include "font/glcdfont.h"
 #include "float.h"
+#include "fixed_math.h"
 #ifdef __AVR__
 #include <avr/pgmspace.h>
 #elif defined(ESP8266) || defined(ESP32)
@@ -329,6 +330,7 @@ GFX_INLINE void Arduino_GFX::endWrite()
 void Arduino_GFX::drawFastVLine(int16_t x, int16_t y,
                                 int16_t h, uint16_t color)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_FAST_VLINE);
   startWrite();
   writeFastVLine(x, y, h, color);
   endWrite();
@@ -346,6 +348,7 @@ void Arduino_GFX::drawFastVLine(int16_t x, int16_t y,
 void Arduino_GFX::drawFastHLine(int16_t x, int16_t y,
                                 int16_t w, uint16_t color)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_FAST_HLINE);
   startWrite();
   writeFastHLine(x, y, w, color);
   endWrite();
@@ -364,6 +367,7 @@ void Arduino_GFX::drawFastHLine(int16_t x, int16_t y,
 void Arduino_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
                            uint16_t color)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_FILL_RECT);
   startWrite();
   writeFillRect(x, y, w, h, color);
   endWrite();
@@ -377,6 +381,7 @@ void Arduino_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
 /**************************************************************************/
 void Arduino_GFX::fillScreen(uint16_t color)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_FILL_SCREEN);
   fillRect(0, 0, _width, _height, color);
 }
 
@@ -728,8 +733,13 @@ void Arduino_GFX::fillArc(int16_t x, int16_t y, int16_t r1, int16_t r2, float st
     end = 360.0;
   }
 
+  if (equal)
+  {
+    return;
+  }
+
   startWrite();
-  writeFillArcHelper(x, y, r1, r2, start, end, color);
+  writeFillArcHelperQ16(x, y, r1, r2, GFX_DEG_TO_ANGLE_Q16(start), GFX_DEG_TO_ANGLE_Q16(end), color);
   endWrite();
 }
 
@@ -747,96 +757,319 @@ void Arduino_GFX::fillArc(int16_t x, int16_t y, int16_t r1, int16_t r2, float st
 /**************************************************************************/
 void Arduino_GFX::writeFillArcHelper(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, float start, float end, uint16_t color)
 {
-  if ((start == 90.0) || (start == 180.0) || (start == 270.0) || (start == 360.0))
+  int32_t s = GFX_DEG_TO_ANGLE_Q16(start);
+  int32_t e = GFX_DEG_TO_ANGLE_Q16(end);
+  if (s != e)
   {
-    start -= 0.1;
+    writeFillArcHelperQ16(cx, cy, oradius, iradius, s, e, color);
+    return;
   }
 
-  if ((end == 90.0) || (end == 180.0) || (end == 270.0) || (end == 360.0))
+  // zero sweep, draw the radial edge from inner to outer radius
+  int32_t c = fx_cos_q15(s);
+  int32_t n = fx_sin_q15(s);
+  writeLine(cx + fx_mul_q15(iradius, c), cy + fx_mul_q15(iradius, n),
+            cx + fx_mul_q15(oradius, c), cy + fx_mul_q15(oradius, n), color);
+}
+
+static int32_t gfx_floor_div(int32_t n, int32_t d)
+{
+  int32_t q = n / d;
+  if ((n % d) && (n < 0))
   {
-    end -= 0.1;
+    --q;
   }
+  return q;
+}
 
-  float s_cos = (cos(start * DEGTORAD));
-  float e_cos = (cos(end * DEGTORAD));
-  float sslope = s_cos / (sin(start * DEGTORAD));
-  float eslope = e_cos / (sin(end * DEGTORAD));
-  float swidth = 0.5 / s_cos;
-  float ewidth = -0.5 / e_cos;
-  --iradius;
-  int32_t ir2 = iradius * iradius + iradius;
-  int32_t or2 = oradius * oradius + oradius;
+// Inclusive x interval on one row where a * x <= b, empty when lo > hi
+static void gfx_half_plane_span(int32_t a, int32_t b, int32_t *lo, int32_t *hi)
+{
+  if (a > 0)
+  {
+    *lo = INT16_MIN;
+    *hi = gfx_floor_div(b, a);
+  }
+  else if (a < 0)
+  {
+    *lo = -gfx_floor_div(b, -a);
+    *hi = INT16_MAX;
+  }
+  else if (b >= 0)
+  {
+    *lo = INT16_MIN;
+    *hi = INT16_MAX;
+  }
+  else
+  {
+    *lo = 1;
+    *hi = 0;
+  }
+}
 
-  bool start180 = !(start < 180.0);
-  bool end180 = end < 180.0;
-  bool reversed = start + 180.0 < end || (end < start && start < end + 180.0);
+/**************************************************************************/
+/*!
+  @brief  Draw a ring (annulus) with filled color, integer only
+  @param  x       Center-point x coordinate
+  @param  y       Center-point y coordinate
+  @param  r_out   Outer radius of ring
+  @param  r_in    Inner radius of ring, 0 or 1 fills a disc
+  @param  color   16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void Arduino_GFX::fillRing(int16_t x, int16_t y, int16_t r_out, int16_t r_in, uint16_t color)
+{
+  GFX_PROFILE_SCOPE(GFX_PROBE_FILL_RING);
+  if (r_out < r_in)
+  {
+    _swap_int16_t(r_out, r_in);
+  }
+  startWrite();
+  writeFillRingHelper(x, y, r_out, r_in, color);
+  endWrite();
+}
 
-  int32_t xs = -oradius;
-  int32_t y = -oradius;
-  int32_t ye = oradius;
-  int32_t xe = oradius + 1;
-  if (!reversed)
+/**************************************************************************/
+/*!
+  @brief  Ring drawer with fill, one horizontal span per ring edge and row.
+          Uses the same radius bounds as writeFillArcHelper(), so a full
+          sweep arc and a ring cover exactly the same pixels.
+  @param  cx      Center-point x coordinate
+  @param  cy      Center-point y coordinate
+  @param  oradius Outer radius of ring
+  @param  iradius Inner radius of ring
+  @param  color   16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void Arduino_GFX::writeFillRingHelper(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, uint16_t color)
+{
+  if (oradius < 0)
+  {
+    return;
+  }
+  if (iradius < 1)
+  {
+    iradius = 1;
+  }
+  --iradius;
+  int32_t or2 = (int32_t)oradius * oradius + oradius;
+  int32_t ir2 = (int32_t)iradius * iradius + iradius;
+
+  // the boundary x of both edges only shrinks while walking out from the
+  // center row, each span is mirrored to the other three quadrants
+  int32_t xo = oradius;
+  int32_t xi = iradius;
+  for (int32_t y = 0; y <= oradius; ++y)
   {
-    if ((end >= 270 || end < 90) && (start >= 270 || start < 90))
+    int32_t y2 = y * y;
+    while ((xo >= 0) && (xo * xo + y2 >= or2))
     {
-      xs = 0;
+      --xo;
     }
-    else if (end < 270 && end >= 90 && start < 270 && start >= 90)
+    if (xo < 0)
     {
-      xe = 1;
+      break;
     }
-    if (end >= 180 && start >= 180)
+    while ((xi >= 0) && (xi * xi + y2 >= ir2))
     {
-      ye = 0;
+      --xi;
+    }
+    if (xi < 0)
+    {
+      writeFastHLine(cx - xo, cy - y, (xo << 1) + 1, color);
+      if (y)
+      {
+        writeFastHLine(cx - xo, cy + y, (xo << 1) + 1, color);
+      }
     }
-    else if (end < 180 && start < 180)
+    else if (xo > xi)
     {
-      y = 0;
+      int16_t len = xo - xi;
+      writeFastHLine(cx - xo, cy - y, len, color);
+      writeFastHLine(cx + xi + 1, cy - y, len, color);
+      if (y)
+      {
+        writeFastHLine(cx - xo, cy + y, len, color);
+        writeFastHLine(cx + xi + 1, cy + y, len, color);
+      }
     }
   }
-  do
+}
+
+/**************************************************************************/
+/*!
+  @brief  Draw an arc with filled color, integer only
+  @param  x       Center-point x coordinate
+  @param  y       Center-point y coordinate
+  @param  r1      Outer radius of arc
+  @param  r2      Inner radius of arc
+  @param  start   Q16 angle of arc start (GFX_ANGLE_Q16_TURN = 360 degree)
+  @param  end     Q16 angle of arc end, clockwise from start
+  @param  color   16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void Arduino_GFX::fillArcQ16(int16_t x, int16_t y, int16_t r1, int16_t r2, int32_t start, int32_t end, uint16_t color)
+{
+  GFX_PROFILE_SCOPE(GFX_PROBE_FILL_ARC);
+  if (r1 < r2)
   {
-    int32_t y2 = y * y;
-    int32_t x = xs;
-    if (x < 0)
+    _swap_int16_t(r1, r2);
+  }
+  if (r1 < 1)
+  {
+    r1 = 1;
+  }
+  if (r2 < 1)
+  {
+    r2 = 1;
+  }
+
+  startWrite();
+  writeFillArcHelperQ16(x, y, r1, r2, start, end, color);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+  @brief  Arc drawer with fill, integer only. Each row of the ring is
+          clipped against the two half-planes bounding the sweep, so the
+          output is at most four horizontal spans per row.
+  @param  cx      Center-point x coordinate
+  @param  cy      Center-point y coordinate
+  @param  oradius Outer radius of arc
+  @param  iradius Inner radius of arc
+  @param  start   Q16 angle of arc start
+  @param  end     Q16 angle of arc end, a sweep of one full turn or more
+                  draws the whole ring, an equal start and end draws nothing
+  @param  color   16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void Arduino_GFX::writeFillArcHelperQ16(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, int32_t start, int32_t end, uint16_t color)
+{
+  int32_t sweep = end - start;
+  if (sweep == 0)
+  {
+    return;
+  }
+  if ((sweep >= GFX_ANGLE_Q16_TURN) || ((sweep & (GFX_ANGLE_Q16_TURN - 1)) == 0))
+  {
+    writeFillRingHelper(cx, cy, oradius, iradius, color);
+    return;
+  }
+  sweep &= GFX_ANGLE_Q16_TURN - 1;
+  end = start + sweep;
+  bool wide = sweep > (GFX_ANGLE_Q16_TURN >> 1);
+
+  int32_t sx = fx_cos_q15(start);
+  int32_t sy = fx_sin_q15(start);
+  int32_t ex = fx_cos_q15(end);
+  int32_t ey = fx_sin_q15(end);
+
+  if (oradius < 0)
+  {
+    return;
+  }
+  if (iradius < 1)
+  {
+    iradius = 1;
+  }
+  --iradius;
+  int32_t or2 = (int32_t)oradius * oradius + oradius;
+  int32_t ir2 = (int32_t)iradius * iradius + iradius;
+
+  int32_t xo = oradius;
+  int32_t xi = iradius;
+  for (int32_t yy = 0; yy <= oradius; ++yy)
+  {
+    int32_t y2 = yy * yy;
+    while ((xo >= 0) && (xo * xo + y2 >= or2))
+    {
+      --xo;
+    }
+    if (xo < 0)
+    {
+      break;
+    }
+    while ((xi >= 0) && (xi * xi + y2 >= ir2))
+    {
+      --xi;
+    }
+
+    // ring spans of this row
+    int32_t rlo[2], rhi[2];
+    uint8_t rn;
+    if (xi < 0)
+    {
+      rlo[0] = -xo;
+      rhi[0] = xo;
+      rn = 1;
+    }
+    else
     {
-      while (x * x + y2 >= or2)
+      rlo[0] = -xo;
+      rhi[0] = -xi - 1;
+      rlo[1] = xi + 1;
+      rhi[1] = xo;
+      rn = 2;
+    }
+
+    for (int32_t y = -yy;; y = yy)
+    {
+      // cross(S, P) >= 0 and cross(P, E) >= 0 bound the sweep
+      int32_t alo, ahi, blo, bhi;
+      gfx_half_plane_span(sy, sx * y, &alo, &ahi);
+      gfx_half_plane_span(-ey, -ex * y, &blo, &bhi);
+
+      int32_t slo[2], shi[2];
+      uint8_t sn = 1;
+      if (!wide)
       {
-        ++x;
+        slo[0] = (alo > blo) ? alo : blo;
+        shi[0] = (ahi < bhi) ? ahi : bhi;
       }
-      if (xe != 1)
+      else if (alo > ahi)
       {
-        xe = 1 - x;
+        slo[0] = blo;
+        shi[0] = bhi;
       }
-    }
-    float ysslope = (y + swidth) * sslope;
-    float yeslope = (y + ewidth) * eslope;
-    int32_t len = 0;
-    do
-    {
-      bool flg1 = start180 != (x <= ysslope);
-      bool flg2 = end180 != (x <= yeslope);
-      int32_t distance = x * x + y2;
-      if (distance >= ir2 && ((flg1 && flg2) || (reversed && (flg1 || flg2))) && x != xe && distance < or2)
+      else if (blo > bhi)
+      {
+        slo[0] = alo;
+        shi[0] = ahi;
+      }
+      else if (((alo > blo) ? alo : blo) <= ((ahi < bhi) ? ahi : bhi) + 1)
       {
-        ++len;
+        slo[0] = (alo < blo) ? alo : blo;
+        shi[0] = (ahi > bhi) ? ahi : bhi;
       }
       else
       {
-        if (len)
-        {
-          writeFastHLine(cx + x - len, cy + y, len, color);
-          len = 0;
-        }
-        if (distance >= or2)
-          break;
-        if (x < 0 && distance < ir2)
+        slo[0] = alo;
+        shi[0] = ahi;
+        slo[1] = blo;
+        shi[1] = bhi;
+        sn = 2;
+      }
+
+      for (uint8_t r = 0; r < rn; ++r)
+      {
+        for (uint8_t s = 0; s < sn; ++s)
         {
-          x = -x;
+          int32_t l = (rlo[r] > slo[s]) ? rlo[r] : slo[s];
+          int32_t h = (rhi[r] < shi[s]) ? rhi[r] : shi[s];
+          if (l <= h)
+          {
+            writeFastHLine(cx + l, cy + y, h - l + 1, color);
+          }
         }
       }
-    } while (++x <= xe);
-  } while (++y <= ye);
+
+      if (y == yy)
+      {
+        break;
+      }
+    }
+  }
 }
 
 /**************************************************************************/
@@ -852,6 +1085,7 @@ void Arduino_GFX::writeFillArcHelper(int16_t cx, int16_t cy, int16_t oradius, in
 void Arduino_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
                            uint16_t color)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_DRAW_RECT);
   startWrite();
   writeFastHLine(x, y, w, color);
   writeFastHLine(x, y + h - 1, w, color);
@@ -1536,6 +1770,7 @@ void Arduino_GFX::draw16bitRGBBitmap(int16_t x, int16_t y,
 void Arduino_GFX::draw16bitRGBBitmap(int16_t x, int16_t y,
                                      uint16_t *bitmap, int16_t w, int16_t h)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_BITMAP16);
   int32_t offset = 0;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -2020,8 +2255,8 @@ void Arduino_GFX::u8g2_font_decode_len(uint8_t len, uint8_t is_foreground, uint1
   @param  bg      16-bit 5-6-5 Color to fill background with (if same as color, no background)
 */
 /**************************************************************************/
-void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
-                           uint16_t color, uint16_t bg)
+void GFX_IRAM_ATTR Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                                         uint16_t color, uint16_t bg)
 {
   int16_t block_w, block_h, curX, curY, curW, curH;
 
@@ -2290,6 +2525,7 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 /**************************************************************************/
 size_t Arduino_GFX::write(uint8_t c)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_TEXT_WRITE);
 #if !defined(ATTINY_CORE)
   if (gfxFont) // custom font
   {
@@ -2930,6 +3166,7 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
 void Arduino_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
                                 int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_TEXT_BOUNDS);
   uint8_t c; // Current character
 
   *x1 = x;
@@ -7,6 +7,7 @@
 
 #include "Arduino_G.h"
 #include "Arduino_DataBus.h"
+#include "Arduino_GFX_Profile.h"
 #include <Print.h>
 
 #if !defined(ATTINY_CORE)
@@ -17,6 +18,11 @@
 #define DEGTORAD 0.017453292519943295769236907684886F
 #endif
 
+// Q16 binary angle: one full turn is 65536, 0 points to +x (3 o'clock), increasing clockwise
+#define GFX_ANGLE_Q16_TURN 65536L
+#define GFX_ANGLE_Q16_QUARTER 16384L
+#define GFX_DEG_TO_ANGLE_Q16(d) ((int32_t)((d) * (GFX_ANGLE_Q16_TURN / 360.0F)))
+
 #if __has_include(<U8g2lib.h>)
 #include <U8g2lib.h>
 #define U8G2_FONT_SUPPORT
@@ -252,6 +258,12 @@ public:
   void fillArc(int16_t x, int16_t y, int16_t r1, int16_t r2, float start, float end, uint16_t color);
   void writeFillArcHelper(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, float start, float end, uint16_t color);
 
+  // integer-only ring and arc rasterizer, angles in Q16 turns (GFX_ANGLE_Q16_TURN = 360 degree)
+  void fillRing(int16_t x, int16_t y, int16_t r_out, int16_t r_in, uint16_t color);
+  void writeFillRingHelper(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, uint16_t color);
+  void fillArcQ16(int16_t x, int16_t y, int16_t r1, int16_t r2, int32_t start, int32_t end, uint16_t color);
+  void writeFillArcHelperQ16(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, int32_t start, int32_t end, uint16_t color);
+
 // TFT optimization code, too big for ATMEL family
 #if defined(LITTLE_FOOT_PRINT)
   void writeSlashLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
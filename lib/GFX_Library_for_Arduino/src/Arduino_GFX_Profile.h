@@ -0,0 +1,63 @@
+#ifndef _ARDUINO_GFX_PROFILE_H_
+#define _ARDUINO_GFX_PROFILE_H_
+
+/*
+ * Optional cycle-count probes around the drawing primitives. Build with
+ * -DGFX_PROFILE and provide gfx_profile_record() in the application; without
+ * the flag GFX_PROFILE_SCOPE() expands to nothing.
+ */
+#if defined(GFX_PROFILE)
+
+#if defined(ESP32)
+#include "esp_cpu.h"
+#endif
+
+typedef enum
+{
+  GFX_PROBE_FILL_SCREEN,
+  GFX_PROBE_FILL_RECT,
+  GFX_PROBE_DRAW_RECT,
+  GFX_PROBE_FAST_HLINE,
+  GFX_PROBE_FAST_VLINE,
+  GFX_PROBE_FILL_RING,
+  GFX_PROBE_FILL_ARC,
+  GFX_PROBE_BITMAP16,
+  GFX_PROBE_TEXT_WRITE,
+  GFX_PROBE_TEXT_BOUNDS,
+  GFX_PROBE_CANVAS_FLUSH,
+  GFX_PROBE_COUNT
+} gfx_probe_t;
+
+/// Elapsed cycles of one probed call, implemented by the application
+void gfx_profile_record(uint8_t probe, uint32_t cycles);
+
+static inline uint32_t gfx_profile_cycles()
+{
+#if defined(ESP32)
+  return esp_cpu_get_cycle_count();
+#else
+  return micros();
+#endif
+}
+
+/// Measures its own lifetime; nested probes each count their full time
+class Arduino_GFX_ProfileScope
+{
+public:
+  Arduino_GFX_ProfileScope(uint8_t probe) : _probe(probe), _start(gfx_profile_cycles()) {}
+  ~Arduino_GFX_ProfileScope() { gfx_profile_record(_probe, gfx_profile_cycles() - _start); }
+
+private:
+  uint8_t _probe;
+  uint32_t _start;
+};
+
+#define GFX_PROFILE_SCOPE(probe) Arduino_GFX_ProfileScope _gfx_profile_scope(probe)
+
+#else // !defined(GFX_PROFILE)
+
+#define GFX_PROFILE_SCOPE(probe)
+
+#endif // defined(GFX_PROFILE)
+
+#endif // _ARDUINO_GFX_PROFILE_H_
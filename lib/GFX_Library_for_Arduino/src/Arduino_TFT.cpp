@@ -649,6 +649,34 @@ void Arduino_TFT::draw16bitRGBBitmap(
   }
 }
 
+void Arduino_TFT::draw16bitRGBBitmap(
+    int16_t x, int16_t y,
+    uint16_t *bitmap, int16_t w, int16_t h, int16_t x_skip)
+{
+  if (
+      (x_skip == 0) ||
+      _isRoundMode ||
+      (x < 0) ||                // Clip left
+      (y < 0) ||                // Clip top
+      ((x + w - 1) > _max_x) || // Clip right
+      ((y + h - 1) > _max_y)    // Clip bottom
+  )
+  {
+    Arduino_G::draw16bitRGBBitmap(x, y, bitmap, w, h, x_skip);
+  }
+  else
+  {
+    startWrite();
+    writeAddrWindow(x, y, w, h);
+    while (h--)
+    {
+      _bus->writePixels(bitmap, w);
+      bitmap += w + x_skip;
+    }
+    endWrite();
+  }
+}
+
 void Arduino_TFT::draw16bitBeRGBBitmap(
     int16_t x, int16_t y,
     uint16_t *bitmap, int16_t w, int16_t h)
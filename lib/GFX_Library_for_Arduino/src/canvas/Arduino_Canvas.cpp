@@ -45,12 +45,14 @@ bool Arduino_Canvas::begin(int32_t speed)
       return false;
     }
   }
+  _dirty_region.addAll(WIDTH, HEIGHT);
 
   return true;
 }
 
 void Arduino_Canvas::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
+  _dirty_region.addRotated(x, y, 1, 1, _rotation, WIDTH, HEIGHT);
 
   uint16_t *fb = _framebuffer;
   switch (_rotation)
@@ -123,6 +125,7 @@ void Arduino_Canvas::writeFastVLineCore(int16_t x, int16_t y,
           h = MAX_Y - y + 1;
         } // Clip bottom
 
+        _dirty_region.add(x, y, 1, h);
         uint16_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
         while (h--)
         {
@@ -181,6 +184,7 @@ void Arduino_Canvas::writeFastHLineCore(int16_t x, int16_t y,
           w = MAX_X - x + 1;
         } // Clip right
 
+        _dirty_region.add(x, y, w, 1);
         uint16_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
         while (w--)
         {
@@ -221,6 +225,7 @@ void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y,
     }
   }
   // log_i("adjusted writeFillRectPreclipped(x: %d, y: %d, w: %d, h: %d)", x, y, w, h);
+  _dirty_region.add(x, y, w, h);
   uint16_t *row = _framebuffer;
   row += y * WIDTH;
   row += x;
@@ -277,6 +282,7 @@ void Arduino_Canvas::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -350,6 +356,7 @@ void Arduino_Canvas::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -409,6 +416,7 @@ void Arduino_Canvas::drawIndexedBitmap(
 void Arduino_Canvas::draw16bitRGBBitmap(int16_t x, int16_t y,
                                         uint16_t *bitmap, int16_t w, int16_t h)
 {
+  _dirty_region.addRotated(x, y, w, h, _rotation, WIDTH, HEIGHT);
   switch (_rotation)
   {
   case 1:
@@ -469,6 +477,7 @@ void Arduino_Canvas::draw16bitRGBBitmapWithTranColor(
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -556,6 +565,7 @@ void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -574,12 +584,112 @@ void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
   }
 }
 
+/*!
+    @brief  Send the framebuffer to the output. Only the rectangles written
+            since the last flush are transmitted, each as one address window,
+            less their unchanged rows if setRowHashDiff() is on. Code that
+            writes through getFramebuffer() should pass force_flush.
+    @param  force_flush  send the whole framebuffer
+*/
 void Arduino_Canvas::flush(bool force_flush)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_CANVAS_FLUSH);
   if (_output)
   {
-    _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, WIDTH, HEIGHT);
+    if (force_flush)
+    {
+      _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, WIDTH, HEIGHT);
+      if (_row_hash.isEnabled())
+      {
+        for (int16_t y = 0; y < HEIGHT; y++)
+        {
+          _row_hash.check(y, Arduino_RowHash::hash16(_framebuffer + ((int32_t)y * WIDTH), WIDTH));
+        }
+        _row_hash.clearChecked();
+      }
+    }
+    else if (_row_hash.isEnabled())
+    {
+      flushChangedRows();
+    }
+    else if (_dirty_region.isFull())
+    {
+      _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, WIDTH, HEIGHT);
+    }
+    else
+    {
+      for (uint8_t i = 0; i < _dirty_region.count(); i++)
+      {
+        const Arduino_DirtyRegion::Rect *r = _dirty_region.rect(i);
+        int16_t w = r->x2 - r->x1 + 1;
+        int16_t h = r->y2 - r->y1 + 1;
+        _output->draw16bitRGBBitmap(_output_x + r->x1, _output_y + r->y1,
+                                    _framebuffer + ((int32_t)r->y1 * WIDTH) + r->x1, w, h, WIDTH - w);
+      }
+    }
+  }
+  _dirty_region.clear();
+}
+
+/*!
+    @brief  Keep a hash of every framebuffer row sent to the output, so that
+            flush() skips the rows of its dirty rectangles that were redrawn
+            with identical content. Costs 5 bytes per row and one multiply
+            per pixel hashed. If the table cannot be allocated flush() keeps
+            sending whole rectangles.
+    @param  isEnable  false frees the hash table
+*/
+void Arduino_Canvas::setRowHashDiff(bool isEnable)
+{
+  if (isEnable)
+  {
+    _row_hash.begin(HEIGHT);
+  }
+  else
+  {
+    _row_hash.end();
+  }
+}
+
+/*!
+    @brief  Send the dirty rectangles minus their rows whose hash matches what
+            the output already shows. Each row is hashed once per flush, and
+            consecutive changed rows of a rectangle go out as one window.
+*/
+void Arduino_Canvas::flushChangedRows()
+{
+  for (uint8_t i = 0; i < _dirty_region.count(); i++)
+  {
+    const Arduino_DirtyRegion::Rect *r = _dirty_region.rect(i);
+    int16_t w = r->x2 - r->x1 + 1;
+    int16_t run_y = -1;
+    for (int16_t y = r->y1; y <= (r->y2 + 1); y++)
+    {
+      bool changed = false;
+      if (y <= r->y2)
+      {
+        if (!_row_hash.isChecked(y))
+        {
+          _row_hash.check(y, Arduino_RowHash::hash16(_framebuffer + ((int32_t)y * WIDTH), WIDTH));
+        }
+        changed = _row_hash.isChanged(y);
+      }
+      if (changed)
+      {
+        if (run_y < 0)
+        {
+          run_y = y;
+        }
+      }
+      else if (run_y >= 0)
+      {
+        _output->draw16bitRGBBitmap(_output_x + r->x1, _output_y + run_y,
+                                      _framebuffer + ((int32_t)run_y * WIDTH) + r->x1, w, y - run_y, WIDTH - w);
+        run_y = -1;
+      }
+    }
   }
+  _row_hash.clearChecked();
 }
 
 void Arduino_Canvas::flushQuad(bool force_flush)
@@ -5,6 +5,8 @@
 #define _ARDUINO_CANVAS_H_
 
 #include "../Arduino_GFX.h"
+#include "Arduino_DirtyRegion.h"
+#include "Arduino_RowHash.h"
 
 class Arduino_Canvas : public Arduino_GFX
 {
@@ -25,6 +27,7 @@ public:
   void draw16bitRGBBitmapWithTranColor(int16_t x, int16_t y, uint16_t *bitmap, uint16_t transparent_color, int16_t w, int16_t h) override;
   void draw16bitBeRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void flush(bool force_flush = false) override;
+  void setRowHashDiff(bool isEnable);
   void flushQuad(bool force_flush = false);
 
   uint16_t *getFramebuffer();
@@ -35,6 +38,13 @@ protected:
   int16_t _output_x, _output_y;
   int16_t MAX_X, MAX_Y;
 
+  // raw framebuffer areas written since the last flush()
+  Arduino_DirtyRegion _dirty_region;
+
+  // hashes of the rows last sent, see setRowHashDiff()
+  Arduino_RowHash _row_hash;
+  void flushChangedRows();
+
   // for flushQuad() only
   uint16_t *_rowBuf = nullptr;
 
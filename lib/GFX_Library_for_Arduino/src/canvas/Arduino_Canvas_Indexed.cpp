@@ -57,11 +57,12 @@ bool Arduino_Canvas_Indexed::begin(int32_t speed)
       return false;
     }
   }
+  _dirty_region.addAll(WIDTH, HEIGHT);
 
   return true;
 }
 
-void Arduino_Canvas_Indexed::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
+void GFX_IRAM_ATTR Arduino_Canvas_Indexed::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
   uint8_t idx;
   if (_isDirectUseColorIndex)
@@ -73,6 +74,7 @@ void Arduino_Canvas_Indexed::writePixelPreclipped(int16_t x, int16_t y, uint16_t
     idx = get_color_index(color);
   }
 
+  _dirty_region.addRotated(x, y, 1, 1, _rotation, WIDTH, HEIGHT);
   uint8_t *fb = _framebuffer;
   switch (_rotation)
   {
@@ -127,8 +129,8 @@ void Arduino_Canvas_Indexed::writeFastVLine(int16_t x, int16_t y,
   }
 }
 
-void Arduino_Canvas_Indexed::writeFastVLineCore(int16_t x, int16_t y,
-                                                int16_t h, uint8_t idx)
+void GFX_IRAM_ATTR Arduino_Canvas_Indexed::writeFastVLineCore(int16_t x, int16_t y,
+                                                              int16_t h, uint8_t idx)
 {
   if (_ordered_in_range(x, 0, MAX_X) && h)
   { // X on screen, nonzero height
@@ -153,6 +155,7 @@ void Arduino_Canvas_Indexed::writeFastVLineCore(int16_t x, int16_t y,
           h = MAX_Y - y + 1;
         } // Clip bottom
 
+        _dirty_region.add(x, y, 1, h);
         uint8_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
         while (h--)
         {
@@ -193,8 +196,8 @@ void Arduino_Canvas_Indexed::writeFastHLine(int16_t x, int16_t y,
   }
 }
 
-void Arduino_Canvas_Indexed::writeFastHLineCore(int16_t x, int16_t y,
-                                                int16_t w, uint8_t idx)
+void GFX_IRAM_ATTR Arduino_Canvas_Indexed::writeFastHLineCore(int16_t x, int16_t y,
+                                                              int16_t w, uint8_t idx)
 {
   if (_ordered_in_range(y, 0, MAX_Y) && w)
   { // Y on screen, nonzero width
@@ -219,6 +222,7 @@ void Arduino_Canvas_Indexed::writeFastHLineCore(int16_t x, int16_t y,
           w = MAX_X - x + 1;
         } // Clip right
 
+        _dirty_region.add(x, y, w, 1);
         uint8_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
         while (w--)
         {
@@ -229,9 +233,16 @@ void Arduino_Canvas_Indexed::writeFastHLineCore(int16_t x, int16_t y,
   }
 }
 
-void Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
-                                                     int16_t w, int16_t h, uint16_t color)
+void GFX_IRAM_ATTR Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
+                                                                   int16_t w, int16_t h, uint16_t color)
 {
+  // A full-screen fill overwrites every pixel, so all unreserved color
+  // indexes are free again; keeps the table from filling up over time
+  if ((x == 0) && (y == 0) && (w == _width) && (h == _height))
+  {
+    _indexed_size = _slot_count;
+  }
+
   uint8_t idx;
   if (_isDirectUseColorIndex)
   {
@@ -268,6 +279,7 @@ void Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
     }
   }
   // log_i("adjusted writeFillRectPreclipped(x: %d, y: %d, w: %d, h: %d)", x, y, w, h);
+  _dirty_region.add(x, y, w, h);
   uint8_t *row = _framebuffer;
   row += y * WIDTH;
   row += x;
@@ -339,6 +351,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint8_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -444,6 +457,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      _dirty_region.add(x, y, w, h);
       uint8_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -484,12 +498,192 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
   }
 }
 
+/*!
+    @brief  Send the framebuffer to the output. Only the rectangles written
+            since the last flush are transmitted, each as one address window,
+            less their unchanged rows if setRowHashDiff() is on, followed by
+            pixels recolored through setIndexColor(). Code that writes
+            through getFramebuffer() should pass force_flush.
+    @param  force_flush  send the whole framebuffer
+*/
 void Arduino_Canvas_Indexed::flush(bool force_flush)
 {
+  GFX_PROFILE_SCOPE(GFX_PROBE_CANVAS_FLUSH);
   if (_output)
   {
-    _output->drawIndexedBitmap(_output_x, _output_y, _framebuffer, _color_index, WIDTH, HEIGHT);
+    if (force_flush)
+    {
+      _output->drawIndexedBitmap(_output_x, _output_y, _framebuffer, _color_index, WIDTH, HEIGHT);
+      memset(_index_changed, 0, sizeof(_index_changed));
+      if (_row_hash.isEnabled())
+      {
+        for (int16_t y = 0; y < HEIGHT; y++)
+        {
+          _row_hash.check(y, Arduino_RowHash::hashIndexed(_framebuffer + ((int32_t)y * WIDTH), _color_index, WIDTH));
+        }
+        _row_hash.clearChecked();
+      }
+    }
+    else if (_row_hash.isEnabled())
+    {
+      flushChangedRows();
+      flushIndexChanges();
+    }
+    else if (_dirty_region.isFull())
+    {
+      _output->drawIndexedBitmap(_output_x, _output_y, _framebuffer, _color_index, WIDTH, HEIGHT);
+      memset(_index_changed, 0, sizeof(_index_changed));
+    }
+    else
+    {
+      for (uint8_t i = 0; i < _dirty_region.count(); i++)
+      {
+        const Arduino_DirtyRegion::Rect *r = _dirty_region.rect(i);
+        int16_t w = r->x2 - r->x1 + 1;
+        int16_t h = r->y2 - r->y1 + 1;
+        _output->drawIndexedBitmap(_output_x + r->x1, _output_y + r->y1,
+                                   _framebuffer + ((int32_t)r->y1 * WIDTH) + r->x1, _color_index, w, h, WIDTH - w);
+      }
+      flushIndexChanges();
+    }
   }
+  _dirty_region.clear();
+}
+
+/*!
+    @brief  Keep a hash of every framebuffer row sent to the output, so that
+            flush() skips the rows of its dirty rectangles that were redrawn
+            with identical content. Costs 5 bytes per row and one multiply
+            per pixel hashed. If the table cannot be allocated flush() keeps
+            sending whole rectangles.
+    @param  isEnable  false frees the hash table
+*/
+void Arduino_Canvas_Indexed::setRowHashDiff(bool isEnable)
+{
+  if (isEnable)
+  {
+    _row_hash.begin(HEIGHT);
+  }
+  else
+  {
+    _row_hash.end();
+  }
+}
+
+/*!
+    @brief  Send the dirty rectangles minus their rows whose hash matches what
+            the output already shows. Each row is hashed once per flush, and
+            consecutive changed rows of a rectangle go out as one window.
+*/
+void Arduino_Canvas_Indexed::flushChangedRows()
+{
+  for (uint8_t i = 0; i < _dirty_region.count(); i++)
+  {
+    const Arduino_DirtyRegion::Rect *r = _dirty_region.rect(i);
+    int16_t w = r->x2 - r->x1 + 1;
+    int16_t run_y = -1;
+    for (int16_t y = r->y1; y <= (r->y2 + 1); y++)
+    {
+      bool changed = false;
+      if (y <= r->y2)
+      {
+        if (!_row_hash.isChecked(y))
+        {
+          _row_hash.check(y, Arduino_RowHash::hashIndexed(_framebuffer + ((int32_t)y * WIDTH), _color_index, WIDTH));
+        }
+        changed = _row_hash.isChanged(y);
+      }
+      if (changed)
+      {
+        if (run_y < 0)
+        {
+          run_y = y;
+        }
+      }
+      else if (run_y >= 0)
+      {
+        _output->drawIndexedBitmap(_output_x + r->x1, _output_y + run_y,
+                                     _framebuffer + ((int32_t)run_y * WIDTH) + r->x1, _color_index, w, y - run_y, WIDTH - w);
+        run_y = -1;
+      }
+    }
+  }
+  _row_hash.clearChecked();
+}
+
+/*!
+    @brief  Send only the pixels whose color index was recolored by
+            setIndexColor() since the last flush. Each framebuffer row is
+            trimmed to the span holding such pixels and consecutive rows
+            with the same span go out as one window, expanded through the
+            bus writeIndexedPixels(). Other pending drawing is not sent;
+            flush() calls this after sending the dirty rectangles.
+*/
+void Arduino_Canvas_Indexed::flushIndexChanges()
+{
+  uint8_t changed[COLOR_IDX_SIZE];
+  bool any = false;
+  for (int16_t i = 0; i < COLOR_IDX_SIZE; i++)
+  {
+    changed[i] = (_index_changed[i >> 5] >> (i & 31)) & 1;
+    any |= changed[i];
+  }
+  if ((!_output) || (!any))
+  {
+    return;
+  }
+  memset(_index_changed, 0, sizeof(_index_changed));
+
+  uint8_t *row = _framebuffer;
+  uint8_t *run_start = nullptr;
+  int16_t run_y = 0, run_x1 = 0, run_x2 = -1, run_h = 0;
+  for (int16_t y = 0; y <= HEIGHT; y++)
+  {
+    int16_t x1 = WIDTH, x2 = -1;
+    if (y < HEIGHT)
+    {
+      x1 = 0;
+      while ((x1 < WIDTH) && (!changed[row[x1]]))
+      {
+        x1++;
+      }
+      if (x1 < WIDTH)
+      {
+        x2 = WIDTH - 1;
+        while (!changed[row[x2]])
+        {
+          x2--;
+        }
+      }
+    }
+    if (run_h && ((x1 != run_x1) || (x2 != run_x2)))
+    {
+      int16_t w = run_x2 - run_x1 + 1;
+      _output->drawIndexedBitmap(_output_x + run_x1, _output_y + run_y, run_start, _color_index, w, run_h, WIDTH - w);
+      run_h = 0;
+    }
+    if (x2 >= 0)
+    {
+      if (_row_hash.isEnabled())
+      {
+        _row_hash.invalidateRow(y);
+      }
+      if (!run_h)
+      {
+        run_start = row + x1;
+        run_y = y;
+        run_x1 = x1;
+        run_x2 = x2;
+      }
+      run_h++;
+    }
+    row += WIDTH;
+  }
+}
+
+bool Arduino_Canvas_Indexed::isDirty()
+{
+  return !_dirty_region.isEmpty();
 }
 
 uint8_t *Arduino_Canvas_Indexed::getFramebuffer()
@@ -507,10 +701,18 @@ void Arduino_Canvas_Indexed::setDirectUseColorIndex(bool isEnable)
   _isDirectUseColorIndex = isEnable;
 }
 
-uint8_t Arduino_Canvas_Indexed::get_color_index(uint16_t color)
+/*!
+    @brief  Index for a color, adding it to the table if it is new. Reserved
+            slots are never matched, even when they hold the same color:
+            they are only drawn by index (setDirectUseColorIndex()), so a
+            later setIndexColor() recolors nothing else.
+    @param  color RGB565 color
+    @return index of the color
+*/
+uint8_t GFX_IRAM_ATTR Arduino_Canvas_Indexed::get_color_index(uint16_t color)
 {
   color &= _color_mask;
-  for (uint8_t i = 0; i < _indexed_size; i++)
+  for (uint8_t i = _slot_count; i < _indexed_size; i++)
   {
     if (_color_index[i] == color)
     {
@@ -534,6 +736,49 @@ GFX_INLINE uint16_t Arduino_Canvas_Indexed::get_index_color(uint8_t idx)
   return _color_index[idx];
 }
 
+/*!
+    @brief  Give a color its own index. Slots live below all other indexes
+            and get_color_index() never returns them, so only pixels drawn
+            with the slot index itself, in setDirectUseColorIndex() mode,
+            follow later setIndexColor() calls. Reserve slots before
+            drawing; once other colors are indexed this falls back to a
+            plain get_color_index().
+    @param  color RGB565 color the slot starts with
+    @return index of the slot
+*/
+uint8_t Arduino_Canvas_Indexed::reserveColorSlot(uint16_t color)
+{
+  if ((_indexed_size != _slot_count) || (_slot_count >= (COLOR_IDX_SIZE - 1)))
+  {
+    return get_color_index(color);
+  }
+  _color_index[_slot_count] = color & _color_mask;
+  _indexed_size = ++_slot_count;
+  return _slot_count - 1;
+}
+
+/*!
+    @brief  Change the color an index expands to, without touching the
+            framebuffer. The change reaches the panel on the next flush() or
+            flushIndexChanges().
+    @param  idx   color index, typically from reserveColorSlot()
+    @param  color new RGB565 color
+*/
+void Arduino_Canvas_Indexed::setIndexColor(uint8_t idx, uint16_t color)
+{
+  color &= _color_mask;
+  if (_color_index[idx] != color)
+  {
+    _color_index[idx] = color;
+    _index_changed[idx >> 5] |= (uint32_t)1 << (idx & 31);
+  }
+}
+
+/*!
+    @brief  Coarsen every color to the next mask level and renumber the
+            framebuffer to the merged table. Colors on the panel change with
+            it, so the whole framebuffer is marked dirty for the next flush().
+*/
 void Arduino_Canvas_Indexed::raise_mask_level()
 {
   if ((_current_mask_level + 1) < MAXMASKLEVEL)
@@ -541,13 +786,19 @@ void Arduino_Canvas_Indexed::raise_mask_level()
     int32_t buffer_size = _width * _height;
     uint8_t old_indexed_size = _indexed_size;
     uint8_t new_color;
-    _indexed_size = 0;
+    _indexed_size = _slot_count;
     _color_mask = mask_level_list[++_current_mask_level];
     // print("Raised mask level: ");
     // println(_current_mask_level);
 
+    // reserved slots keep their index, only their color is coarsened
+    for (uint8_t slot = 0; slot < _slot_count; slot++)
+    {
+      _color_index[slot] &= _color_mask;
+    }
+
     // update _framebuffer color index, it is a time consuming job
-    for (uint8_t old_color = 0; old_color < old_indexed_size; old_color++)
+    for (uint8_t old_color = _slot_count; old_color < old_indexed_size; old_color++)
     {
       new_color = get_color_index(_color_index[old_color]);
       for (int32_t i = 0; i < buffer_size; i++)
@@ -558,6 +809,11 @@ void Arduino_Canvas_Indexed::raise_mask_level()
         }
       }
     }
+
+    // every pixel may now expand to another color; a full flush also
+    // covers the coarsened slots, so their change bits are not needed
+    _dirty_region.addAll(WIDTH, HEIGHT);
+    memset(_index_changed, 0, sizeof(_index_changed));
   }
 }
 
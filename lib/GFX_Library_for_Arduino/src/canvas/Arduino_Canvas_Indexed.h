@@ -5,6 +5,8 @@
 #define _ARDUINO_CANVAS_INDEXED_H_
 
 #include "../Arduino_GFX.h"
+#include "Arduino_DirtyRegion.h"
+#include "Arduino_RowHash.h"
 
 #define COLOR_IDX_SIZE 256
 
@@ -24,6 +26,9 @@ public:
   void drawIndexedBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip = 0) override;
   void drawIndexedBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint16_t *color_index, uint8_t chroma_key, int16_t w, int16_t h, int16_t x_skip = 0) override;
   void flush(bool force_flush = false) override;
+  void setRowHashDiff(bool isEnable);
+  void flushIndexChanges();
+  bool isDirty();
 
   uint8_t *getFramebuffer();
   uint16_t *getColorIndex();
@@ -33,6 +38,9 @@ public:
   uint16_t get_index_color(uint8_t idx);
   void raise_mask_level();
 
+  uint8_t reserveColorSlot(uint16_t color);
+  void setIndexColor(uint8_t idx, uint16_t color);
+
 protected:
   uint8_t *_framebuffer = nullptr;
   Arduino_G *_output = nullptr;
@@ -41,8 +49,17 @@ protected:
 
   uint16_t _color_index[COLOR_IDX_SIZE];
   uint8_t _indexed_size = 0;
+  uint8_t _slot_count = 0;
+  uint32_t _index_changed[COLOR_IDX_SIZE / 32] = {0};
   bool _isDirectUseColorIndex = false;
 
+  // raw framebuffer areas written since the last flush()
+  Arduino_DirtyRegion _dirty_region;
+
+  // hashes of the rows last sent, see setRowHashDiff()
+  Arduino_RowHash _row_hash;
+  void flushChangedRows();
+
   uint8_t _current_mask_level;
   uint16_t _color_mask;
 #define MAXMASKLEVEL 3
@@ -0,0 +1,183 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#include "Arduino_DirtyRegion.h"
+
+/*!
+    @brief  Record a clipped rectangle as modified. Rectangles are merged
+            whenever sending the union costs no more than sending both plus
+            one address window setup; when the list is full the pair that
+            grows the least is merged instead.
+    @param  x  left edge
+    @param  y  top edge
+    @param  w  width, > 0
+    @param  h  height, > 0
+*/
+void Arduino_DirtyRegion::add(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_full || (w <= 0) || (h <= 0))
+  {
+    return;
+  }
+
+  Rect n = {x, y, (int16_t)(x + w - 1), (int16_t)(y + h - 1)};
+
+  // Fast path for repeated writes (pixels of a glyph, rows of a fill)
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Rect &r = _rects[i];
+    if ((n.x1 >= r.x1) && (n.x2 <= r.x2) && (n.y1 >= r.y1) && (n.y2 <= r.y2))
+    {
+      return;
+    }
+  }
+
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+      Rect u = unite(n, _rects[i]);
+      if (area(u) <= (area(n) + area(_rects[i]) + GFX_DIRTY_RECT_WINDOW_COST))
+      {
+        n = u;
+        remove(i);
+        merged = true;
+        break;
+      }
+    }
+  }
+
+  while (_count >= GFX_DIRTY_RECT_MAX)
+  {
+    uint8_t best = 0;
+    int32_t best_growth = INT32_MAX;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+      int32_t growth = area(unite(n, _rects[i])) - area(n) - area(_rects[i]);
+      if (growth < best_growth)
+      {
+        best_growth = growth;
+        best = i;
+      }
+    }
+    n = unite(n, _rects[best]);
+    remove(best);
+  }
+
+  _rects[_count++] = n;
+}
+
+/*!
+    @brief  Record a rectangle given in rotated (drawing) coordinates. It is
+            clipped to the screen and mapped to raw framebuffer coordinates
+            the same way the canvases store pixels.
+    @param  x         left edge
+    @param  y         top edge
+    @param  w         width
+    @param  h         height
+    @param  rotation  canvas rotation, 0-3
+    @param  raw_w     unrotated framebuffer width
+    @param  raw_h     unrotated framebuffer height
+*/
+void Arduino_DirtyRegion::addRotated(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t rotation, int16_t raw_w, int16_t raw_h)
+{
+  int16_t lw = (rotation & 1) ? raw_h : raw_w;
+  int16_t lh = (rotation & 1) ? raw_w : raw_h;
+  if (x < 0)
+  {
+    w += x;
+    x = 0;
+  }
+  if (y < 0)
+  {
+    h += y;
+    y = 0;
+  }
+  if ((x + w) > lw)
+  {
+    w = lw - x;
+  }
+  if ((y + h) > lh)
+  {
+    h = lh - y;
+  }
+  if ((w <= 0) || (h <= 0))
+  {
+    return;
+  }
+
+  switch (rotation)
+  {
+  case 1:
+    add(raw_w - y - h, x, h, w);
+    break;
+  case 2:
+    add(raw_w - x - w, raw_h - y - h, w, h);
+    break;
+  case 3:
+    add(y, raw_h - x - w, h, w);
+    break;
+  default: // case 0:
+    add(x, y, w, h);
+  }
+}
+
+/*!
+    @brief  Mark the whole w x h framebuffer as modified
+*/
+void Arduino_DirtyRegion::addAll(int16_t w, int16_t h)
+{
+  _rects[0] = {0, 0, (int16_t)(w - 1), (int16_t)(h - 1)};
+  _count = 1;
+  _full = true;
+}
+
+void Arduino_DirtyRegion::clear()
+{
+  _count = 0;
+  _full = false;
+}
+
+bool Arduino_DirtyRegion::isEmpty()
+{
+  return _count == 0;
+}
+
+bool Arduino_DirtyRegion::isFull()
+{
+  return _full;
+}
+
+uint8_t Arduino_DirtyRegion::count()
+{
+  return _count;
+}
+
+const Arduino_DirtyRegion::Rect *Arduino_DirtyRegion::rect(uint8_t i)
+{
+  return &_rects[i];
+}
+
+int32_t Arduino_DirtyRegion::area(const Rect &r)
+{
+  return (int32_t)(r.x2 - r.x1 + 1) * (r.y2 - r.y1 + 1);
+}
+
+Arduino_DirtyRegion::Rect Arduino_DirtyRegion::unite(const Rect &a, const Rect &b)
+{
+  Rect u;
+  u.x1 = (a.x1 < b.x1) ? a.x1 : b.x1;
+  u.y1 = (a.y1 < b.y1) ? a.y1 : b.y1;
+  u.x2 = (a.x2 > b.x2) ? a.x2 : b.x2;
+  u.y2 = (a.y2 > b.y2) ? a.y2 : b.y2;
+  return u;
+}
+
+void Arduino_DirtyRegion::remove(uint8_t i)
+{
+  _rects[i] = _rects[--_count];
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,47 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#ifndef _ARDUINO_DIRTYREGION_H_
+#define _ARDUINO_DIRTYREGION_H_
+
+#ifndef GFX_DIRTY_RECT_MAX
+#define GFX_DIRTY_RECT_MAX 8 // rectangles tracked before forced merging
+#endif
+
+#ifndef GFX_DIRTY_RECT_WINDOW_COST
+#define GFX_DIRTY_RECT_WINDOW_COST 64 // address window setup, in pixel equivalents
+#endif
+
+/// Bounded list of framebuffer rectangles touched since the last flush, in raw (unrotated) coordinates
+class Arduino_DirtyRegion
+{
+public:
+  typedef struct
+  {
+    int16_t x1, y1, x2, y2; // inclusive
+  } Rect;
+
+  void add(int16_t x, int16_t y, int16_t w, int16_t h);
+  void addRotated(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t rotation, int16_t raw_w, int16_t raw_h);
+  void addAll(int16_t w, int16_t h);
+  void clear();
+
+  bool isEmpty();
+  bool isFull();
+  uint8_t count();
+  const Rect *rect(uint8_t i);
+
+protected:
+  Rect _rects[GFX_DIRTY_RECT_MAX];
+  uint8_t _count = 0;
+  bool _full = false;
+
+private:
+  static int32_t area(const Rect &r);
+  static Rect unite(const Rect &a, const Rect &b);
+  void remove(uint8_t i);
+};
+
+#endif // _ARDUINO_DIRTYREGION_H_
+
+#endif // !defined(LITTLE_FOOT_PRINT)
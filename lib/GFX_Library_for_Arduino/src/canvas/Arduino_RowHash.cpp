@@ -0,0 +1,143 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#include "Arduino_RowHash.h"
+
+#define ROWHASH_KNOWN 0x01   // _hashes[row] matches the panel
+#define ROWHASH_CHECKED 0x02 // hashed during the current flush
+#define ROWHASH_CHANGED 0x04 // differed from the panel when hashed
+
+#define ROWHASH_SEED 0x811C9DC5
+#define ROWHASH_PRIME 0x01000193
+
+Arduino_RowHash::~Arduino_RowHash()
+{
+  end();
+}
+
+/*!
+    @brief  Allocate the hash table, every row starts out unknown
+    @param  rows  framebuffer height
+    @return false if out of memory
+*/
+bool Arduino_RowHash::begin(int16_t rows)
+{
+  if (_hashes && (_rows == rows))
+  {
+    invalidate();
+    return true;
+  }
+  end();
+  _hashes = (uint32_t *)malloc(rows * sizeof(uint32_t));
+  _state = (uint8_t *)malloc(rows);
+  if ((!_hashes) || (!_state))
+  {
+    end();
+    return false;
+  }
+  _rows = rows;
+  invalidate();
+  return true;
+}
+
+void Arduino_RowHash::end()
+{
+  if (_hashes)
+  {
+    free(_hashes);
+    _hashes = nullptr;
+  }
+  if (_state)
+  {
+    free(_state);
+    _state = nullptr;
+  }
+  _rows = 0;
+}
+
+bool Arduino_RowHash::isEnabled()
+{
+  return _hashes != nullptr;
+}
+
+/*!
+    @brief  Forget every stored hash, so the next flush sends all rows it covers
+*/
+void Arduino_RowHash::invalidate()
+{
+  memset(_state, 0, _rows);
+}
+
+void Arduino_RowHash::invalidateRow(int16_t row)
+{
+  _state[row] &= ~ROWHASH_KNOWN;
+}
+
+/*!
+    @brief  Compare a row against what the output holds and remember the new
+            hash. The caller sends the row if this returns true.
+    @param  row   framebuffer row
+    @param  hash  hash16() or hashIndexed() of the current row content
+    @return true if the row differs (or was never sent)
+*/
+bool Arduino_RowHash::check(int16_t row, uint32_t hash)
+{
+  bool changed = (!(_state[row] & ROWHASH_KNOWN)) || (_hashes[row] != hash);
+  _hashes[row] = hash;
+  _state[row] = ROWHASH_KNOWN | ROWHASH_CHECKED | (changed ? ROWHASH_CHANGED : 0);
+  return changed;
+}
+
+bool Arduino_RowHash::isChecked(int16_t row)
+{
+  return _state[row] & ROWHASH_CHECKED;
+}
+
+/*!
+    @brief  Result of the last check() of this row in the current flush
+*/
+bool Arduino_RowHash::isChanged(int16_t row)
+{
+  return _state[row] & ROWHASH_CHANGED;
+}
+
+/*!
+    @brief  End the current flush, rows have to be hashed again next time
+*/
+void Arduino_RowHash::clearChecked()
+{
+  for (int16_t i = 0; i < _rows; i++)
+  {
+    _state[i] &= ROWHASH_KNOWN;
+  }
+}
+
+/*!
+    @brief  FNV-1a over 16-bit pixels, one xor and one multiply per pixel
+*/
+uint32_t Arduino_RowHash::hash16(const uint16_t *p, int16_t len)
+{
+  uint32_t h = ROWHASH_SEED;
+  while (len--)
+  {
+    h = (h ^ *p++) * ROWHASH_PRIME;
+  }
+  return h;
+}
+
+/*!
+    @brief  hash16() of the colors an indexed row expands to, so a changed
+            palette entry or a renumbered index is seen the same as the
+            output sees it
+*/
+uint32_t Arduino_RowHash::hashIndexed(const uint8_t *p, const uint16_t *color_index, int16_t len)
+{
+  uint32_t h = ROWHASH_SEED;
+  while (len--)
+  {
+    h = (h ^ color_index[*p++]) * ROWHASH_PRIME;
+  }
+  return h;
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
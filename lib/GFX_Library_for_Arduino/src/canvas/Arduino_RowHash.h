@@ -0,0 +1,37 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#ifndef _ARDUINO_ROWHASH_H_
+#define _ARDUINO_ROWHASH_H_
+
+/// 32-bit hash per framebuffer row of what was last sent to the output, so a flush can skip rows that were redrawn identical
+class Arduino_RowHash
+{
+public:
+  ~Arduino_RowHash();
+
+  bool begin(int16_t rows);
+  void end();
+  bool isEnabled();
+
+  void invalidate();
+  void invalidateRow(int16_t row);
+  bool check(int16_t row, uint32_t hash);
+  bool isChecked(int16_t row);
+  bool isChanged(int16_t row);
+  void clearChecked();
+
+  static uint32_t hash16(const uint16_t *p, int16_t len);
+  static uint32_t hashIndexed(const uint8_t *p, const uint16_t *color_index, int16_t len);
+
+protected:
+  uint32_t *_hashes = nullptr;
+  uint8_t *_state = nullptr;
+  int16_t _rows = 0;
+
+private:
+};
+
+#endif // _ARDUINO_ROWHASH_H_
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -286,7 +286,7 @@ void Arduino_HWSPI::write16(uint16_t d)
 #endif // !defined(LITTLE_FOOT_PRINT)
 }
 
-void Arduino_HWSPI::writeRepeat(uint16_t p, uint32_t len)
+void GFX_IRAM_ATTR Arduino_HWSPI::writeRepeat(uint16_t p, uint32_t len)
 {
 #if defined(LITTLE_FOOT_PRINT)
   _data16.value = p;
@@ -342,7 +342,7 @@ void Arduino_HWSPI::writeBytes(uint8_t *data, uint32_t len)
 #endif // !defined(LITTLE_FOOT_PRINT)
 }
 
-void Arduino_HWSPI::writePixels(uint16_t *data, uint32_t len)
+void GFX_IRAM_ATTR Arduino_HWSPI::writePixels(uint16_t *data, uint32_t len)
 {
 #if defined(LITTLE_FOOT_PRINT)
   while (len--)
@@ -0,0 +1,105 @@
+// Fixed-point math implementation
+
+#include "fixed_math.h"
+
+// Q15 sine of one quadrant in 64 steps, plus the 90 degree guard entry
+static const int16_t sinQuadrantQ15[65] = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+  6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767
+};
+
+// atan(2^-i) in 1/2^24 turns (Q16 angle with 8 extra fraction bits)
+static const int32_t cordicAtanQ24[16] = {
+  2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+  10430, 5215, 2608, 1304, 652, 326, 163, 81
+};
+
+int32_t fx_sin_q15(angle_q16_t angle) {
+  uint16_t a = (uint16_t)angle;
+  uint8_t quadrant = a >> 14;
+  uint16_t idx = a & 0x3FFF;
+  if (quadrant & 1) {
+    idx = 0x4000 - idx;  // Mirror odd quadrants
+  }
+  uint16_t i = idx >> 8;
+  int32_t v = sinQuadrantQ15[i];
+  if (i < 64) {
+    v += ((sinQuadrantQ15[i + 1] - v) * (int32_t)(idx & 0xFF)) >> 8;
+  }
+  return (quadrant & 2) ? -v : v;
+}
+
+int32_t fx_cos_q15(angle_q16_t angle) {
+  return fx_sin_q15(angle + FX_ANGLE_QUARTER);
+}
+
+angle_q16_t fx_atan2(int32_t y0, int32_t x0) {
+  if (x0 == 0 && y0 == 0) return 0;
+
+  // Rotate into the right half-plane first, CORDIC converges for |angle| < 99 deg.
+  // Widened so that negating INT32_MIN does not overflow.
+  int64_t wx = x0;
+  int64_t wy = y0;
+  int32_t angle = 0;
+  if (wx < 0) {
+    wx = -wx;
+    wy = -wy;
+    angle = FX_ANGLE_HALF << 8;
+  }
+
+  // Keep headroom for the CORDIC gain (~1.65) in 32 bits, but scale small
+  // vectors up so the shifted terms keep their precision
+  while (wx > 0x1FFFFFFF || wy > 0x1FFFFFFF || wy < -0x1FFFFFFF) {
+    wx >>= 1;
+    wy >>= 1;
+  }
+  int32_t x = (int32_t)wx;
+  int32_t y = (int32_t)wy;
+  while (x < 0x10000000 && y < 0x10000000 && y > -0x10000000) {
+    x *= 2;  // Not <<: y may be negative
+    y *= 2;
+  }
+
+  // Vectoring mode: drive y to zero, accumulate the rotation
+  for (uint8_t i = 0; i < 16; i++) {
+    int32_t xs = x >> i;
+    int32_t ys = y >> i;
+    if (y > 0) {
+      x += ys;
+      y -= xs;
+      angle += cordicAtanQ24[i];
+    } else {
+      x -= ys;
+      y += xs;
+      angle -= cordicAtanQ24[i];
+    }
+  }
+
+  return (angle_q16_t)(((angle + 0x80) >> 8) & (FX_ANGLE_TURN - 1));
+}
+
+uint32_t fx_isqrt(uint32_t v) {
+  // Digit-by-digit method, one result bit per iteration
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (v >= result + bit) {
+      v -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
@@ -0,0 +1,45 @@
+// Fixed-point math for graphics and sensor code (no FPU on the ESP32-C6)
+//
+// Part of this library because the arc and ring code depends on it; the
+// application includes it from here for its own angles and square roots.
+
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <stdint.h>
+
+// Binary angle: one full turn is 65536, 0 points to +x, increasing clockwise
+// on screen (y down). Matches the Q16 angles of Arduino_GFX::fillArcQ16().
+typedef int32_t angle_q16_t;
+
+#define FX_ANGLE_TURN    65536L
+#define FX_ANGLE_HALF    32768L
+#define FX_ANGLE_QUARTER 16384L
+#define FX_ANGLE_FROM_DEG(d) ((angle_q16_t)(((int32_t)(d) * FX_ANGLE_TURN) / 360))
+
+// Q15 fixed point: 32767 ~ 1.0
+#define FX_Q15_ONE 32767
+
+// Table based sine/cosine, Q15 result, linear interpolation between
+// 64 steps per quadrant (max error ~1e-4)
+int32_t fx_sin_q15(angle_q16_t angle);
+int32_t fx_cos_q15(angle_q16_t angle);
+
+// CORDIC atan2, result in [0, FX_ANGLE_TURN), 0 for the origin
+angle_q16_t fx_atan2(int32_t y, int32_t x);
+
+// Integer square root, floor(sqrt(v))
+uint32_t fx_isqrt(uint32_t v);
+
+// Multiply by a Q15 factor with rounding
+static inline int32_t fx_mul_q15(int32_t v, int32_t q15) {
+  return (v * q15 + (1L << 14)) >> 15;
+}
+
+// Fraction num/den as a Q16 angle (0..FX_ANGLE_TURN), e.g. timer progress
+static inline angle_q16_t fx_fraction_q16(uint32_t num, uint32_t den) {
+  if (den == 0 || num >= den) return FX_ANGLE_TURN;
+  return (angle_q16_t)(((uint64_t)num * FX_ANGLE_TURN) / den);
+}
+
+#endif // FIXED_MATH_H
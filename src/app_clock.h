@@ -0,0 +1,22 @@
+// Application time base for the timer, touch and rotation logic
+
+#ifndef APP_CLOCK_H
+#define APP_CLOCK_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Monotonic time since boot, 64-bit, never wraps (millis() does after 49.7
+// days). Absolute times kept by the timer engine use this. Host drivers in
+// tools/ step it through esp_timer_get_time().
+inline uint64_t appMillis64() {
+  return (uint64_t)(esp_timer_get_time() / 1000);
+}
+
+// Low 32 bits, same as millis(). Only for short intervals measured with
+// unsigned subtraction (debounce, hold, cadence).
+inline unsigned long appMillis() {
+  return (unsigned long)appMillis64();
+}
+
+#endif // APP_CLOCK_H
@@ -5,6 +5,11 @@
 #include "pomodoro_config.h"
 #include "display_graphics.h"
 #include "display_updates.h"
+#include "storage.h"
+#include "deferred_log.h"
+#include "app_clock.h"
+#include "input_trace.h"
+#include "backlight.h"
 #include <Wire.h>
 #include "esp_lcd_touch_axs5106l.h"
 
@@ -14,6 +19,11 @@ calData imuCalibration = { 0 };
 AccelData accelData;
 bool imuInitialized = false;
 
+// Previous sample, for motion that wakes the backlight
+static int32_t prevAx = 0;
+static int32_t prevAy = 0;
+static bool havePrev = false;
+
 // Detect rotation based on accelerometer data (gravity direction)
 uint8_t detectRotation() {
   if (!imuInitialized) return currentRotation;
@@ -21,19 +31,26 @@ uint8_t detectRotation() {
   // IMU shares I2C bus with touch - no pin switching needed
   imu.update();
   imu.getAccel(&accelData);
-  
-  float ax = accelData.accelX;
-  float ay = accelData.accelY;
+
+  // Convert once to integer milli-g, all comparisons below are integer
+  int32_t ax = (int32_t)(accelData.accelX * 1000.0f);
+  int32_t ay = (int32_t)(accelData.accelY * 1000.0f);
+  traceRecordImu(ax, ay);
+
+  if (havePrev && abs(ax - prevAx) + abs(ay - prevAy) > BACKLIGHT_MOTION_MG) backlightActivity();
+  prevAx = ax;
+  prevAy = ay;
+  havePrev = true;
   
   // Determine orientation based on which axis feels gravity
   // Portrait: Y-axis dominant, Landscape: X-axis dominant
-  if (ay < -ROTATION_THRESHOLD) {
+  if (ay < -ROTATION_THRESHOLD_MG) {
     return 0;  // Portrait normal (USB connector down)
-  } else if (ay > ROTATION_THRESHOLD) {
+  } else if (ay > ROTATION_THRESHOLD_MG) {
     return 2;  // Portrait upside down (USB connector up)
-  } else if (ax > ROTATION_THRESHOLD) {
+  } else if (ax > ROTATION_THRESHOLD_MG) {
     return 1;  // Landscape right
-  } else if (ax < -ROTATION_THRESHOLD) {
+  } else if (ax < -ROTATION_THRESHOLD_MG) {
     return 3;  // Landscape left
   }
   
@@ -44,49 +61,33 @@ uint8_t detectRotation() {
 void applyRotation(uint8_t newRotation) {
   if (newRotation == currentRotation) return;
   
-  Serial.print("Rotation changed: ");
-  Serial.print(currentRotation);
-  Serial.print(" -> ");
-  Serial.println(newRotation);
+  LOG(LOG_ROTATION_CHANGED, currentRotation, newRotation);
+  traceAction(ACT_ROTATE);
   
   currentRotation = newRotation;
+  saveSettings();
   gfx->setRotation(currentRotation);
   
   // Re-initialize touch controller with new rotation
   bsp_touch_init(&Wire, TP_RST, TP_INT, gfx->getRotation(), gfx->width(), gfx->height());
   
   // Force full display refresh
-  displayInitialized = false;
-  forceCircleRedraw = true;  // Reset progress circle state
-  memset(lastTimeStr, 0, sizeof(lastTimeStr));
-  
-  // Redraw current screen based on current view mode
-  if (currentViewMode == 2) {
-    // Color preview screen - just redraw it
-    drawColorPreview();
-  } else if (currentState == STOPPED && currentViewMode == 0) {
-    // Home screen
-    drawSplash();
-  } else if (currentViewMode == 1 || gridViewActive) {
-    // Grid/palette view
-    drawGrid();
-  } else {
-    // Timer screen
-    gfx->fillScreen(COLOR_BLACK);
-    drawTimer();
-  }
+  redrawCurrentView();
 }
 
 // Check and handle auto-rotation (called from loop)
 void checkAutoRotation() {
   if (!imuInitialized) return;
   
-  unsigned long now = millis();
-  if (now - lastRotationCheck < ROTATION_CHECK_INTERVAL) return;
+  unsigned long now = appMillis();
+  // Sampled faster while the backlight is dimmed, so picking the device up wakes it
+  unsigned long interval = backlightDimmed() ? BACKLIGHT_MOTION_CHECK_MS : ROTATION_CHECK_INTERVAL;
+  if (now - lastRotationCheck < interval) return;
   lastRotationCheck = now;
   
   uint8_t newRotation = detectRotation();
   if (newRotation != currentRotation) {
+    traceInputEvent();  // The sample that showed the new orientation
     applyRotation(newRotation);
   }
 }
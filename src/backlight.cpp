@@ -0,0 +1,176 @@
+// Backlight controller implementation
+
+#include "backlight.h"
+
+#if USE_BACKLIGHT_PWM
+
+#include "pomodoro_globals.h"
+#include "deferred_log.h"
+#include <driver/ledc.h>
+#include <time.h>
+
+#define BACKLIGHT_MODE LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_CHANNEL LEDC_CHANNEL_0
+#define BACKLIGHT_TIMER LEDC_TIMER_0
+#define BACKLIGHT_DUTY_MAX ((1UL << BACKLIGHT_PWM_BITS) - 1)
+#define BACKLIGHT_CLOCK_VALID 1700000000UL  // Earlier wall times mean NTP has not synced yet
+
+static bool ready = false;
+static uint8_t level = 0;                 // Percent, last target
+static uint32_t lastActivity = 0;
+static TimerState seenState = STOPPED;
+static bool seenWork = true;
+
+// Estimate: duty x ms per timer state, against the time spent in it
+static uint64_t dutyMs[3] = { 0, 0, 0 };
+static uint64_t stateMs[3] = { 0, 0, 0 };
+static uint32_t lastAccount = 0;
+
+// Gamma 2.2 per percent as a 0..65535 fraction of full duty, so no float
+// math runs on the FPU-less C6:
+//   [round((p / 100) ** 2.2 * 65535) for p in range(101)]
+static const uint16_t gammaTable[101] = {
+      0,     3,    12,    29,    55,    90,   134,   189,   253,   328,
+    413,   510,   618,   736,   867,  1009,  1163,  1329,  1507,  1697,
+   1900,  2115,  2343,  2584,  2838,  3104,  3384,  3677,  3983,  4303,
+   4636,  4983,  5343,  5717,  6106,  6508,  6924,  7354,  7798,  8257,
+   8730,  9217,  9719, 10235, 10766, 11312, 11872, 12448, 13038, 13643,
+  14263, 14898, 15548, 16214, 16894, 17590, 18302, 19028, 19770, 20528,
+  21301, 22090, 22895, 23715, 24551, 25403, 26271, 27154, 28054, 28970,
+  29901, 30849, 31813, 32793, 33790, 34802, 35831, 36877, 37939, 39017,
+  40112, 41223, 42351, 43496, 44657, 45835, 47029, 48241, 49469, 50714,
+  51976, 53255, 54551, 55864, 57195, 58542, 59906, 61287, 62686, 64102,
+  65535
+};
+
+// --- Helper: perceived brightness percent -> PWM duty ---
+static uint32_t dutyFor(uint8_t percent) {
+  if (percent >= 100) return BACKLIGHT_DUTY_MAX;
+  if (percent == 0) return 0;
+  uint32_t duty = (uint32_t)(((uint64_t)gammaTable[percent] * BACKLIGHT_DUTY_MAX + 32767) / 65535);
+  return duty ? duty : 1;  // Dimmest step still lit
+}
+
+// --- Helper: hardware fade from the current duty to percent ---
+static void fadeTo(uint8_t percent, uint32_t fadeMs) {
+  if (percent == level) return;
+  level = percent;
+#if SOC_LEDC_SUPPORT_FADE_STOP
+  ledc_fade_stop(BACKLIGHT_MODE, BACKLIGHT_CHANNEL);  // A fade in progress would block the next one
+#endif
+  ledc_set_fade_time_and_start(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, dutyFor(percent), fadeMs, LEDC_FADE_NO_WAIT);
+}
+
+// --- Helper: brightness ceiling for the time of day ---
+static uint8_t ceilingNow() {
+  time_t now = time(nullptr);
+  if ((uint32_t)now < BACKLIGHT_CLOCK_VALID) return BACKLIGHT_ACTIVE_PCT;
+  struct tm lt;
+  localtime_r(&now, &lt);
+  bool night = (BACKLIGHT_NIGHT_START_H > BACKLIGHT_NIGHT_END_H)
+                 ? (lt.tm_hour >= BACKLIGHT_NIGHT_START_H || lt.tm_hour < BACKLIGHT_NIGHT_END_H)
+                 : (lt.tm_hour >= BACKLIGHT_NIGHT_START_H && lt.tm_hour < BACKLIGHT_NIGHT_END_H);
+  return night ? BACKLIGHT_NIGHT_PCT : BACKLIGHT_ACTIVE_PCT;
+}
+
+// --- Helper: level the current state asks for ---
+static uint8_t targetLevel() {
+  uint32_t idle = millis() - lastActivity;
+  uint8_t target = BACKLIGHT_ACTIVE_PCT;
+  if (idle >= BACKLIGHT_IDLE_MS && currentState != RUNNING) {
+    target = BACKLIGHT_IDLE_PCT;
+  } else if (idle >= BACKLIGHT_DIM_MS) {
+    target = BACKLIGHT_DIM_PCT;
+  }
+  uint8_t ceiling = ceilingNow();
+  return target < ceiling ? target : ceiling;
+}
+
+void initBacklight() {
+  ledc_timer_config_t timer = {};
+  timer.speed_mode = BACKLIGHT_MODE;
+  timer.duty_resolution = (ledc_timer_bit_t)BACKLIGHT_PWM_BITS;
+  timer.timer_num = BACKLIGHT_TIMER;
+  timer.freq_hz = BACKLIGHT_PWM_HZ;
+  timer.clk_cfg = LEDC_AUTO_CLK;
+  ledc_channel_config_t channel = {};
+  channel.gpio_num = GFX_BL;
+  channel.speed_mode = BACKLIGHT_MODE;
+  channel.channel = BACKLIGHT_CHANNEL;
+  channel.timer_sel = BACKLIGHT_TIMER;
+  channel.duty = 0;
+  if (ledc_timer_config(&timer) != ESP_OK || ledc_channel_config(&channel) != ESP_OK ||
+      ledc_fade_func_install(0) != ESP_OK) {
+    // Without PWM the panel is at least lit
+    LOG(LOG_BACKLIGHT_FAILED);
+    pinMode(GFX_BL, OUTPUT);
+    digitalWrite(GFX_BL, HIGH);
+    return;
+  }
+  ready = true;
+  lastActivity = millis();
+  lastAccount = lastActivity;
+  fadeTo(targetLevel(), BACKLIGHT_DIM_FADE_MS);  // Fade in from dark at boot
+}
+
+void serviceBacklight() {
+  if (!ready) return;
+  uint32_t now = millis();
+
+  // Account the elapsed time at the duty being output (mid-fade included)
+  uint32_t dt = now - lastAccount;
+  lastAccount = now;
+  dutyMs[seenState] += (uint64_t)ledc_get_duty(BACKLIGHT_MODE, BACKLIGHT_CHANNEL) * dt;
+  stateMs[seenState] += dt;
+
+  // Any timer transition, a session running out included, is worth seeing
+  if (currentState != seenState || isWorkSession != seenWork) {
+    seenState = currentState;
+    seenWork = isWorkSession;
+    lastActivity = now;
+  }
+
+  uint8_t target = targetLevel();
+  fadeTo(target, target > level ? BACKLIGHT_WAKE_FADE_MS : BACKLIGHT_DIM_FADE_MS);
+}
+
+void backlightActivity() {
+  lastActivity = millis();
+  if (ready && level < targetLevel()) fadeTo(targetLevel(), BACKLIGHT_WAKE_FADE_MS);
+}
+
+bool backlightDimmed() {
+  return ready && level < ceilingNow();
+}
+
+uint8_t backlightPercent() {
+  return ready ? level : 100;
+}
+
+// --- Helper: mean LED current in 0.1 mA over the given totals ---
+static uint32_t averageMa10(uint64_t duty, uint64_t ms) {
+  if (ms == 0) return 0;
+  return (uint32_t)(duty * BACKLIGHT_FULL_MA * 10 / BACKLIGHT_DUTY_MAX / ms);
+}
+
+uint32_t backlightAverageMa10() {
+  return averageMa10(dutyMs[0] + dutyMs[1] + dutyMs[2], stateMs[0] + stateMs[1] + stateMs[2]);
+}
+
+bool backlightCommand(char c) {
+  if (c != 'l') return false;
+  static const char* const stateNames[] = { "stopped", "running", "paused" };
+  Serial.printf("[BL] Level %u%% (ceiling %u%%), full duty ~%u mA\n", backlightPercent(), ceilingNow(),
+                BACKLIGHT_FULL_MA);
+  for (uint8_t s = 0; s < 3; s++) {
+    uint32_t ma10 = averageMa10(dutyMs[s], stateMs[s]);
+    uint32_t mah10 = (uint32_t)(dutyMs[s] * BACKLIGHT_FULL_MA * 10 / BACKLIGHT_DUTY_MAX / 3600000ULL);
+    Serial.printf("[BL] %-8s %6lu s  avg %lu.%lu mA  %lu.%lu mAh  (%lu%% of always on)\n", stateNames[s],
+                  (unsigned long)(stateMs[s] / 1000), (unsigned long)(ma10 / 10), (unsigned long)(ma10 % 10),
+                  (unsigned long)(mah10 / 10), (unsigned long)(mah10 % 10),
+                  (unsigned long)(ma10 * 10 / BACKLIGHT_FULL_MA));
+  }
+  return true;
+}
+
+#endif // USE_BACKLIGHT_PWM
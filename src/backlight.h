@@ -0,0 +1,35 @@
+// Backlight controller
+//
+// GFX_BL is driven by an LEDC channel; level changes are hardware fades, so
+// no CPU time is spent per step. serviceBacklight() picks the level from the
+// time since the last activity, the timer state and the time of day, and
+// integrates the estimated LED current per timer state.
+
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+#if USE_BACKLIGHT_PWM
+void initBacklight();
+void serviceBacklight();    // Loop: level for the current state, power estimate
+void backlightActivity();   // Touch or motion: back to full at once
+bool backlightDimmed();     // Below the level activity would give (motion is sampled faster)
+uint8_t backlightPercent(); // Level being shown or faded to
+uint32_t backlightAverageMa10();  // Estimated mean LED current since boot, 0.1 mA
+bool backlightCommand(char c);    // 'l' on Serial: estimate per timer state
+#else
+inline void initBacklight() {
+  pinMode(GFX_BL, OUTPUT);
+  digitalWrite(GFX_BL, HIGH);
+}
+inline void serviceBacklight() {}
+inline void backlightActivity() {}
+inline bool backlightDimmed() { return false; }
+inline uint8_t backlightPercent() { return 100; }
+inline uint32_t backlightAverageMa10() { return BACKLIGHT_FULL_MA * 10; }
+inline bool backlightCommand(char c) { return false; }
+#endif
+
+#endif // BACKLIGHT_H
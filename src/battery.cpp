@@ -0,0 +1,202 @@
+// Battery monitor implementation
+
+#include "battery.h"
+
+#if USE_BATTERY_MONITOR
+
+#include "deferred_log.h"
+#include <esp_adc/adc_continuous.h>
+#include <esp_adc/adc_cali.h>
+#include <esp_adc/adc_cali_scheme.h>
+#include <esp_timer.h>
+
+// Li-ion discharge curve at light load: cell millivolts -> percent, falling
+static const struct {
+  uint16_t millivolts;
+  uint8_t percent;
+} dischargeCurve[] = {
+  { 4200, 100 }, { 4100, 92 }, { 4000, 82 }, { 3900, 70 }, { 3800, 55 }, { 3750, 45 },
+  { 3700, 32 },  { 3650, 20 }, { 3600, 12 }, { 3500, 5 },  { 3300, 0 },
+};
+
+static adc_continuous_handle_t adc = nullptr;
+static adc_cali_handle_t cali = nullptr;
+static BatteryStats stats = { 0, BATTERY_UNKNOWN, 0, 0, 0, 0, 0 };
+static volatile uint32_t framesDone = 0;    // From the ADC ISR
+static volatile uint32_t poolOverflows = 0;
+static uint32_t startedAt = 0;
+static uint32_t lastRead = 0;
+static uint32_t filtered = 0;               // Raw ADC value, Q4
+static bool haveFiltered = false;
+static uint16_t window[BATTERY_MEDIAN_N];   // Raw values waiting for a median
+static uint8_t windowFill = 0;
+
+static bool IRAM_ATTR onFrame(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* edata, void* user) {
+  framesDone++;
+  return false;
+}
+
+static bool IRAM_ATTR onPoolFull(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* edata, void* user) {
+  poolOverflows++;
+  return false;
+}
+
+// --- Helper: median of the window (sorted in place, it is refilled anyway) ---
+static uint16_t windowMedian() {
+  for (uint8_t i = 1; i < BATTERY_MEDIAN_N; i++) {
+    uint16_t v = window[i];
+    uint8_t j = i;
+    while (j > 0 && window[j - 1] > v) {
+      window[j] = window[j - 1];
+      j--;
+    }
+    window[j] = v;
+  }
+  return window[BATTERY_MEDIAN_N / 2];
+}
+
+// --- Helper: one raw sample through the median and the IIR ---
+static void addSample(uint16_t raw) {
+  window[windowFill++] = raw;
+  if (windowFill < BATTERY_MEDIAN_N) return;
+  windowFill = 0;
+  uint32_t median = (uint32_t)windowMedian() << 4;
+  if (!haveFiltered) {
+    filtered = median;
+    haveFiltered = true;
+  } else {
+    filtered = filtered + (((int32_t)median - (int32_t)filtered) >> BATTERY_IIR_SHIFT);
+  }
+}
+
+// --- Helper: state of charge by linear interpolation in the curve ---
+static uint8_t percentFromMillivolts(uint16_t mv) {
+  const uint8_t n = sizeof(dischargeCurve) / sizeof(dischargeCurve[0]);
+  if (mv >= dischargeCurve[0].millivolts) return 100;
+  for (uint8_t i = 1; i < n; i++) {
+    if (mv >= dischargeCurve[i].millivolts) {
+      uint16_t spanMv = dischargeCurve[i - 1].millivolts - dischargeCurve[i].millivolts;
+      uint16_t spanPct = dischargeCurve[i - 1].percent - dischargeCurve[i].percent;
+      return dischargeCurve[i].percent + (uint32_t)(mv - dischargeCurve[i].millivolts) * spanPct / spanMv;
+    }
+  }
+  return 0;
+}
+
+void initBattery() {
+  adc_unit_t unit;
+  adc_channel_t channel;
+  if (adc_continuous_io_to_channel(BAT_PIN, &unit, &channel) != ESP_OK || unit != ADC_UNIT_1) {
+    LOG(LOG_BATTERY_FAILED, "pin has no ADC1 channel");
+    return;
+  }
+
+  adc_continuous_handle_cfg_t handleConfig = {};
+  handleConfig.max_store_buf_size = BATTERY_POOL_BYTES;
+  handleConfig.conv_frame_size = BATTERY_FRAME_BYTES;
+  handleConfig.flags.flush_pool = 1;  // Keep the newest frames when the loop is late
+  if (adc_continuous_new_handle(&handleConfig, &adc) != ESP_OK) {
+    LOG(LOG_BATTERY_FAILED, "no ADC handle");
+    return;
+  }
+
+  adc_digi_pattern_config_t pattern = {};
+  pattern.atten = ADC_ATTEN_DB_12;
+  pattern.channel = channel;
+  pattern.unit = unit;
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+  adc_continuous_config_t config = {};
+  config.pattern_num = 1;
+  config.adc_pattern = &pattern;
+  config.sample_freq_hz = BATTERY_SAMPLE_HZ;
+  config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+  adc_continuous_evt_cbs_t callbacks = {};
+  callbacks.on_conv_done = onFrame;
+  callbacks.on_pool_ovf = onPoolFull;
+  if (adc_continuous_config(adc, &config) != ESP_OK ||
+      adc_continuous_register_event_callbacks(adc, &callbacks, nullptr) != ESP_OK ||
+      adc_continuous_start(adc) != ESP_OK) {
+    adc_continuous_deinit(adc);
+    adc = nullptr;
+    LOG(LOG_BATTERY_FAILED, "ADC config");
+    return;
+  }
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+  adc_cali_curve_fitting_config_t caliConfig = {};
+  caliConfig.unit_id = unit;
+  caliConfig.chan = channel;
+  caliConfig.atten = ADC_ATTEN_DB_12;
+  caliConfig.bitwidth = ADC_BITWIDTH_DEFAULT;
+  if (adc_cali_create_scheme_curve_fitting(&caliConfig, &cali) != ESP_OK) cali = nullptr;
+#endif
+
+  startedAt = millis();
+  lastRead = startedAt;
+  LOG(LOG_BATTERY_STARTED, (uint32_t)BAT_PIN, (uint32_t)BATTERY_SAMPLE_HZ);
+}
+
+void serviceBattery() {
+  if (adc == nullptr || millis() - lastRead < BATTERY_READ_MS) return;
+  lastRead = millis();
+  int64_t start = esp_timer_get_time();
+
+  uint8_t frame[BATTERY_FRAME_BYTES];
+  uint32_t got = 0;
+  while (adc_continuous_read(adc, frame, sizeof(frame), &got, 0) == ESP_OK) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= got; i += SOC_ADC_DIGI_RESULT_BYTES) {
+      const adc_digi_output_data_t* p = (const adc_digi_output_data_t*)&frame[i];
+      addSample(p->type2.data);
+      stats.samples++;
+    }
+  }
+
+  if (haveFiltered) {
+    int raw = (filtered + 8) >> 4;
+    int mv = raw * 3300 / ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1);  // Uncalibrated fallback
+    if (cali != nullptr) adc_cali_raw_to_voltage(cali, raw, &mv);
+    stats.millivolts = mv * BATTERY_DIVIDER;
+    stats.percent = percentFromMillivolts(stats.millivolts);
+  }
+  stats.frames = framesDone;
+  stats.overflows = poolOverflows;
+  stats.busyUs += (uint32_t)(esp_timer_get_time() - start);
+  stats.runMs = millis() - startedAt;
+}
+
+uint8_t batteryPercent() {
+  return stats.percent;
+}
+
+uint16_t batteryMillivolts() {
+  return stats.millivolts;
+}
+
+const BatteryStats& batteryStats() {
+  return stats;
+}
+
+uint32_t batteryCpuUsPerS() {
+  return stats.runMs >= 1000 ? (uint32_t)((uint64_t)stats.busyUs * 1000 / stats.runMs) : 0;
+}
+
+bool batteryCommand(char c) {
+  if (c != 'b') return false;
+  if (adc == nullptr) {
+    Serial.println("[BAT] not sampling");
+    return true;
+  }
+  uint32_t seconds = stats.runMs / 1000;
+  Serial.printf("[BAT] %u mV, %u%%\n", stats.millivolts, stats.percent);
+  Serial.printf("[BAT] %lu samples, %lu DMA frames (%lu/s), %lu pool overflows over %lu s\n",
+                (unsigned long)stats.samples, (unsigned long)stats.frames,
+                (unsigned long)(seconds ? stats.frames / seconds : 0), (unsigned long)stats.overflows,
+                (unsigned long)seconds);
+  Serial.printf("[BAT] Loop time draining and filtering: %lu us/s (%lu.%02lu%% CPU)\n",
+                (unsigned long)batteryCpuUsPerS(), (unsigned long)(batteryCpuUsPerS() / 10000),
+                (unsigned long)(batteryCpuUsPerS() / 100 % 100));
+  return true;
+}
+
+#endif // USE_BATTERY_MONITOR
@@ -0,0 +1,44 @@
+// Battery monitor
+//
+// BAT_PIN is sampled by the IDF continuous ADC driver into a DMA ring with
+// no CPU polling. serviceBattery() drains the ring from the loop once every
+// BATTERY_READ_MS, filters the raw values in fixed point (median of
+// BATTERY_MEDIAN_N, then an IIR), calibrates the result once and maps the
+// voltage to a state of charge through a Li-ion discharge table.
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+#define BATTERY_UNKNOWN 0xFF  // batteryPercent() before the first reading
+
+struct BatteryStats {
+  uint16_t millivolts;    // At the battery, after the divider is undone
+  uint8_t percent;
+  uint32_t samples;       // Since boot
+  uint32_t frames;        // DMA frames completed (one interrupt each)
+  uint32_t overflows;     // Pool full, older frames flushed
+  uint32_t busyUs;        // serviceBattery() time since boot
+  uint32_t runMs;         // Since sampling started
+};
+
+#if USE_BATTERY_MONITOR
+void initBattery();
+void serviceBattery();  // Loop: drain and filter, every BATTERY_READ_MS
+uint8_t batteryPercent();
+uint16_t batteryMillivolts();  // 0 before the first reading
+const BatteryStats& batteryStats();
+uint32_t batteryCpuUsPerS();  // Loop time spent on sampling, per second
+bool batteryCommand(char c);  // 'b' on Serial: reading and sampling cost
+#else
+inline void initBattery() {}
+inline void serviceBattery() {}
+inline uint8_t batteryPercent() { return BATTERY_UNKNOWN; }
+inline uint16_t batteryMillivolts() { return 0; }
+inline uint32_t batteryCpuUsPerS() { return 0; }
+inline bool batteryCommand(char c) { return false; }
+#endif
+
+#endif // BATTERY_H
@@ -39,3 +39,14 @@ uint16_t invertColor(uint16_t color) {
   b = 0x1F - b;
   return (r << 11) | (g << 5) | b;
 }
+
+// Blend fg over bg by level/levels per RGB565 channel (level 0 = bg)
+uint16_t blendColor(uint16_t fg, uint16_t bg, uint8_t level, uint8_t levels) {
+  int32_t rf = fg >> 11, gf = (fg >> 5) & 0x3F, bf = fg & 0x1F;
+  int32_t rb = bg >> 11, gb = (bg >> 5) & 0x3F, bb = bg & 0x1F;
+  int32_t half = levels / 2;
+  int32_t r = rb + ((rf - rb) * level + half) / levels;
+  int32_t g = gb + ((gf - gb) * level + half) / levels;
+  int32_t b = bb + ((bf - bb) * level + half) / levels;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
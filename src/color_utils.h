@@ -9,6 +9,9 @@
 // Function to invert a 16-bit RGB565 color
 uint16_t invertColor(uint16_t color);
 
+// Blend fg over bg by level/levels per RGB565 channel (level 0 = bg)
+uint16_t blendColor(uint16_t fg, uint16_t bg, uint8_t level, uint8_t levels);
+
 // Global palette array for color picker
 extern const uint16_t paletteColors[];
 extern const int paletteSize;
@@ -0,0 +1,134 @@
+// Deferred binary logging implementation
+
+#include "deferred_log.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Bounded multi-producer ring (Vyukov): a slot is free for position p when
+// its seq == p and holds a committed record when seq == p + 1. Producers
+// claim positions with a CAS on logHead; the drain task is the only consumer.
+// seq is stored minus the slot index, so the zeroed ring starts out empty
+// and records logged before startLogTask() are kept.
+static LogRecord logRing[LOG_RING_SIZE];
+static uint32_t logHead = 0;
+static uint32_t logTail = 0;
+static uint32_t logDropped = 0;
+
+#define LOG_FRAME_SYNC0 0xA5
+#define LOG_FRAME_SYNC1 0x5A
+const unsigned long LOG_DRAIN_INTERVAL_MS = 50;
+
+LogRecord* logBegin(LogFormatId id) {
+  uint32_t pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+  LogRecord* rec;
+  while (true) {
+    uint32_t idx = pos & (LOG_RING_SIZE - 1);
+    rec = &logRing[idx];
+    int32_t diff = (int32_t)(__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) + idx - pos);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&logHead, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+    } else if (diff < 0) {
+      __atomic_fetch_add(&logDropped, 1, __ATOMIC_RELAXED);
+      return nullptr;
+    } else {
+      pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+    }
+  }
+  rec->time = xTaskGetTickCount();
+  rec->fmt = id;
+  rec->len = 0;
+  return rec;
+}
+
+void logCommit(LogRecord* rec) {
+  // Untouched since the claim, seq still encodes the claimed position p; p + 1 publishes it
+  __atomic_store_n(&rec->seq, rec->seq + 1, __ATOMIC_RELEASE);
+}
+
+// --- Helper: pop the oldest committed record (drain task only) ---
+static bool logPop(LogRecord* out) {
+  uint32_t idx = logTail & (LOG_RING_SIZE - 1);
+  LogRecord* rec = &logRing[idx];
+  if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) + idx != logTail + 1) return false;
+  memcpy(out, rec, sizeof(LogRecord));
+  __atomic_store_n(&rec->seq, logTail + LOG_RING_SIZE - idx, __ATOMIC_RELEASE);
+  logTail++;
+  return true;
+}
+
+#if LOG_BINARY_OUTPUT
+// --- Helper: write one frame: sync, id, length, time (ms, LE), payload ---
+static void logEmit(const LogRecord& rec) {
+  uint8_t frame[8 + LOG_PAYLOAD_SIZE];
+  uint32_t ms = pdTICKS_TO_MS(rec.time);
+  frame[0] = LOG_FRAME_SYNC0;
+  frame[1] = LOG_FRAME_SYNC1;
+  frame[2] = rec.fmt;
+  frame[3] = rec.len;
+  memcpy(frame + 4, &ms, 4);
+  memcpy(frame + 8, rec.payload, rec.len);
+  Serial.write(frame, 8 + rec.len);
+}
+#else
+#define LOG_X_TEXT(id, level, tag, text) text,
+static const char* const logFormatText[] = { LOG_FORMATS(LOG_X_TEXT) };
+
+// --- Helper: expand a record through its format string on the device ---
+static void logEmit(const LogRecord& rec) {
+  if (rec.fmt >= LOG_FORMAT_COUNT) return;
+  const char* f = logFormatText[rec.fmt];
+  uint8_t pos = 0;
+  while (*f) {
+    if (*f != '%' || f[1] == '\0') {
+      Serial.write(*f++);
+      continue;
+    }
+    char spec = f[1];
+    f += 2;
+    if (spec == 's') {
+      const char* s = (const char*)rec.payload + pos;
+      uint8_t n = strnlen(s, rec.len - pos);
+      Serial.write((const uint8_t*)s, n);
+      pos += n + 1;
+    } else if (spec == 'u' || spec == 'd' || spec == 'X') {
+      uint32_t v = 0;
+      if (pos + 4 <= rec.len) memcpy(&v, rec.payload + pos, 4);
+      pos += 4;
+      if (spec == 'd') Serial.print((int32_t)v);
+      else if (spec == 'X') Serial.print(v, HEX);
+      else Serial.print(v);
+    } else {
+      Serial.write(spec);
+    }
+  }
+  Serial.println();
+}
+#endif
+
+// --- Helper: report records lost to a full ring as a record of its own ---
+static void logEmitDropped() {
+  uint32_t dropped = __atomic_exchange_n(&logDropped, 0, __ATOMIC_RELAXED);
+  if (dropped == 0) return;
+  LogRecord rec;
+  rec.time = xTaskGetTickCount();
+  rec.fmt = LOG_DROPPED;
+  rec.len = 0;
+  logPut(&rec, dropped);
+  logEmit(rec);
+}
+
+// Drain task - runs at idle priority so Serial never delays touch or drawing
+static void logDrainTask(void* parameter) {
+  LogRecord rec;
+  while (true) {
+    while (logPop(&rec)) {
+      logEmit(rec);
+    }
+    logEmitDropped();
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+  }
+}
+
+void startLogTask() {
+  xTaskCreate(logDrainTask, "LogDrain", 3072, NULL, tskIDLE_PRIORITY, NULL);
+}
@@ -0,0 +1,120 @@
+// Deferred binary logging
+//
+// LOG(id, args...) stores the message id, a tick timestamp and the raw
+// arguments in a lock-free ring buffer; a low-priority task drains it to
+// Serial. Messages, their level and their module tag are declared in
+// log_formats.h. Anything below LOG_LEVEL or outside LOG_TAG_MASK is
+// removed at compile time, arguments included.
+
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+// Levels, LOG_LEVEL in pomodoro_config.h keeps everything up to it
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+// Module tags, one bit each in LOG_TAG_MASK
+enum LogTag {
+  LOG_TAG_LOG,
+  LOG_TAG_TOUCH,
+  LOG_TAG_TIMER,
+  LOG_TAG_TELEGRAM,
+  LOG_TAG_STORAGE,
+  LOG_TAG_ROTATION,
+  LOG_TAG_DISPLAY,
+  LOG_TAG_HTTP,
+  LOG_TAG_MQTT,
+  LOG_TAG_BATTERY,
+  LOG_TAG_MEM
+};
+
+#include "log_formats.h"
+
+#define LOG_X_ID(id, level, tag, text) id,
+#define LOG_X_LEVEL(id, level, tag, text) level,
+#define LOG_X_TAG(id, level, tag, text) tag,
+
+enum LogFormatId : uint8_t {
+  LOG_FORMATS(LOG_X_ID)
+  LOG_FORMAT_COUNT
+};
+
+static constexpr uint8_t logFormatLevel[] = { LOG_FORMATS(LOG_X_LEVEL) };
+static constexpr uint8_t logFormatTag[] = { LOG_FORMATS(LOG_X_TAG) };
+
+constexpr bool logEnabled(LogFormatId id) {
+  return (logFormatLevel[id] <= LOG_LEVEL) && ((LOG_TAG_MASK >> logFormatTag[id]) & 1);
+}
+
+#define LOG_RING_SIZE 64  // Records, power of two
+#define LOG_PAYLOAD_SIZE 30
+
+struct LogRecord {
+  uint32_t seq;   // Ring bookkeeping, not sent
+  uint32_t time;  // FreeRTOS ticks
+  uint8_t fmt;    // LogFormatId
+  uint8_t len;    // Payload bytes used
+  uint8_t payload[LOG_PAYLOAD_SIZE];
+};
+
+// Reserve a record (nullptr and a drop count when the ring is full), fill
+// it, then commit it. Safe from any task; not from ISRs.
+LogRecord* logBegin(LogFormatId id);
+void logCommit(LogRecord* rec);
+void startLogTask();
+
+// --- Argument packing: 32-bit little-endian words, strings NUL-terminated ---
+inline void logPut(LogRecord* rec, const char* s) {
+  uint8_t room = LOG_PAYLOAD_SIZE - rec->len;
+  if (room == 0) return;
+  uint8_t n = 0;
+  while (n < room - 1 && s[n] != '\0') n++;
+  memcpy(rec->payload + rec->len, s, n);
+  rec->payload[rec->len + n] = '\0';
+  rec->len += n + 1;
+}
+
+inline void logPut(LogRecord* rec, char* s) {
+  logPut(rec, (const char*)s);
+}
+
+inline void logPut(LogRecord* rec, const String& s) {
+  logPut(rec, s.c_str());
+}
+
+template <typename T>
+inline void logPut(LogRecord* rec, T value) {
+  if (rec->len + 4 > LOG_PAYLOAD_SIZE) return;
+  uint32_t v = (uint32_t)value;
+  memcpy(rec->payload + rec->len, &v, 4);
+  rec->len += 4;
+}
+
+inline void logPutAll(LogRecord* rec) {}
+
+template <typename T, typename... Rest>
+inline void logPutAll(LogRecord* rec, const T& first, const Rest&... rest) {
+  logPut(rec, first);
+  logPutAll(rec, rest...);
+}
+
+template <typename... Args>
+inline void logWrite(LogFormatId id, const Args&... args) {
+  LogRecord* rec = logBegin(id);
+  if (rec == nullptr) return;
+  logPutAll(rec, args...);
+  logCommit(rec);
+}
+
+#define LOG(id, ...) \
+  do { \
+    if (logEnabled(id)) logWrite(id, ##__VA_ARGS__); \
+  } while (0)
+
+#endif // DEFERRED_LOG_H
@@ -5,7 +5,9 @@
 #include "pomodoro_config.h"
 #include "color_utils.h"
 #include "FreeSansBold24pt7b.h"
-#include <math.h>
+#include "icons.h"
+#include "deferred_log.h"
+#include "input_trace.h"
 
 // --- Low-level LCD init from Waveshare demo (unchanged) ---
 void lcd_reg_init(void) {
@@ -119,9 +121,8 @@ void drawSplash() {
   int16_t radius = 70;
   int16_t borderWidth = 5;
 
-  for (int16_t i = 0; i < borderWidth; i++) {
-    gfx->drawCircle(centerX, centerY, radius - i, workColor);
-  }
+  // Solid ring in one pass (stacked drawCircle calls left moire gaps)
+  gfx->fillRing(centerX, centerY, radius, radius - borderWidth + 1, workColor);
 
   gfx->setFont(&FreeSansBold24pt7b);
   gfx->setTextColor(workColor);
@@ -313,9 +314,10 @@ void drawGrid() {
     gfx->drawFastHLine(gridStartX, lastRowY, gridWidth, gridColor);
   }
   
-  // Calculate button size - try size 5 or 6 for bigger buttons
+  // Calculate button size - frames keep the footprint of size 5 "X"/"V" glyphs
+  // so touch targets stay the same; the glyphs themselves are drawn as icons
   const char *cancelTxt = "X";
-  const char *confirmTxt = "V";  // Use "V" instead of "✓" for better compatibility
+  const char *confirmTxt = "V";
   
   int16_t x1, y1;
   uint16_t w1, h1, w2, h2;
@@ -336,8 +338,8 @@ void drawGrid() {
   int16_t btnWidth = maxW + padding * 2;
   int16_t btnHeight = maxH + padding * 2;
   
-  int16_t textOffsetX = 2;  // Move right a bit
-  int16_t textOffsetY = 2;  // Move down a bit
+  // Icons are pre-rendered, pick the largest that fits inside the frame
+  int16_t iconSize = min(btnWidth, btnHeight) - 4;
   
   if (isLandscape) {
     // Landscape: buttons on right side, 1 column, 2 rows, V on top, X below
@@ -359,8 +361,8 @@ void drawGrid() {
                   btnHeight,
                   COLOR_GOLD);
     
-    // Draw "V" text centered
-    drawCenteredText(confirmTxt, btnX + textOffsetX, confirmCenterY + textOffsetY, COLOR_GOLD, textSize);
+    // Draw check icon centered
+    drawIcon(ICON_CHECK, btnX, confirmCenterY, iconSize, COLOR_GOLD);
     gridConfirmBtnValid = true;
     
     // Cancel button (X) below
@@ -376,8 +378,8 @@ void drawGrid() {
                   btnHeight,
                   COLOR_GOLD);
     
-    // Draw "X" text centered
-    drawCenteredText(cancelTxt, btnX + textOffsetX, cancelCenterY + textOffsetY, COLOR_GOLD, textSize);
+    // Draw cross icon centered
+    drawIcon(ICON_CROSS, btnX, cancelCenterY, iconSize, COLOR_GOLD);
     gridCancelBtnValid = true;
   } else {
     // Portrait: buttons in bottom row, X on left, V on right, centered
@@ -403,8 +405,8 @@ void drawGrid() {
                   btnHeight,
                   COLOR_GOLD);
     
-    // Draw "X" text centered
-    drawCenteredText(cancelTxt, cancelCenterX + textOffsetX, bottomRowCenterY + textOffsetY, COLOR_GOLD, textSize);
+    // Draw cross icon centered
+    drawIcon(ICON_CROSS, cancelCenterX, bottomRowCenterY, iconSize, COLOR_GOLD);
     gridCancelBtnValid = true;
     
     // Right button "V" (checkmark)
@@ -421,8 +423,8 @@ void drawGrid() {
                   btnHeight,
                   COLOR_GOLD);
     
-    // Draw "V" text centered
-    drawCenteredText(confirmTxt, confirmCenterX + textOffsetX, bottomRowCenterY + textOffsetY, COLOR_GOLD, textSize);
+    // Draw check icon centered
+    drawIcon(ICON_CHECK, confirmCenterX, bottomRowCenterY, iconSize, COLOR_GOLD);
     gridConfirmBtnValid = true;
   }
 }
@@ -445,95 +447,17 @@ void drawCenteredText(const char *txt, int16_t cx, int16_t cy, uint16_t color, u
 
 // --- Helper: draw play icon (triangle) ---
 void drawPlayIcon(int16_t cx, int16_t cy, int16_t size, uint16_t color) {
-  // Draw a filled triangle pointing right
-  int16_t halfH = size / 2;
-  int16_t w = size * 3 / 4;
-  // Triangle vertices: left-top, left-bottom, right-center
-  gfx->fillTriangle(
-    cx - w/2, cy - halfH,      // top-left
-    cx - w/2, cy + halfH,      // bottom-left
-    cx + w/2, cy,              // right center
-    color
-  );
+  drawIcon(ICON_PLAY, cx, cy, size, color);
 }
 
 // --- Helper: draw pause icon (two bars) ---
 void drawPauseIcon(int16_t cx, int16_t cy, int16_t size, uint16_t color) {
-  // Draw two vertical bars
-  int16_t barWidth = size / 4;
-  int16_t barHeight = size;
-  int16_t gap = size / 4;
-  // Left bar
-  gfx->fillRect(cx - gap - barWidth, cy - barHeight/2, barWidth, barHeight, color);
-  // Right bar  
-  gfx->fillRect(cx + gap, cy - barHeight/2, barWidth, barHeight, color);
+  drawIcon(ICON_PAUSE, cx, cy, size, color);
 }
 
 // --- Helper: draw gear icon (settings) - Material Design Icons cog style ---
 void drawGearIcon(int16_t cx, int16_t cy, int16_t size, uint16_t color) {
-  // Material Design Icons cog: outer circle with evenly spaced teeth + inner circle with hole
-  // Fill space between circles
-  int16_t outerRadius = size / 2 - 1;
-  int16_t innerRadius = size / 3;
-  int16_t toothLength = size / 6;
-  int16_t toothWidth = size / 10;  // Fixed width for all teeth
-  int numTeeth = 8;  // Standard 8 teeth for MDI cog
-  
-  // Fill the space between outer and inner circles (gear body)
-  for (int16_t r = innerRadius + 1; r < outerRadius; r++) {
-    gfx->drawCircle(cx, cy, r, color);
-  }
-  
-  // Draw outer circle
-  gfx->drawCircle(cx, cy, outerRadius, color);
-  
-  // Draw teeth (rectangular, evenly spaced, all equal size)
-  // Use pixel-by-pixel filling to ensure all teeth are exactly the same thickness
-  for (int i = 0; i < numTeeth; i++) {
-    float angle = (i * 2.0f * PI) / numTeeth;
-    float cosA = cosf(angle);
-    float sinA = sinf(angle);
-    
-    // Tooth extends from outerRadius to outerRadius + toothLength
-    // Calculate perpendicular direction for tooth width
-    float perpAngle = angle + PI / 2;
-    float perpCos = cosf(perpAngle);
-    float perpSin = sinf(perpAngle);
-    
-    // Calculate tooth center line points
-    float baseCenterX = cx + outerRadius * cosA;
-    float baseCenterY = cy + outerRadius * sinA;
-    float tipCenterX = cx + (outerRadius + toothLength) * cosA;
-    float tipCenterY = cy + (outerRadius + toothLength) * sinA;
-    
-    // Calculate perpendicular offset (half width)
-    float halfWidth = toothWidth / 2.0f;
-    
-    // Fill tooth pixel by pixel along its length to ensure consistent thickness
-    int steps = (int)(toothLength * 2);  // More steps for smoother filling
-    for (int step = 0; step <= steps; step++) {
-      float t = (float)step / steps;
-      float centerX = baseCenterX + t * (tipCenterX - baseCenterX);
-      float centerY = baseCenterY + t * (tipCenterY - baseCenterY);
-      
-      // Draw a line perpendicular to the tooth direction at this point
-      int16_t x1 = (int16_t)(centerX + halfWidth * perpCos);
-      int16_t y1 = (int16_t)(centerY + halfWidth * perpSin);
-      int16_t x2 = (int16_t)(centerX - halfWidth * perpCos);
-      int16_t y2 = (int16_t)(centerY - halfWidth * perpSin);
-      
-      // Draw line to fill the tooth width at this point
-      gfx->drawLine(x1, y1, x2, y2, color);
-    }
-  }
-  
-  // Draw inner circle (hollow center)
-  gfx->fillCircle(cx, cy, innerRadius, COLOR_BLACK);
-  gfx->drawCircle(cx, cy, innerRadius, color);
-  
-  // Draw center hole (smaller circle inside)
-  int16_t holeRadius = innerRadius / 2;
-  gfx->fillCircle(cx, cy, holeRadius, COLOR_BLACK);
+  drawIcon(ICON_GEAR, cx, cy, size, color);
 }
 
 // --- Helper: draw color preview screen ---
@@ -623,7 +547,7 @@ void drawColorPreview() {
                   previewConfirmBtnRight - previewConfirmBtnLeft,
                   previewConfirmBtnBottom - previewConfirmBtnTop,
                   COLOR_WHITE);
-    drawCenteredText("V", btnX, confirmCenterY, COLOR_WHITE, 3);
+    drawIcon(ICON_CHECK, btnX, confirmCenterY, btnSize, COLOR_WHITE);
     previewConfirmBtnValid = true;
     
     // Cancel button (X) below
@@ -635,7 +559,7 @@ void drawColorPreview() {
                   previewCancelBtnRight - previewCancelBtnLeft,
                   previewCancelBtnBottom - previewCancelBtnTop,
                   COLOR_WHITE);
-    drawCenteredText("X", btnX, cancelCenterY, COLOR_WHITE, 3);
+    drawIcon(ICON_CROSS, btnX, cancelCenterY, btnSize, COLOR_WHITE);
     previewCancelBtnValid = true;
   } else {
     // Portrait: buttons at bottom, X on left, V on right
@@ -651,7 +575,7 @@ void drawColorPreview() {
                   previewCancelBtnRight - previewCancelBtnLeft,
                   previewCancelBtnBottom - previewCancelBtnTop,
                   COLOR_WHITE);
-    drawCenteredText("X", cancelCenterX, btnY, COLOR_WHITE, 3);
+    drawIcon(ICON_CROSS, cancelCenterX, btnY, btnSize, COLOR_WHITE);
     previewCancelBtnValid = true;
     
     // Confirm button (V) on right
@@ -664,7 +588,88 @@ void drawColorPreview() {
                   previewConfirmBtnRight - previewConfirmBtnLeft,
                   previewConfirmBtnBottom - previewConfirmBtnTop,
                   COLOR_WHITE);
-    drawCenteredText("V", confirmCenterX, btnY, COLOR_WHITE, 3);
+    drawIcon(ICON_CHECK, confirmCenterX, btnY, btnSize, COLOR_WHITE);
     previewConfirmBtnValid = true;
   }
 }
+
+#if USE_INDEXED_CANVAS
+// Palette slots for the UI color and the two shades icons blend it into
+// against black. They are drawn by index only (beginUIColor), so a color
+// swap recolors the UI and nothing that merely shares its shade.
+static const uint8_t UI_SLOT_COUNT = 3;
+static uint8_t uiColorSlots[UI_SLOT_COUNT];
+#endif
+static uint16_t uiSlotColor = COLOR_BLACK;
+
+// --- Indexed canvas: reserve UI color slots and set up flushing (call before drawing anything) ---
+void initUIColorSlots(uint16_t color) {
+#if USE_INDEXED_CANVAS
+#if USE_ROW_HASH_FLUSH
+  canvas->setRowHashDiff(true);
+#endif
+  for (uint8_t i = 0; i < UI_SLOT_COUNT; i++) {
+    uiColorSlots[i] = canvas->reserveColorSlot(blendColor(color, COLOR_BLACK, UI_SLOT_COUNT - i, UI_SLOT_COUNT));
+  }
+#endif
+  uiSlotColor = color;
+}
+
+// --- Set the UI color; with the indexed canvas a palette edit of the slots ---
+void setUIColor(uint16_t color) {
+  if (color == uiSlotColor) return;
+#if USE_INDEXED_CANVAS
+  for (uint8_t i = 0; i < UI_SLOT_COUNT; i++) {
+    canvas->setIndexColor(uiColorSlots[i], blendColor(color, COLOR_BLACK, UI_SLOT_COUNT - i, UI_SLOT_COUNT));
+  }
+#endif
+  uiSlotColor = color;
+}
+
+// --- Start drawing in the UI color: returns what to pass as the color ---
+uint16_t beginUIColor() {
+#if USE_INDEXED_CANVAS
+  canvas->setDirectUseColorIndex(true);
+  return uiColorSlots[0];
+#else
+  return uiSlotColor;
+#endif
+}
+
+void endUIColor() {
+#if USE_INDEXED_CANVAS
+  canvas->setDirectUseColorIndex(false);
+#endif
+}
+
+// --- Icon in the UI color on black, edge shades from the slots as well ---
+void drawUIIcon(IconId id, int16_t cx, int16_t cy, int16_t size) {
+#if USE_INDEXED_CANVAS
+  uint16_t shades[4] = { canvas->get_color_index(COLOR_BLACK), uiColorSlots[2], uiColorSlots[1], uiColorSlots[0] };
+  canvas->setDirectUseColorIndex(true);
+  drawIconShades(id, cx, cy, size, shades);
+  canvas->setDirectUseColorIndex(false);
+#else
+  drawIcon(id, cx, cy, size, uiSlotColor);
+#endif
+}
+
+static volatile uint32_t framesDrawn = 0;
+
+// --- Indexed canvas: push pending changes to the panel ---
+void flushDisplay() {
+#if USE_INDEXED_CANVAS
+  // Sends only the areas drawn since the last call, then recolored slot pixels
+  bool drawn = canvas->isDirty();
+  canvas->flush();
+  if (drawn) framesDrawn++;
+  traceFrameDone(drawn);
+#else
+  framesDrawn++;
+  traceFrameDone(true);  // Drawing already went straight to the panel
+#endif
+}
+
+uint32_t displayFramesDrawn() {
+  return framesDrawn;
+}
@@ -5,6 +5,7 @@
 
 #include <Arduino.h>
 #include "pomodoro_config.h"
+#include "icons.h"
 
 // Drawing functions
 void drawSplash();
@@ -16,6 +17,20 @@ void drawPauseIcon(int16_t cx, int16_t cy, int16_t size, uint16_t color);
 void drawGearIcon(int16_t cx, int16_t cy, int16_t size, uint16_t color);
 void redrawGridCell(int row, int col, bool isSelected);
 
+// UI color. With the indexed canvas it lives in palette slots: drawing
+// between beginUIColor() and endUIColor() passes the returned value as the
+// color and lands in the slots, so setUIColor() recolors it without a
+// redraw. Other colors must not be drawn in between.
+void initUIColorSlots(uint16_t color);
+void setUIColor(uint16_t color);
+uint16_t beginUIColor();
+void endUIColor();
+void drawUIIcon(IconId id, int16_t cx, int16_t cy, int16_t size);  // Outside begin/endUIColor()
+
+// Indexed canvas support (no-ops when drawing straight to the panel)
+void flushDisplay();
+uint32_t displayFramesDrawn();  // Flushes that sent something, since boot
+
 // LCD initialization
 void lcd_reg_init(void);
 
@@ -7,7 +7,33 @@
 #include "timer_logic.h"
 #include "color_utils.h"
 #include <string.h>
-#include <math.h>
+#include "fixed_math.h"
+#include "profiler.h"
+#include "app_clock.h"
+#include "battery.h"
+
+// Last once-per-second timer redraw (running or paused)
+static uint64_t lastDisplayUpdate = 0;
+static uint8_t lastBatteryShown = BATTERY_UNKNOWN;
+
+// --- Helper: battery percentage in the top-right corner, when it changed ---
+static void drawBatteryLabel(bool force) {
+  uint8_t percent = batteryPercent();
+  if (percent == BATTERY_UNKNOWN || (percent == lastBatteryShown && !force)) return;
+  char text[5];
+  snprintf(text, sizeof(text), "%u%%", percent);
+  // Size 1 text: 6x8 per character, "100%" at most; clear of the rounded corner
+  int16_t cx = gfx->width() - 24;
+  int16_t cy = 12;
+  gfx->fillRect(cx - 12, cy - 4, 24, 8, COLOR_BLACK);
+  if (percent < BATTERY_LOW_PCT) {
+    drawCenteredText(text, cx, cy, COLOR_RED, 1);
+  } else {
+    drawCenteredText(text, cx, cy, beginUIColor(), 1);
+    endUIColor();
+  }
+  lastBatteryShown = percent;
+}
 
 void updateDisplay() {
   if (currentState == STOPPED) {
@@ -27,8 +53,7 @@ void updateDisplay() {
     return;
   } else {
     // Update display exactly once per second for smooth timer
-    static unsigned long lastDisplayUpdate = 0;
-    unsigned long now = millis();
+    uint64_t now = appMillis64();
     
     // Update every 1000ms (1 second) exactly
     if (now - lastDisplayUpdate >= 1000) {
@@ -38,10 +63,17 @@ void updateDisplay() {
   }
 }
 
+uint32_t msUntilNextFrame() {
+  if (currentState == STOPPED) return 0xFFFFFFFFUL;  // Only touch redraws, unscheduled
+  uint64_t since = appMillis64() - lastDisplayUpdate;
+  return (since >= 1000) ? 0 : (uint32_t)(1000 - since);
+}
+
 void drawTimer() {
+  PROFILE_SCOPE(PROF_DRAW_TIMER);
   unsigned long elapsed = 0;
   if (currentState == RUNNING) {
-    elapsed = millis() - startTime;
+    elapsed = (unsigned long)(appMillis64() - startTime);
   } else if (currentState == PAUSED) {
     elapsed = elapsedBeforePause;
   }
@@ -59,9 +91,8 @@ void drawTimer() {
     sprintf(timeStr, "%02lu:%02lu", minutes, seconds);  // MM:SS
   }
 
-  float progress = (float)elapsed / (float)duration;
-  if (progress < 0) progress = 0;
-  if (progress > 1) progress = 1;
+  // Progress as a Q16 fraction of a full turn (0..FX_ANGLE_TURN)
+  angle_q16_t progress = fx_fraction_q16(elapsed, duration);
   
   int centerX = gfx->width() / 2;
   int centerY = gfx->height() / 2;
@@ -70,8 +101,11 @@ void drawTimer() {
   // Check if we're in landscape mode (rotation 1 or 3)
   bool isLandscape = (currentRotation == 1 || currentRotation == 3);
   
-  // Get current UI color based on work/rest session
+  // Get current UI color based on work/rest session. Everything below draws
+  // in it through beginUIColor(), so with the indexed canvas a work/rest
+  // swap recolors via the palette slots
   uint16_t uiColor = getCurrentUIColor();
+  setUIColor(uiColor);
   
   // Only redraw everything on first call or if state changed
   if (!displayInitialized) {
@@ -80,7 +114,6 @@ void drawTimer() {
     displayInitialized = true;
     
     const char *statusTxt = nullptr;
-    uint16_t statusColor = uiColor;
     bool useIcon = false;  // Use icon for pause/start
     bool isPauseIcon = false;
     
@@ -133,22 +166,21 @@ void drawTimer() {
     }
 
     // Draw 1-pixel border around button
+    uint16_t pen = beginUIColor();
     gfx->drawRect(statusBtnLeft, statusBtnTop,
                   statusBtnRight - statusBtnLeft,
                   statusBtnBottom - statusBtnTop,
-                  statusColor);
+                  pen);
 
     // Draw icon or text centered inside the button
     int16_t btnCenterY = (statusBtnTop + statusBtnBottom) / 2;
     int16_t btnCenterX = (statusBtnLeft + statusBtnRight) / 2;
+    if (!useIcon) {
+      drawCenteredText(statusTxt, btnCenterX, btnCenterY, pen, 3);
+    }
+    endUIColor();
     if (useIcon) {
-      if (isPauseIcon) {
-        drawPauseIcon(btnCenterX, btnCenterY, iconSize, statusColor);
-      } else {
-        drawPlayIcon(btnCenterX, btnCenterY, iconSize, statusColor);
-      }
-    } else {
-      drawCenteredText(statusTxt, btnCenterX, btnCenterY, statusColor, 3);
+      drawUIIcon(isPauseIcon ? ICON_PAUSE : ICON_PLAY, btnCenterX, btnCenterY, iconSize);
     }
     statusBtnValid = true;
     lastDisplayedState = currentState;  // Initialize state tracking
@@ -187,24 +219,28 @@ void drawTimer() {
     }
     
     // Draw 1-pixel border around mode button
+    pen = beginUIColor();
     gfx->drawRect(modeBtnLeft, modeBtnTop,
                   modeBtnRight - modeBtnLeft,
                   modeBtnBottom - modeBtnTop,
-                  uiColor);
+                  pen);
     
     // Draw "M" text centered inside the button
     int16_t modeBtnCenterY = (modeBtnTop + modeBtnBottom) / 2;
     int16_t modeBtnCenterX = (modeBtnLeft + modeBtnRight) / 2;
-    drawCenteredText(modeTxt, modeBtnCenterX, modeBtnCenterY, uiColor, 3);
+    drawCenteredText(modeTxt, modeBtnCenterX, modeBtnCenterY, pen, 3);
+    endUIColor();
     
     modeBtnValid = true;
     lastDisplayedMode = currentMode;
     
     // Draw initial time text
     uint8_t textSize = showMinutesOnly ? 5 : 3;
-    drawCenteredText(timeStr, centerX, centerY, uiColor, textSize);
+    drawCenteredText(timeStr, centerX, centerY, beginUIColor(), textSize);
+    endUIColor();
     strcpy(lastTimeStr, timeStr);
     lastShowMinutesOnly = showMinutesOnly;
+    drawBatteryLabel(true);
   } else {
     // Update progress circle - update more frequently for smoother animation
     drawProgressCircle(progress, centerX, centerY, radius, uiColor);
@@ -222,7 +258,8 @@ void drawTimer() {
     
     // Draw new time with current UI color and appropriate size
     uint8_t textSize = showMinutesOnly ? 5 : 3;  // Larger text for MM only mode
-    drawCenteredText(timeStr, centerX, centerY, uiColor, textSize);
+    drawCenteredText(timeStr, centerX, centerY, beginUIColor(), textSize);
+    endUIColor();
     strcpy(lastTimeStr, timeStr);
     lastShowMinutesOnly = showMinutesOnly;
   }
@@ -231,7 +268,6 @@ void drawTimer() {
   if (currentState != lastDisplayedState) {
     // Determine new status and color
     const char *statusTxt = nullptr;
-    uint16_t statusColor = uiColor;  // Use current UI color (gold for work, blue for rest)
     bool useIcon = false;
     bool isPauseIcon = false;
     
@@ -292,22 +328,21 @@ void drawTimer() {
     }
 
     // Draw new border
+    uint16_t pen = beginUIColor();
     gfx->drawRect(statusBtnLeft, statusBtnTop,
                   statusBtnRight - statusBtnLeft,
                   statusBtnBottom - statusBtnTop,
-                  statusColor);
+                  pen);
 
     // Draw icon or text centered inside the button
     int16_t btnCenterY = (statusBtnTop + statusBtnBottom) / 2;
     int16_t btnCenterX = (statusBtnLeft + statusBtnRight) / 2;
+    if (!useIcon) {
+      drawCenteredText(statusTxt, btnCenterX, btnCenterY, pen, 3);
+    }
+    endUIColor();
     if (useIcon) {
-      if (isPauseIcon) {
-        drawPauseIcon(btnCenterX, btnCenterY, iconSize, statusColor);
-      } else {
-        drawPlayIcon(btnCenterX, btnCenterY, iconSize, statusColor);
-      }
-    } else {
-      drawCenteredText(statusTxt, btnCenterX, btnCenterY, statusColor, 3);
+      drawUIIcon(isPauseIcon ? ICON_PAUSE : ICON_PLAY, btnCenterX, btnCenterY, iconSize);
     }
     statusBtnValid = true;
     lastDisplayedState = currentState;
@@ -356,23 +391,28 @@ void drawTimer() {
     }
     
     // Draw new border
+    uint16_t pen = beginUIColor();
     gfx->drawRect(modeBtnLeft, modeBtnTop,
                   modeBtnRight - modeBtnLeft,
                   modeBtnBottom - modeBtnTop,
-                  uiColor);
+                  pen);
     
     // Draw "M" text centered inside the button
     int16_t modeBtnCenterY = (modeBtnTop + modeBtnBottom) / 2;
     int16_t modeBtnCenterX = (modeBtnLeft + modeBtnRight) / 2;
-    drawCenteredText(modeTxt, modeBtnCenterX, modeBtnCenterY, uiColor, 3);
+    drawCenteredText(modeTxt, modeBtnCenterX, modeBtnCenterY, pen, 3);
+    endUIColor();
     
     modeBtnValid = true;
     lastDisplayedMode = currentMode;
   }
+
+  drawBatteryLabel(false);
 }
 
-void drawProgressCircle(float progress, int centerX, int centerY, int radius, uint16_t color) {
-  static float lastProgress = -1.0f;
+void HOT_IRAM_ATTR drawProgressCircle(angle_q16_t progress, int centerX, int centerY, int radius, uint16_t color) {
+  PROFILE_SCOPE(PROF_PROGRESS_CIRCLE);
+  static angle_q16_t lastProgress = -1;
   static bool circleDrawn = false;
   static uint16_t lastColor = COLOR_GOLD;
   int borderWidth = 5;
@@ -380,58 +420,34 @@ void drawProgressCircle(float progress, int centerX, int centerY, int radius, ui
   // Force redraw on rotation change
   if (forceCircleRedraw) {
     circleDrawn = false;
-    lastProgress = -1.0f;
+    lastProgress = -1;
     forceCircleRedraw = false;
   }
   
   // Redraw full circle if color changed (work <-> rest transition)
   if (lastColor != color) {
     circleDrawn = false;
-    lastProgress = -1.0f;  // Force full redraw
+    lastProgress = -1;  // Force full redraw
     lastColor = color;
   }
   
   // Only redraw full circle on first call or if progress reset (timer restarted)
   if (!circleDrawn || progress < lastProgress || lastProgress < 0) {
     // Draw the full circle border with current color
-    for (int16_t i = 0; i < borderWidth; i++) {
-      gfx->drawCircle(centerX, centerY, radius - i, color);
-    }
+    gfx->fillRing(centerX, centerY, radius, radius - borderWidth + 1, beginUIColor());
+    endUIColor();
     circleDrawn = true;
     if (progress < lastProgress || lastProgress < 0) {
-      lastProgress = 0.0f;  // Reset on timer restart
+      lastProgress = 0;  // Reset on timer restart
     }
   }
   
   // Only erase the newly elapsed portion (smooth incremental update)
   if (progress > lastProgress && lastProgress >= 0) {
-    // Calculate how many new segments to erase
-    const int segments = 720;  // More segments for smoother progress (2 per degree)
-    int lastSegmentsErased = (int)(segments * lastProgress);
-    int currentSegmentsErased = (int)(segments * progress);
-    
-    // Erase only the newly elapsed portion to avoid flickering
-    for (int i = lastSegmentsErased; i < currentSegmentsErased; i++) {
-      float angle = (i * 2.0f * PI) / segments - PI / 2.0f;  // Start from top
-      // Erase all border layers
-      for (int thickness = 0; thickness < borderWidth; thickness++) {
-        int currentRadius = radius - thickness;
-        if (currentRadius < 0) continue;
-        
-        // Erase a small arc segment to catch all circle pixels
-        for (float angleOffset = -0.015f; angleOffset <= 0.015f; angleOffset += 0.005f) {
-          float currentAngle = angle + angleOffset;
-          int x = centerX + currentRadius * cosf(currentAngle);
-          int y = centerY + currentRadius * sinf(currentAngle);
-          gfx->drawPixel(x, y, COLOR_BLACK);
-          // Erase neighboring pixels to ensure complete erasure
-          gfx->drawPixel(x + 1, y, COLOR_BLACK);
-          gfx->drawPixel(x - 1, y, COLOR_BLACK);
-          gfx->drawPixel(x, y + 1, COLOR_BLACK);
-          gfx->drawPixel(x, y - 1, COLOR_BLACK);
-        }
-      }
-    }
+    // Erase the elapsed sweep with the same radii as the ring, starting from top
+    gfx->fillArcQ16(centerX, centerY, radius, radius - borderWidth + 1,
+                    lastProgress - FX_ANGLE_QUARTER, progress - FX_ANGLE_QUARTER,
+                    COLOR_BLACK);
   }
   
   lastProgress = progress;
@@ -440,3 +456,25 @@ void drawProgressCircle(float progress, int centerX, int centerY, int radius, ui
 void displayStoppedState() {
   drawSplash();
 }
+
+void redrawCurrentView() {
+  displayInitialized = false;
+  forceCircleRedraw = true;  // Reset progress circle state
+  memset(lastTimeStr, 0, sizeof(lastTimeStr));
+
+  // Redraw current screen based on current view mode
+  if (currentViewMode == 2) {
+    // Color preview screen - just redraw it
+    drawColorPreview();
+  } else if (currentState == STOPPED && currentViewMode == 0) {
+    // Home screen
+    drawSplash();
+  } else if (currentViewMode == 1 || gridViewActive) {
+    // Grid/palette view
+    drawGrid();
+  } else {
+    // Timer screen
+    gfx->fillScreen(COLOR_BLACK);
+    drawTimer();
+  }
+}
@@ -4,11 +4,17 @@
 #define DISPLAY_UPDATES_H
 
 #include <Arduino.h>
+#include "fixed_math.h"
 
 // Display update functions
 void updateDisplay();
 void drawTimer();
-void drawProgressCircle(float progress, int centerX, int centerY, int radius, uint16_t color);
+void drawProgressCircle(angle_q16_t progress, int centerX, int centerY, int radius, uint16_t color);  // Ring in the UI color; color is that color, to notice a swap
 void displayStoppedState();
+void redrawCurrentView();  // Whole screen for the current view mode and state
+
+// Time until updateDisplay() next draws on its own, for scheduling other SPI
+// traffic between frames. 0xFFFFFFFF when nothing is scheduled (stopped).
+uint32_t msUntilNextFrame();
 
 #endif // DISPLAY_UPDATES_H
@@ -0,0 +1,171 @@
+// HTTP API implementation
+
+#include "http_api.h"
+
+#if HTTP_API
+
+#include "http_server.h"
+#include "pomodoro_globals.h"
+#include "timer_logic.h"
+#include "session_log.h"
+#include "remote_commands.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "backlight.h"
+#include "mem_telemetry.h"
+#include "deferred_log.h"
+#include <WiFi.h>
+#include <strings.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+struct HttpState {
+  uint8_t state;          // TimerState
+  uint8_t work;
+  uint8_t mode;           // PomodoroMode
+  uint8_t battery;        // Percent, BATTERY_UNKNOWN before a reading
+  uint32_t remainingS;
+  uint32_t durationS;
+  uint32_t focusTodayS;
+  uint16_t sessionsToday;
+};
+
+static HttpServer server;
+static QueueHandle_t stateQueue = nullptr;  // Loop -> server task, newest snapshot only
+static HttpState current;                   // Server task's copy
+static HttpState lastPublished;             // Loop's copy
+static uint32_t startedAt = 0;
+
+// --- Helper: snapshot as a JSON object ---
+static int formatState(char* out, size_t size, const HttpState& s) {
+  static const char* const stateNames[] = { "stopped", "running", "paused" };
+  static const char* const modeNames[] = { "1/1", "25/5", "50/10" };
+  char battery[5] = "null";
+  if (s.battery != BATTERY_UNKNOWN) snprintf(battery, sizeof(battery), "%u", s.battery);
+  return snprintf(out, size,
+                  "{\"state\":\"%s\",\"session\":\"%s\",\"mode\":\"%s\",\"remaining_s\":%lu,\"duration_s\":%lu,"
+                  "\"focus_today_s\":%lu,\"sessions_today\":%u,\"battery_pct\":%s}",
+                  stateNames[s.state], s.work ? "work" : "rest", modeNames[s.mode], (unsigned long)s.remainingS,
+                  (unsigned long)s.durationS, (unsigned long)s.focusTodayS, s.sessionsToday, battery);
+}
+
+// --- Helper: run the command named in a POST /cmd body, {"cmd":"..."}, copied to word ---
+static bool runCommand(const char* body, size_t len, char* word, size_t size) {
+  word[0] = '\0';
+  const char* end = body + len;
+  const char* key = (const char*)memmem(body, len, "\"cmd\"", 5);
+  if (key == nullptr) return false;
+  const char* p = (const char*)memchr(key + 5, '"', end - (key + 5));
+  if (p == nullptr) return false;
+  p++;
+  size_t n = 0;
+  while (p < end && n < size - 1 && *p >= 'a' && *p <= 'z') word[n++] = *p++;
+  word[n] = '\0';
+  if (!queueRemoteCommand(word)) return false;
+  LOG(LOG_HTTP_COMMAND, word);
+  return true;
+}
+
+static void handleRequest(const HttpRequest& req, HttpResponse& res) {
+  bool get = strcmp(req.method, "GET") == 0;
+  bool post = strcmp(req.method, "POST") == 0;
+
+  if (strcmp(req.path, "/state") == 0) {
+    res.status = get ? 200 : 405;
+    if (get) res.bodyLen = formatState(res.body, res.bodyMax, current);
+  } else if (strcmp(req.path, "/cmd") == 0) {
+    // Unauthenticated, so no CORS, and JSON only: a cross-site page can
+    // only send that after a preflight, which this server never grants
+    res.cors = false;
+    bool json = strncasecmp(req.contentType, "application/json", 16) == 0;
+    char cmd[16] = "";
+    bool ok = post && json && runCommand(req.body, req.bodyLen, cmd, sizeof(cmd));
+    res.status = !post ? 405 : !json ? 415 : ok ? 202 : 400;
+    res.bodyLen = snprintf(res.body, res.bodyMax, ok ? "{\"ok\":true,\"cmd\":\"%s\"}" : "{\"ok\":false}", cmd);
+  } else if (strcmp(req.path, "/events") == 0) {
+    res.status = get ? 200 : 405;
+    res.contentType = "text/event-stream";
+    res.stream = get;
+    if (get) res.bodyLen = snprintf(res.body, res.bodyMax, "retry: 2000\n\n");
+  } else if (strcmp(req.path, "/metrics") == 0) {
+    const HttpServerStats& st = server.stats();
+    uint32_t seconds = (millis() - startedAt) / 1000;
+    res.status = get ? 200 : 405;
+    res.contentType = "text/plain";
+    if (get) {
+      res.bodyLen = snprintf(res.body, res.bodyMax,
+                             "requests %lu\nrequests_per_s %lu\nrejected %lu\nstreams %u\nevents %lu\n"
+                             "deliveries %lu\nskipped %lu\nfanout_last_us %lu\nfanout_max_us %lu\n"
+                             "battery_mv %u\nbattery_sample_us_per_s %lu\nbacklight_pct %u\nbacklight_avg_ma_x10 %lu\n",
+                             (unsigned long)st.requests, (unsigned long)(seconds ? st.requests / seconds : st.requests),
+                             (unsigned long)st.rejected, server.streams(), (unsigned long)st.events,
+                             (unsigned long)st.deliveries, (unsigned long)st.skipped,
+                             (unsigned long)st.lastFanOutUs, (unsigned long)st.maxFanOutUs,
+                             batteryMillivolts(), (unsigned long)batteryCpuUsPerS(), backlightPercent(),
+                             (unsigned long)backlightAverageMa10());
+    }
+  } else if (strcmp(req.path, "/perf") == 0) {
+    res.status = get ? 200 : 405;
+    res.contentType = "text/plain";
+    if (get) res.bodyLen = memReport(res.body, res.bodyMax);
+  } else {
+    res.bodyLen = snprintf(res.body, res.bodyMax, "{\"error\":\"not found\"}");
+  }
+  if (res.bodyLen > res.bodyMax) res.bodyLen = 0;  // snprintf cut it
+}
+
+static void httpTask(void* parameter) {
+  if (!server.begin(HTTP_PORT, handleRequest)) {
+    LOG(LOG_HTTP_FAILED, (uint32_t)HTTP_PORT);
+    vTaskDelete(nullptr);
+    return;
+  }
+  startedAt = millis();
+  LOG(LOG_HTTP_STARTED, (uint32_t)HTTP_PORT);
+
+  while (true) {
+    HttpState s;
+    if (xQueueReceive(stateQueue, &s, 0) == pdTRUE) {
+      current = s;
+      char event[HTTP_EVENT_MAX];
+      int len = snprintf(event, sizeof(event), "event: state\ndata: ");
+      len += formatState(event + len, sizeof(event) - len, current);
+      len += snprintf(event + len, sizeof(event) - len, "\n\n");
+      if (len < (int)sizeof(event)) server.publish(event, len);
+    }
+    server.poll(HTTP_POLL_MS);
+  }
+}
+
+void startHttpApi() {
+  if (WiFi.status() != WL_CONNECTED) return;
+  stateQueue = xQueueCreate(1, sizeof(HttpState));
+  memset(&lastPublished, 0xFF, sizeof(lastPublished));  // First publish always differs
+  publishHttpState();
+  xTaskCreatePinnedToCore(httpTask, "HttpTask", 4096, NULL, 1, NULL, 0);
+  Serial.println("HTTP API task created on port " + String(HTTP_PORT));
+}
+
+void publishHttpState() {
+  if (stateQueue == nullptr) return;
+  HttpState s = lastPublished;
+  unsigned long duration = getCurrentDuration();
+  unsigned long elapsed = (currentState == RUNNING) ? (unsigned long)(appMillis64() - startTime)
+                        : (currentState == PAUSED) ? elapsedBeforePause : 0;
+  s.state = currentState;
+  s.work = isWorkSession;
+  s.mode = currentMode;
+  s.battery = batteryPercent();
+  s.remainingS = (elapsed < duration) ? (duration - elapsed + 999) / 1000 : 0;
+  s.durationS = duration / 1000;
+  if (memcmp(&s, &lastPublished, sizeof(s)) == 0) return;
+
+  // Focus totals only move when a session ends, which changes the above too
+  s.focusTodayS = focusSecondsToday();
+  s.sessionsToday = workSessionsToday();
+  lastPublished = s;
+  xQueueOverwrite(stateQueue, &s);
+}
+
+#endif // HTTP_API
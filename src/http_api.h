@@ -0,0 +1,36 @@
+// HTTP API on the local network
+//
+//   GET  /state    JSON snapshot of the timer
+//   POST /cmd      {"cmd":"start"} (or "pause", "resume", "stop", "mode")
+//                  as Content-Type: application/json, which browsers only
+//                  send cross-site after a CORS preflight; runs like the
+//                  Telegram commands. No CORS header, unlike the rest.
+//   GET  /events   Server-Sent Events: a "state" event whenever the state
+//                  or the remaining second changes
+//   GET  /perf     Heap, fragmentation and stack headroom (mem_telemetry.h)
+//   GET  /metrics  Request, event and fan-out latency counters, battery
+//                  voltage and the CPU time its sampling takes, backlight
+//                  level and estimated mean current
+//
+// The server runs in its own task (http_server.h). The loop hands it a new
+// snapshot through a one-slot queue; commands come back through the same
+// flags as Telegram commands, so no timer state is touched off the loop.
+
+#ifndef HTTP_API_H
+#define HTTP_API_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+#if HTTP_API
+// Start the server task once WiFi is up
+void startHttpApi();
+
+// Loop side: publish the timer state when it changed
+void publishHttpState();
+#else
+inline void startHttpApi() {}
+inline void publishHttpState() {}
+#endif
+
+#endif // HTTP_API_H
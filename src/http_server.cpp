@@ -0,0 +1,377 @@
+// Non-blocking HTTP/1.1 server implementation
+
+#include "http_server.h"
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+static uint32_t httpMillis() { return millis(); }
+static uint32_t httpMicros() { return micros(); }
+#else
+#include <time.h>
+static uint32_t httpMicros() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+static uint32_t httpMillis() { return httpMicros() / 1000; }
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// --- Helper: reason phrase ---
+static const char* httpReason(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 202: return "Accepted";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 415: return "Unsupported Media Type";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+  }
+}
+
+// --- Helper: value of a request header, or nullptr (head is NUL-terminated) ---
+static const char* httpHeader(const char* head, const char* name) {
+  size_t nameLen = strlen(name);
+  for (const char* line = strstr(head, "\r\n"); line != nullptr; line = strstr(line, "\r\n")) {
+    line += 2;
+    if (strncasecmp(line, name, nameLen) == 0 && line[nameLen] == ':') {
+      const char* value = line + nameLen + 1;
+      while (*value == ' ') value++;
+      return value;
+    }
+  }
+  return nullptr;
+}
+
+// --- Helper: Content-Length value as a body size that fits limit ---
+// 0 when it does, 400 when it is not a decimal number, 413 when it is too
+// large. Digits stop counting once past limit, so no value can overflow.
+static int httpContentLength(const char* value, size_t limit, size_t& len) {
+  const char* end = value;
+  len = 0;
+  while (*end >= '0' && *end <= '9') {
+    if (len <= limit) len = len * 10 + (*end - '0');
+    end++;
+  }
+  while (*end == ' ') end++;
+  if (end == value || (*end != '\r' && *end != '\0')) return 400;
+  return (len > limit) ? 413 : 0;
+}
+
+static void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+bool HttpServer::begin(uint16_t port, HttpHandler handler) {
+  this->handler = handler;
+  for (Connection& c : connections) c.fd = -1;
+
+  listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenFd < 0) return false;
+  int one = 1;
+  setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, HTTP_MAX_CLIENTS) < 0) {
+    close(listenFd);
+    listenFd = -1;
+    return false;
+  }
+  setNonBlocking(listenFd);
+  return true;
+}
+
+uint8_t HttpServer::streams() const {
+  uint8_t n = 0;
+  for (const Connection& c : connections) {
+    if (c.fd >= 0 && c.stream) n++;
+  }
+  return n;
+}
+
+void HttpServer::poll(uint32_t timeoutMs) {
+  if (listenFd < 0) return;
+
+  fd_set readable, writable;
+  FD_ZERO(&readable);
+  FD_ZERO(&writable);
+  FD_SET(listenFd, &readable);
+  int maxFd = listenFd;
+  for (Connection& c : connections) {
+    if (c.fd < 0) continue;
+    FD_SET(c.fd, &readable);
+    if (c.outPos < c.outLen) FD_SET(c.fd, &writable);
+    if (c.fd > maxFd) maxFd = c.fd;
+  }
+  timeval tv = { (time_t)(timeoutMs / 1000), (suseconds_t)((timeoutMs % 1000) * 1000) };
+  if (select(maxFd + 1, &readable, &writable, nullptr, &tv) > 0) {
+    if (FD_ISSET(listenFd, &readable)) acceptClient();
+    for (Connection& c : connections) {
+      if (c.fd >= 0 && FD_ISSET(c.fd, &writable)) flush(c);
+      if (c.fd >= 0 && FD_ISSET(c.fd, &readable)) receive(c);
+    }
+  }
+  // Pipelined requests behind a response just written, or past the last round's limit
+  for (Connection& c : connections) {
+    if (c.fd >= 0 && !c.stream && c.outLen == 0 && c.inLen > 0) serveBuffered(c);
+  }
+
+  uint32_t now = httpMillis();
+  for (Connection& c : connections) {
+    if (c.fd < 0) continue;
+    if (c.stream) {
+      if (c.outLen == 0 && now - c.lastActive >= HTTP_SSE_PING_MS) {
+        c.lastActive = now;
+        reply(c, 0, nullptr, ": ping\n\n", 8);
+      }
+      queueEvent(c);
+    } else if (c.outLen == 0 && now - c.lastActive >= HTTP_IDLE_MS) {
+      closeConnection(c);
+    }
+  }
+}
+
+void HttpServer::publish(const char* data, size_t len) {
+  if (len > sizeof(event)) return;
+  memcpy(event, data, len);
+  eventLen = len;
+  eventSeq++;
+  eventAtUs = httpMicros();
+  eventWaiting = 0;
+  counters.events++;
+  for (Connection& c : connections) {
+    if (c.fd < 0 || !c.stream) continue;
+    c.awaited = true;
+    eventWaiting++;
+  }
+  // Streams with a free buffer get it now, the rest when theirs drains
+  for (Connection& c : connections) {
+    if (c.fd >= 0 && c.stream) queueEvent(c);
+  }
+}
+
+void HttpServer::acceptClient() {
+  int fd = accept(listenFd, nullptr, nullptr);
+  if (fd < 0) return;
+  for (Connection& c : connections) {
+    if (c.fd >= 0) continue;
+    setNonBlocking(fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));  // Events are small writes
+    c.fd = fd;
+    c.stream = false;
+    c.closeAfter = false;
+    c.inLen = 0;
+    c.outPos = 0;
+    c.outLen = 0;
+    c.lastActive = httpMillis();
+    c.eventSeq = 0;
+    c.awaited = false;
+    return;
+  }
+  static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+  send(fd, busy, sizeof(busy) - 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+  close(fd);
+  counters.rejected++;
+}
+
+void HttpServer::closeConnection(Connection& c) {
+  if (c.awaited) streamCaughtUp(c);  // Not worth waiting for any more
+  close(c.fd);
+  c.fd = -1;
+}
+
+void HttpServer::receive(Connection& c) {
+  if (c.inLen == sizeof(c.in)) return;  // Pipelined requests wait for the current response
+  int n = recv(c.fd, c.in + c.inLen, sizeof(c.in) - c.inLen, 0);
+  if (n <= 0) {
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) closeConnection(c);
+    return;
+  }
+  c.lastActive = httpMillis();
+  if (c.stream) return;  // Nothing more is expected from a stream
+  c.inLen += n;
+  serveBuffered(c);
+}
+
+// --- The complete requests in c.in, answered in order ---
+// A flat loop, never reentered from flush(), so a packet full of pipelined
+// requests costs no stack. Stops at a response still being written; poll()
+// comes back once it is out.
+void HttpServer::serveBuffered(Connection& c) {
+  bool more = true;
+  for (uint8_t i = 0; more && i < HTTP_PIPELINE_MAX; i++) more = serveRequest(c);
+  if (!more && c.fd >= 0 && !c.stream && !c.closeAfter && c.inLen == sizeof(c.in) && c.outLen == 0) {
+    counters.rejected++;  // Full, and still no complete request
+    c.closeAfter = true;
+    reply(c, 413, "text/plain", "", 0);
+  }
+}
+
+// --- One complete request from c.in, answered into c.out ---
+// False when there is none yet, or the connection takes no more requests.
+bool HttpServer::serveRequest(Connection& c) {
+  if (c.fd < 0 || c.outLen > 0 || c.closeAfter || c.stream) return false;  // One response at a time
+
+  // Head ends at the blank line; check without running past inLen
+  size_t headEnd = 0;
+  for (size_t i = 3; i < c.inLen; i++) {
+    if (c.in[i - 3] == '\r' && c.in[i - 2] == '\n' && c.in[i - 1] == '\r' && c.in[i] == '\n') {
+      headEnd = i - 3;
+      break;
+    }
+  }
+  if (headEnd == 0) return false;
+  c.in[headEnd] = '\0';
+
+  // Checked against the room left before anything is added to it
+  const char* lengthValue = httpHeader(c.in, "Content-Length");
+  size_t bodyLen = 0;
+  int lengthStatus = lengthValue ? httpContentLength(lengthValue, sizeof(c.in) - headEnd - 4, bodyLen) : 0;
+  if (lengthStatus != 0) {
+    counters.rejected++;
+    c.closeAfter = true;
+    reply(c, lengthStatus, "text/plain", "", 0);
+    return false;
+  }
+  size_t total = headEnd + 4 + bodyLen;
+  if (c.inLen < total) {
+    c.in[headEnd] = '\r';  // Restore for the next look
+    return false;
+  }
+  const char* connection = httpHeader(c.in, "Connection");
+  if (connection && strncasecmp(connection, "close", 5) == 0) c.closeAfter = true;
+  const char* contentType = httpHeader(c.in, "Content-Type");  // Before the split below ends the search
+
+  // "METHOD /path?query HTTP/1.1", split in place
+  HttpRequest req;
+  char* method = c.in;
+  char* target = strchr(method, ' ');
+  char* version = target ? strchr(target + 1, ' ') : nullptr;
+  if (version == nullptr || target[1] != '/') {
+    counters.rejected++;
+    c.closeAfter = true;
+    reply(c, 400, "text/plain", "", 0);
+    return false;
+  }
+  *target++ = '\0';
+  *version = '\0';
+  char* query = strchr(target, '?');
+  if (query) *query++ = '\0';
+  req.method = method;
+  req.path = target;
+  req.query = query ? query : "";
+  req.contentType = contentType ? contentType : "";
+  req.body = c.in + headEnd + 4;
+  req.bodyLen = bodyLen;
+
+  HttpResponse res = { 404, "application/json", scratch, sizeof(scratch), 0, false, true };
+  handler(req, res);
+  counters.requests++;
+
+  if (res.stream && streams() >= HTTP_MAX_CLIENTS - 1) {
+    // Keep a connection free for plain requests
+    res = { 503, "text/plain", scratch, sizeof(scratch), 0, false, true };
+    counters.rejected++;
+    c.closeAfter = true;
+  }
+
+  // Later pipelined requests stay in the buffer until this one is written
+  c.inLen -= total;
+  memmove(c.in, c.in + total, c.inLen);
+
+  if (res.stream) {
+    c.stream = true;
+    c.inLen = 0;
+    c.eventSeq = (eventSeq > 0) ? eventSeq - 1 : 0;  // Start with the newest event, if there is one
+    reply(c, res.status, res.contentType, res.body, res.bodyLen, res.cors);
+    return false;
+  }
+  reply(c, res.status, res.contentType, res.body, res.bodyLen, res.cors);
+  return c.outLen == 0 && !c.closeAfter;
+}
+
+// --- Helper: headers and body into c.out (status 0: raw stream data) ---
+void HttpServer::reply(Connection& c, int status, const char* contentType, const char* body, size_t bodyLen,
+                       bool cors) {
+  int len = 0;
+  if (status > 0) {
+    len = snprintf(c.out, sizeof(c.out), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n%s", status, httpReason(status),
+                   contentType, cors ? "Access-Control-Allow-Origin: *\r\n" : "");
+    if (c.stream) {
+      len += snprintf(c.out + len, sizeof(c.out) - len, "Cache-Control: no-cache\r\n\r\n");
+    } else {
+      len += snprintf(c.out + len, sizeof(c.out) - len, "Content-Length: %u\r\nConnection: %s\r\n\r\n",
+                      (unsigned)bodyLen, c.closeAfter ? "close" : "keep-alive");
+    }
+  }
+  if (len < 0 || len + bodyLen > sizeof(c.out)) {
+    static const char tooLarge[] = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    memcpy(c.out, tooLarge, sizeof(tooLarge) - 1);
+    len = sizeof(tooLarge) - 1;
+    bodyLen = 0;
+    c.stream = false;
+    c.closeAfter = true;
+  }
+  memcpy(c.out + len, body, bodyLen);
+  c.outPos = 0;
+  c.outLen = len + bodyLen;
+  flush(c);
+}
+
+void HttpServer::flush(Connection& c) {
+  while (c.outPos < c.outLen) {
+    int n = send(c.fd, c.out + c.outPos, c.outLen - c.outPos, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) closeConnection(c);
+      return;  // select() says when to go on
+    }
+    c.outPos += n;
+  }
+  c.outPos = 0;
+  c.outLen = 0;
+  if (c.closeAfter) {
+    closeConnection(c);
+  } else if (c.stream && c.awaited && c.eventSeq == eventSeq) {
+    streamCaughtUp(c);
+  }
+  // The next event or pipelined request is poll()'s to start, not this call's
+}
+
+// --- Helper: the newest event into a stream's free buffer ---
+void HttpServer::queueEvent(Connection& c) {
+  if (c.fd < 0 || c.outLen > 0 || c.eventSeq == eventSeq || eventLen == 0) return;
+  if (c.eventSeq != 0) counters.skipped += eventSeq - c.eventSeq - 1;
+  c.eventSeq = eventSeq;
+  counters.deliveries++;
+  reply(c, 0, nullptr, event, eventLen);
+}
+
+// --- Helper: a stream has written the newest event (or closed) ---
+void HttpServer::streamCaughtUp(Connection& c) {
+  c.awaited = false;
+  if (eventWaiting > 0 && --eventWaiting == 0) {
+    counters.lastFanOutUs = httpMicros() - eventAtUs;
+    if (counters.lastFanOutUs > counters.maxFanOutUs) counters.maxFanOutUs = counters.lastFanOutUs;
+  }
+}
@@ -0,0 +1,98 @@
+// Small non-blocking HTTP/1.1 server with Server-Sent Events
+//
+// One select() loop over a fixed pool of connections, each with its own
+// request and response buffer, so memory does not grow with traffic or
+// with slow clients. Only POSIX sockets are used (lwIP on the device), so
+// the same code builds and runs on a host. A request goes to the handler
+// once its head and body are in; keep-alive and pipelined requests are
+// answered in order. A handler can turn its connection into an event
+// stream, which then gets what publish() is given. Events are whole
+// snapshots: a stream that cannot keep up skips to the newest one instead
+// of queueing.
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pomodoro_config.h"
+
+struct HttpRequest {
+  const char* method;
+  const char* path;      // Without the query
+  const char* query;     // After '?', "" if none
+  const char* contentType;  // Content-Type value up to its CR, "" if none
+  const char* body;      // bodyLen bytes, not NUL-terminated
+  size_t bodyLen;
+};
+
+struct HttpResponse {
+  int status;
+  const char* contentType;
+  char* body;            // bodyMax bytes for the handler to fill
+  size_t bodyMax;
+  size_t bodyLen;
+  bool stream;           // Keep the connection open as an event stream
+  bool cors;             // Send Access-Control-Allow-Origin: * (readable by any page)
+};
+
+typedef void (*HttpHandler)(const HttpRequest& req, HttpResponse& res);
+
+struct HttpServerStats {
+  uint32_t requests;
+  uint32_t rejected;      // No free connection, too large or malformed
+  uint32_t events;        // publish() calls
+  uint32_t deliveries;    // Events handed to a stream
+  uint32_t skipped;       // Events a slow stream never got
+  uint32_t lastFanOutUs;  // publish() until the last stream had the event
+  uint32_t maxFanOutUs;
+};
+
+class HttpServer {
+ public:
+  bool begin(uint16_t port, HttpHandler handler);
+  void poll(uint32_t timeoutMs);                 // One select() round
+  void publish(const char* event, size_t len);   // "event: ...\ndata: ...\n\n"
+  uint8_t streams() const;
+  const HttpServerStats& stats() const { return counters; }
+
+ private:
+  struct Connection {
+    int fd;               // -1 = free
+    bool stream;
+    bool closeAfter;      // Close once the response is written
+    uint16_t inLen;
+    uint16_t outPos;
+    uint16_t outLen;
+    uint32_t lastActive;  // ms
+    uint32_t eventSeq;    // Newest event put in out, 0 = none yet
+    bool awaited;         // Counted in eventWaiting
+    char in[HTTP_REQUEST_MAX];
+    char out[HTTP_RESPONSE_MAX];
+  };
+
+  void acceptClient();
+  void closeConnection(Connection& c);
+  void receive(Connection& c);
+  void serveBuffered(Connection& c);
+  bool serveRequest(Connection& c);
+  void reply(Connection& c, int status, const char* contentType, const char* body, size_t bodyLen,
+             bool cors = true);
+  void flush(Connection& c);
+  void queueEvent(Connection& c);
+  void streamCaughtUp(Connection& c);
+
+  int listenFd = -1;
+  HttpHandler handler = nullptr;
+  Connection connections[HTTP_MAX_CLIENTS];
+  char scratch[HTTP_RESPONSE_MAX];  // Handler body, copied into the connection
+
+  char event[HTTP_EVENT_MAX];
+  size_t eventLen = 0;
+  uint32_t eventSeq = 0;
+  uint32_t eventAtUs = 0;
+  uint8_t eventWaiting = 0;         // Streams still writing the newest event
+  HttpServerStats counters = {};
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,59 @@
+// Pre-rasterized UI icons implementation
+
+#include "icons.h"
+#include "pomodoro_globals.h"
+#include "color_utils.h"
+#include "icons_data.h"
+
+// Scratch buffer for one colorized icon (largest mask in the set)
+static uint16_t iconPixels[ICON_MAX_DIM * ICON_MAX_DIM];
+
+static const int iconMaskCount = sizeof(iconMasks) / sizeof(iconMasks[0]);
+
+// Pick the largest mask of this icon that fits, or the smallest if none do
+static const IconMask *findIconMask(IconId id, int16_t size) {
+  const IconMask *best = nullptr;
+  const IconMask *smallest = nullptr;
+  for (int i = 0; i < iconMaskCount; i++) {
+    const IconMask *m = &iconMasks[i];
+    if (m->id != id) continue;
+    if (!smallest || m->width < smallest->width) smallest = m;
+    if (m->width <= size && (!best || m->width > best->width)) best = m;
+  }
+  return best ? best : smallest;
+}
+
+void drawIcon(IconId id, int16_t cx, int16_t cy, int16_t size, uint16_t fg,
+              uint16_t bg, bool antialias) {
+  // Four possible output colors, resolved once per draw
+  uint16_t shades[4];
+  if (antialias) {
+    shades[0] = bg;
+    shades[1] = blendColor(fg, bg, 1, 3);
+    shades[2] = blendColor(fg, bg, 2, 3);
+    shades[3] = fg;
+  } else {
+    shades[0] = shades[1] = bg;
+    shades[2] = shades[3] = fg;
+  }
+  drawIconShades(id, cx, cy, size, shades);
+}
+
+void drawIconShades(IconId id, int16_t cx, int16_t cy, int16_t size, const uint16_t shades[4]) {
+  const IconMask *m = findIconMask(id, size);
+  if (!m) return;
+
+  int16_t w = m->width;
+  int16_t h = m->height;
+  int16_t stride = (w + 3) / 4;
+  uint16_t *out = iconPixels;
+  for (int16_t y = 0; y < h; y++) {
+    const uint8_t *row = m->alpha + y * stride;
+    for (int16_t x = 0; x < w; x++) {
+      uint8_t a = (pgm_read_byte(&row[x >> 2]) >> (6 - ((x & 3) << 1))) & 0x03;
+      *out++ = shades[a];
+    }
+  }
+
+  gfx->draw16bitRGBBitmap(cx - w / 2, cy - h / 2, iconPixels, w, h);
+}
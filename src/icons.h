@@ -0,0 +1,39 @@
+// Pre-rasterized UI icons (gear, play, pause, check, cross)
+
+#ifndef ICONS_H
+#define ICONS_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+// Icon identifiers; each may have several pre-rendered sizes
+enum IconId {
+  ICON_GEAR,
+  ICON_PLAY,
+  ICON_PAUSE,
+  ICON_CHECK,
+  ICON_CROSS
+};
+
+// One size of one icon: 2-bpp alpha, 4 pixels per byte (MSB first),
+// every row padded to a whole byte. Generated by tools/gen_icons.py.
+struct IconMask {
+  IconId id;
+  uint8_t width;
+  uint8_t height;
+  const uint8_t *alpha;
+};
+
+// Draw an icon centered on (cx, cy) as a single blit into one address window.
+// Uses the largest pre-rendered size that fits in `size` (or the smallest one).
+// With antialias the edge pixels are blended against `bg`, otherwise the mask
+// is thresholded to fg/bg.
+void drawIcon(IconId id, int16_t cx, int16_t cy, int16_t size, uint16_t fg,
+              uint16_t bg = COLOR_BLACK, bool antialias = true);
+
+// Same, with the four output values given: shades[a] for mask alpha a
+// (0 = background .. 3 = foreground). Lets the indexed canvas take palette
+// indexes instead of colors.
+void drawIconShades(IconId id, int16_t cx, int16_t cy, int16_t size, const uint16_t shades[4]);
+
+#endif // ICONS_H
@@ -0,0 +1,137 @@
+// Generated by tools/gen_icons.py - do not edit by hand
+
+#ifndef ICONS_DATA_H
+#define ICONS_DATA_H
+
+#include <Arduino.h>
+
+// gear 36x36, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_gear_36[324] PROGMEM = {
+  0x00, 0x00, 0x00, 0x01, 0xAA, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xC0, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF,
+  0xC0, 0x00, 0x00, 0x00, 0x00, 0x07, 0x80, 0x03, 0xFF, 0xC0, 0x02, 0xD0, 0x00, 0x00, 0x1F, 0xE0,
+  0x03, 0xFF, 0xC0, 0x0B, 0xF4, 0x00, 0x00, 0x7F, 0xF8, 0x6F, 0xFF, 0xF9, 0x2F, 0xFD, 0x00, 0x00,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xBF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+  0x00, 0x00, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF8, 0x00, 0x00, 0x0B, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xE0, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0x00, 0x07, 0xFF, 0xFE,
+  0x41, 0xBF, 0xFF, 0xD0, 0x00, 0x00, 0x0B, 0xFF, 0xF4, 0x00, 0x1F, 0xFF, 0xE0, 0x00, 0x00, 0x0F,
+  0xFF, 0xD0, 0x00, 0x07, 0xFF, 0xF0, 0x00, 0x7F, 0xFF, 0xFF, 0x80, 0x00, 0x02, 0xFF, 0xFF, 0xFD,
+  0xBF, 0xFF, 0xFF, 0x40, 0x00, 0x01, 0xFF, 0xFF, 0xFE, 0xBF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFF,
+  0xFF, 0xFE, 0xBF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFE, 0xBF, 0xFF, 0xFF, 0x40, 0x00,
+  0x01, 0xFF, 0xFF, 0xFE, 0x7F, 0xFF, 0xFF, 0x80, 0x00, 0x02, 0xFF, 0xFF, 0xFD, 0x00, 0x0F, 0xFF,
+  0xD0, 0x00, 0x07, 0xFF, 0xF0, 0x00, 0x00, 0x0B, 0xFF, 0xF4, 0x00, 0x1F, 0xFF, 0xE0, 0x00, 0x00,
+  0x07, 0xFF, 0xFE, 0x41, 0xBF, 0xFF, 0xD0, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0,
+  0x00, 0x00, 0x0B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xF8, 0x00, 0x00, 0xBF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x7F, 0xF8, 0x6F, 0xFF, 0xF9, 0x2F, 0xFD, 0x00, 0x00, 0x1F,
+  0xE0, 0x03, 0xFF, 0xC0, 0x0B, 0xF4, 0x00, 0x00, 0x07, 0x80, 0x03, 0xFF, 0xC0, 0x02, 0xD0, 0x00,
+  0x00, 0x00, 0x00, 0x03, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xC0, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xAA,
+  0x40, 0x00, 0x00, 0x00,
+};
+
+// play 24x24, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_play_24[144] PROGMEM = {
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xD0, 0x00, 0x00, 0x00, 0x00, 0x03, 0xF8, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x03, 0xFF,
+  0xFD, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0xF4, 0x00, 0x00,
+  0x03, 0xFF, 0xFF, 0xFE, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xD0, 0x00, 0x03, 0xFF, 0xFF, 0xFF,
+  0xF8, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x40, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x40, 0x03, 0xFF,
+  0xFF, 0xFF, 0xF8, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xD0, 0x00, 0x03, 0xFF, 0xFF, 0xFE, 0x00, 0x00,
+  0x03, 0xFF, 0xFF, 0xF4, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x03, 0xFF, 0xFD, 0x00,
+  0x00, 0x00, 0x03, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x03, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x03, 0xF8,
+  0x00, 0x00, 0x00, 0x00, 0x03, 0xD0, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// pause 24x24, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_pause_24[144] PROGMEM = {
+  0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+  0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0,
+  0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF,
+  0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+  0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0,
+  0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF,
+  0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+  0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0,
+  0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x0F, 0xFF,
+};
+
+// check 24x24, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_check_24[144] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x02, 0xF8, 0x00, 0x00,
+  0x00, 0x00, 0x07, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x1F, 0xF4, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xE0,
+  0x00, 0x00, 0x00, 0x00, 0xBF, 0x80, 0x00, 0x00, 0x00, 0x02, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x0B,
+  0xFD, 0x00, 0x0A, 0x40, 0x00, 0x1F, 0xF4, 0x00, 0x1F, 0xD0, 0x00, 0x7F, 0xE0, 0x00, 0x1F, 0xF4,
+  0x00, 0xFF, 0x80, 0x00, 0x0B, 0xFD, 0x02, 0xFE, 0x00, 0x00, 0x02, 0xFF, 0x4B, 0xFC, 0x00, 0x00,
+  0x00, 0xBF, 0xEF, 0xF4, 0x00, 0x00, 0x00, 0x2F, 0xFF, 0xD0, 0x00, 0x00, 0x00, 0x0B, 0xFF, 0x80,
+  0x00, 0x00, 0x00, 0x02, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// check 32x32, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_check_32[256] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0B, 0xF0,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0xF8,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xFF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF, 0xD0,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x0B, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0xFE, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xFF, 0xE0, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x07, 0xFF, 0xD0, 0x00, 0x07, 0xF4, 0x00, 0x00, 0x0F, 0xFF, 0x40, 0x00,
+  0x0B, 0xFD, 0x00, 0x00, 0x2F, 0xFD, 0x00, 0x00, 0x0F, 0xFF, 0x40, 0x00, 0xBF, 0xF8, 0x00, 0x00,
+  0x0B, 0xFF, 0xD0, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x02, 0xFF, 0xF4, 0x07, 0xFF, 0xC0, 0x00, 0x00,
+  0x00, 0xBF, 0xFD, 0x1F, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x2F, 0xFF, 0x6F, 0xFD, 0x00, 0x00, 0x00,
+  0x00, 0x0B, 0xFF, 0xFF, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x02, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xBF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2F, 0xFF, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x0B, 0xFD, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xF4, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// cross 24x24, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_cross_24[144] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x01, 0xF4, 0x00, 0x00, 0x1F, 0x40, 0x03, 0xFD, 0x00, 0x00, 0x7F, 0xC0, 0x03, 0xFF,
+  0x40, 0x01, 0xFF, 0xC0, 0x01, 0xFF, 0xD0, 0x07, 0xFF, 0x40, 0x00, 0x7F, 0xF4, 0x1F, 0xFD, 0x00,
+  0x00, 0x1F, 0xFD, 0x7F, 0xF4, 0x00, 0x00, 0x07, 0xFF, 0xFF, 0xD0, 0x00, 0x00, 0x01, 0xFF, 0xFF,
+  0x40, 0x00, 0x00, 0x00, 0x7F, 0xFD, 0x00, 0x00, 0x00, 0x00, 0x7F, 0xFD, 0x00, 0x00, 0x00, 0x01,
+  0xFF, 0xFF, 0x40, 0x00, 0x00, 0x07, 0xFF, 0xFF, 0xD0, 0x00, 0x00, 0x1F, 0xFD, 0x7F, 0xF4, 0x00,
+  0x00, 0x7F, 0xF4, 0x1F, 0xFD, 0x00, 0x01, 0xFF, 0xD0, 0x07, 0xFF, 0x40, 0x03, 0xFF, 0x40, 0x01,
+  0xFF, 0xC0, 0x03, 0xFD, 0x00, 0x00, 0x7F, 0xC0, 0x01, 0xF4, 0x00, 0x00, 0x1F, 0x40, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// cross 32x32, 2 bpp, rows padded to whole bytes
+static const uint8_t icon_cross_32[256] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x6E, 0x00, 0x00, 0x00, 0x00, 0xB9, 0x00, 0x00, 0xBF, 0x80, 0x00, 0x00, 0x02, 0xFE, 0x00,
+  0x00, 0xFF, 0xE0, 0x00, 0x00, 0x0B, 0xFF, 0x00, 0x00, 0xBF, 0xF8, 0x00, 0x00, 0x2F, 0xFE, 0x00,
+  0x00, 0x2F, 0xFE, 0x00, 0x00, 0xBF, 0xF8, 0x00, 0x00, 0x0B, 0xFF, 0x80, 0x02, 0xFF, 0xE0, 0x00,
+  0x00, 0x02, 0xFF, 0xE0, 0x0B, 0xFF, 0x80, 0x00, 0x00, 0x00, 0xBF, 0xF8, 0x2F, 0xFE, 0x00, 0x00,
+  0x00, 0x00, 0x2F, 0xFE, 0xBF, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x0B, 0xFF, 0xFF, 0xE0, 0x00, 0x00,
+  0x00, 0x00, 0x02, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBF, 0xFE, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xBF, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xFF, 0xFF, 0x80, 0x00, 0x00,
+  0x00, 0x00, 0x0B, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x2F, 0xFE, 0xBF, 0xF8, 0x00, 0x00,
+  0x00, 0x00, 0xBF, 0xF8, 0x2F, 0xFE, 0x00, 0x00, 0x00, 0x02, 0xFF, 0xE0, 0x0B, 0xFF, 0x80, 0x00,
+  0x00, 0x0B, 0xFF, 0x80, 0x02, 0xFF, 0xE0, 0x00, 0x00, 0x2F, 0xFE, 0x00, 0x00, 0xBF, 0xF8, 0x00,
+  0x00, 0xBF, 0xF8, 0x00, 0x00, 0x2F, 0xFE, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x0B, 0xFF, 0x00,
+  0x00, 0xBF, 0x80, 0x00, 0x00, 0x02, 0xFE, 0x00, 0x00, 0x6E, 0x00, 0x00, 0x00, 0x00, 0xB9, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+#define ICON_MAX_DIM 36
+
+static const IconMask iconMasks[] PROGMEM = {
+  { ICON_GEAR, 36, 36, icon_gear_36 },
+  { ICON_PLAY, 24, 24, icon_play_24 },
+  { ICON_PAUSE, 24, 24, icon_pause_24 },
+  { ICON_CHECK, 24, 24, icon_check_24 },
+  { ICON_CHECK, 32, 32, icon_check_32 },
+  { ICON_CROSS, 24, 24, icon_cross_24 },
+  { ICON_CROSS, 32, 32, icon_cross_32 },
+};
+
+#endif // ICONS_DATA_H
@@ -0,0 +1,251 @@
+// Input recording implementation
+
+#include "input_trace.h"
+
+#if USE_INPUT_TRACE
+
+#include "pomodoro_globals.h"
+#include "app_clock.h"
+#include "remote_commands.h"
+#include "deferred_log.h"
+
+struct TraceEvent {
+  uint32_t ms;      // App clock, from traceBaseMs
+  int16_t x;
+  int16_t y;
+  uint8_t type;
+  uint8_t a;
+};
+
+// UI state at either end of a recording, for a host replay to start from
+// and check against
+struct TraceState {
+  uint64_t clockMs;               // App clock it was taken at
+  TimerState state;
+  bool workSession;
+  unsigned long elapsed;          // Into the current phase
+  unsigned long sinceTimerStart;  // For the short-tap block, 0 = never started
+  PomodoroMode mode;
+  uint8_t viewMode;
+  bool gridActive;
+  bool minutesOnly;
+  uint8_t rotation;
+  uint16_t workColor;
+  uint16_t restColor;
+};
+
+struct TraceLatency {
+  uint16_t count;
+  uint32_t eventToActionMsTotal;
+  uint32_t eventToActionMsMax;
+  uint32_t actionToPixelUsTotal;
+  uint32_t actionToPixelUsMax;
+};
+
+#define TRACE_X_NAME(id, name) name,
+static const char* const traceActionNames[TRACE_ACTION_COUNT] = {
+  TRACE_ACTIONS(TRACE_X_NAME)
+};
+
+static TraceEvent* traceEvents = nullptr;  // TRACE_CAPACITY entries, allocated on first recording
+static uint16_t traceCount = 0;
+static bool traceRecording = false;
+static bool traceOverflow = false;
+static TraceState traceStartState;
+static TraceState traceEndState;
+static uint64_t traceBaseMs = 0;  // App clock when recording started
+
+// Last inputs seen, so only changes are stored (and count as edges)
+static int recTpInt = -1;
+static int16_t recTouchX = -1, recTouchY = -1;
+static uint8_t recTouchNum = 0xFF;
+
+// Interaction in flight
+static bool eventPending = false;
+static unsigned long eventMs = 0;
+static bool actionPending = false;
+static TraceAction pendingAction = ACT_TAP;
+static uint32_t actionEventToMs = 0;
+static uint32_t actionUs = 0;
+static TraceLatency traceLatency[TRACE_ACTION_COUNT];
+
+// --- Helper: append one event, dropping the rest once the trace is full ---
+static void traceAppend(uint8_t type, uint8_t a, int16_t x, int16_t y) {
+  if (!traceRecording) return;
+  if (traceCount >= TRACE_CAPACITY - (type == TRACE_END ? 0 : 1)) {  // Last slot kept for TRACE_END
+    traceOverflow = true;
+    return;
+  }
+  TraceEvent& e = traceEvents[traceCount++];
+  e.ms = (uint32_t)(appMillis64() - traceBaseMs);
+  e.type = type;
+  e.a = a;
+  e.x = x;
+  e.y = y;
+}
+
+// --- Helper: capture the UI state at either end of a trace ---
+static TraceState captureTraceState() {
+  TraceState s;
+  uint64_t now = appMillis64();
+  s.clockMs = now;
+  s.state = currentState;
+  s.workSession = isWorkSession;
+  s.elapsed = (currentState == RUNNING) ? (now - startTime) : (currentState == PAUSED) ? elapsedBeforePause : 0;
+  s.sinceTimerStart = (timerStartTime > 0) ? (now - timerStartTime) : 0;
+  s.mode = currentMode;
+  s.viewMode = currentViewMode;
+  s.gridActive = gridViewActive;
+  s.minutesOnly = showMinutesOnly;
+  s.rotation = currentRotation;
+  s.workColor = selectedWorkColor;
+  s.restColor = selectedRestColor;
+  return s;
+}
+
+void startTraceRecording() {
+  if (traceEvents == nullptr) {
+    traceEvents = (TraceEvent*)malloc(TRACE_CAPACITY * sizeof(TraceEvent));
+    if (traceEvents == nullptr) {
+      LOG(LOG_TRACE_NO_MEMORY, (uint32_t)(TRACE_CAPACITY * sizeof(TraceEvent)));
+      return;
+    }
+  }
+  traceCount = 0;
+  traceOverflow = false;
+  recTpInt = -1;
+  recTouchNum = 0xFF;
+  memset(traceLatency, 0, sizeof(traceLatency));
+  eventPending = false;
+  actionPending = false;
+  traceStartState = captureTraceState();
+  traceEndState = traceStartState;
+  traceBaseMs = traceStartState.clockMs;
+  traceRecording = true;
+  traceAppend(TRACE_TP_INT, digitalRead(TP_INT), 0, 0);  // Starting level
+  recTpInt = traceEvents[0].a;
+  LOG(LOG_TRACE_RECORDING);
+}
+
+void stopTraceRecording() {
+  if (!traceRecording) return;
+  traceAppend(TRACE_END, 0, 0, 0);
+  traceRecording = false;
+  traceEndState = captureTraceState();
+  LOG(LOG_TRACE_RECORDED, traceCount, traceEvents[traceCount - 1].ms, traceOverflow);
+}
+
+void traceRecordTouchInt(int level) {
+  if (level == recTpInt) return;
+  recTpInt = level;
+  traceAppend(TRACE_TP_INT, level, 0, 0);
+  traceInputEvent();
+}
+
+void traceRecordTouchPoints(const touch_data_t& points) {
+  if (!traceRecording) return;
+  int16_t x = points.touch_num ? points.coords[0].x : -1;
+  int16_t y = points.touch_num ? points.coords[0].y : -1;
+  if (points.touch_num == recTouchNum && x == recTouchX && y == recTouchY) return;
+  recTouchNum = points.touch_num;
+  recTouchX = x;
+  recTouchY = y;
+  traceAppend(TRACE_TOUCH, points.touch_num, x, y);
+}
+
+void traceRecordImu(int32_t axMg, int32_t ayMg) {
+  traceAppend(TRACE_IMU, 0, (int16_t)axMg, (int16_t)ayMg);
+}
+
+void traceTelegramCommands() {
+  uint8_t cmds = (telegramCmdStart ? TRACE_TG_START : 0) |
+                 (telegramCmdPause ? TRACE_TG_PAUSE : 0) |
+                 (telegramCmdResume ? TRACE_TG_RESUME : 0) |
+                 (telegramCmdStop ? TRACE_TG_STOP : 0) |
+                 (telegramCmdMode ? TRACE_TG_MODE : 0);
+  if (cmds == 0) return;
+  traceAppend(TRACE_TELEGRAM, cmds, 0, 0);
+  traceInputEvent();
+}
+
+void traceInputEvent() {
+  if (!traceRecording) return;
+  eventPending = true;
+  eventMs = appMillis();
+}
+
+void traceAction(TraceAction action) {
+  traceAppend(TRACE_ACTION, action, 0, 0);
+  // The first action answers the event; the ones it triggers are part of it
+  if (!eventPending || actionPending) return;
+  eventPending = false;
+  actionPending = true;
+  pendingAction = action;
+  actionEventToMs = appMillis() - eventMs;
+  actionUs = micros();
+}
+
+void traceFrameDone(bool pixelsSent) {
+  if (!actionPending || !pixelsSent) return;
+  actionPending = false;
+  uint32_t toPixelUs = micros() - actionUs;
+  TraceLatency& l = traceLatency[pendingAction];
+  l.count++;
+  l.eventToActionMsTotal += actionEventToMs;
+  if (actionEventToMs > l.eventToActionMsMax) l.eventToActionMsMax = actionEventToMs;
+  l.actionToPixelUsTotal += toPixelUs;
+  if (toPixelUs > l.actionToPixelUsMax) l.actionToPixelUsMax = toPixelUs;
+  LOG(LOG_TRACE_INTERACTION, traceActionNames[pendingAction], actionEventToMs, toPixelUs);
+}
+
+// --- Helper: one "# start"/"# end" line of the dump ---
+static void printTraceState(Print& out, const char* which, const TraceState& s) {
+  out.printf("# %s clock=%llu state=%u work=%u elapsed=%lu since_start=%lu mode=%u view=%u grid=%u "
+             "minutes_only=%u rotation=%u work_color=%u rest_color=%u\n",
+             which, (unsigned long long)s.clockMs, s.state, s.workSession, s.elapsed, s.sinceTimerStart, s.mode,
+             s.viewMode, s.gridActive, s.minutesOnly, s.rotation, s.workColor, s.restColor);
+}
+
+void printTrace(Print& out) {
+  if (traceCount == 0) return;
+  printTraceState(out, "start", traceStartState);
+  if (!traceRecording) printTraceState(out, "end", traceEndState);
+  out.println("ms,type,a,x,y");
+  for (uint16_t i = 0; i < traceCount; i++) {
+    const TraceEvent& e = traceEvents[i];
+    out.println(String(e.ms) + "," + String(e.type) + "," + String(e.a) + "," +
+                String(e.x) + "," + String(e.y));
+  }
+}
+
+void printTraceReport(Print& out) {
+  out.println("[TRACE] action     n  event->action avg/max ms  action->pixel avg/max us");
+  for (uint8_t i = 0; i < TRACE_ACTION_COUNT; i++) {
+    const TraceLatency& l = traceLatency[i];
+    if (l.count == 0) continue;
+    String line = traceActionNames[i];
+    while (line.length() < 10) line += ' ';
+    line += " " + String(l.count);
+    line += "  " + String(l.eventToActionMsTotal / l.count) + "/" + String(l.eventToActionMsMax);
+    line += "  " + String(l.actionToPixelUsTotal / l.count) + "/" + String(l.actionToPixelUsMax);
+    out.println(line);
+  }
+}
+
+bool traceCommand(char c) {
+  if (c == 't') {
+    if (traceRecording) {
+      stopTraceRecording();
+      printTraceReport(Serial);
+    } else {
+      startTraceRecording();
+    }
+  } else if (c == 'd') {
+    printTrace(Serial);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+#endif // USE_INPUT_TRACE
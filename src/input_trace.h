@@ -0,0 +1,85 @@
+// Input recording for end-to-end latency measurement
+//
+// Recording captures TP_INT edges, touch coordinates, IMU samples, the
+// Telegram commands the loop picks up and the actions they end in,
+// timestamped on the app clock, into a RAM trace. Each interaction is
+// reported as event->action (ms: debounce, hold and tap-block windows) and
+// action->pixel (us until the flush that put the change on the panel).
+// The dump holds the UI state at both ends of the recording as well;
+// tools/trace_replay.py feeds it through the input code on the host and
+// checks that the same actions and end state come out.
+
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+#include "esp_lcd_touch_axs5106l.h"
+
+// What an interaction ended in: X(id, "name")
+#define TRACE_ACTIONS(X) \
+  X(ACT_START,  "start") \
+  X(ACT_PAUSE,  "pause") \
+  X(ACT_RESUME, "resume") \
+  X(ACT_STOP,   "stop") \
+  X(ACT_MODE,   "mode") \
+  X(ACT_ROTATE, "rotate") \
+  X(ACT_TAP,    "tap")
+
+#define TRACE_X_ID(id, name) id,
+enum TraceAction : uint8_t {
+  TRACE_ACTIONS(TRACE_X_ID)
+  TRACE_ACTION_COUNT
+};
+
+// Trace event types, the "type" column of the dump
+enum TraceEventType : uint8_t {
+  TRACE_TP_INT,     // a = level
+  TRACE_TOUCH,      // a = touch_num, x/y = first point
+  TRACE_IMU,        // x/y = accel X/Y in milli-g
+  TRACE_TELEGRAM,   // a = TRACE_TG_* bits
+  TRACE_END,
+  TRACE_ACTION      // a = TraceAction
+};
+
+#define TRACE_TG_START  0x01
+#define TRACE_TG_PAUSE  0x02
+#define TRACE_TG_RESUME 0x04
+#define TRACE_TG_STOP   0x08
+#define TRACE_TG_MODE   0x10
+
+#if USE_INPUT_TRACE
+
+void startTraceRecording();
+void stopTraceRecording();
+void printTrace(Print& out);    // "# start/end" state lines, then CSV: ms,type,a,x,y
+void printTraceReport(Print& out);
+
+// Serial: 't' starts/stops recording, 'd' dumps the trace
+bool traceCommand(char c);
+
+// Input hooks, called with the live value
+void traceRecordTouchInt(int level);
+void traceRecordTouchPoints(const touch_data_t& points);
+void traceRecordImu(int32_t axMg, int32_t ayMg);
+void traceTelegramCommands();   // Before the loop runs the pending flags
+
+// Latency marks
+void traceInputEvent();             // An input that can start an interaction
+void traceAction(TraceAction action);
+void traceFrameDone(bool pixelsSent);
+
+#else
+
+inline bool traceCommand(char) { return false; }
+inline void traceRecordTouchInt(int) {}
+inline void traceRecordTouchPoints(const touch_data_t&) {}
+inline void traceRecordImu(int32_t, int32_t) {}
+inline void traceTelegramCommands() {}
+inline void traceInputEvent() {}
+inline void traceAction(TraceAction) {}
+inline void traceFrameDone(bool) {}
+
+#endif // USE_INPUT_TRACE
+
+#endif // INPUT_TRACE_H
@@ -0,0 +1,107 @@
+// Deferred log message table
+//
+// One line per message: X(id, level, tag, "format"). Call sites log by id,
+// only the arguments travel through the ring buffer, and the format text is
+// looked up on the host by tools/decode_log.py (which parses this file) or
+// by the drain task when LOG_BINARY_OUTPUT is 0. Append new entries at the
+// end so ids in old captures still decode, and rename an entry that is no
+// longer logged to LOG_RETIRED_<id> instead of deleting it.
+//
+// Format specifiers: %u %d %X (32-bit), %s (string, truncated to fit).
+
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+#define LOG_FORMATS(X) \
+  X(LOG_DROPPED,              LOG_LEVEL_WARN,  LOG_TAG_LOG,      "[LOG] %u records dropped (ring full)") \
+  X(LOG_TOUCH_PRESSED,        LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    ">>> TOUCH PRESSED <<<") \
+  X(LOG_TOUCH_RELEASED,       LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    ">>> TOUCH RELEASED after %u ms <<<") \
+  X(LOG_TOUCH_STATE,          LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    "TP_INT=%u points=%u pressed=%u") \
+  X(LOG_TOUCH_LONG_PRESS,     LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** LONG PRESS detected! (%u ms) ***") \
+  X(LOG_TOUCH_LONG_START,     LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Starting timer") \
+  X(LOG_TOUCH_LONG_STOP,      LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Stopping timer") \
+  X(LOG_TOUCH_TAP_OUTSIDE,    LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    "*** SHORT TAP ignored (outside button) ***") \
+  X(LOG_TOUCH_LONG_HANDLED,   LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    "*** LONG PRESS was already handled ***") \
+  X(LOG_TOUCH_TAP_BLOCKED,    LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    "*** SHORT TAP blocked (too soon after timer start) ***") \
+  X(LOG_GRID_CANCEL,          LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** GRID CANCEL (X) BUTTON CLICKED ***") \
+  X(LOG_GRID_CONFIRM,         LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** GRID CONFIRM (✓) BUTTON CLICKED ***") \
+  X(LOG_GRID_REST_SELECTED,   LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Selected rest color index: %d, color: 0x%X") \
+  X(LOG_GRID_WORK_PREVIEW,    LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Preview color index: %d, color: 0x%X") \
+  X(LOG_GRID_CELL_TAPPED,     LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** COLOR CELL TAPPED: %d (0x%X) ***") \
+  X(LOG_PREVIEW_CANCEL,       LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** PREVIEW CANCEL (X) BUTTON CLICKED ***") \
+  X(LOG_PREVIEW_WORK_SWATCH,  LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** WORK COLOR SWATCH CLICKED ***") \
+  X(LOG_PREVIEW_REST_SWATCH,  LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** REST COLOR SWATCH CLICKED ***") \
+  X(LOG_PREVIEW_CONFIRM,      LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** PREVIEW CONFIRM (V) BUTTON CLICKED ***") \
+  X(LOG_PREVIEW_SAVED_WORK,   LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Saved work color: 0x%X") \
+  X(LOG_PREVIEW_SAVED_REST,   LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Saved rest color: 0x%X") \
+  X(LOG_PREVIEW_REST_INVERT,  LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Rest color: inverted work color") \
+  X(LOG_GEAR_CLICKED,         LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** GEAR BUTTON CLICKED ***") \
+  X(LOG_MODE_CLICKED,         LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** MODE BUTTON CLICKED ***") \
+  X(LOG_MODE_SWITCHED,        LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Switched to %s mode") \
+  X(LOG_CIRCLE_TAPPED,        LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** CIRCLE TAPPED - TOGGLE TIME DISPLAY MODE ***") \
+  X(LOG_TIME_FORMAT,          LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "-> Switched to %s") \
+  X(LOG_STATUS_CLICKED,       LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "*** STATUS BUTTON CLICKED ***") \
+  X(LOG_TIMER_START,          LOG_LEVEL_INFO,  LOG_TAG_TIMER,    "[TIMER] startTimer called") \
+  X(LOG_TIMER_PAUSE,          LOG_LEVEL_INFO,  LOG_TAG_TIMER,    "[TIMER] pauseTimer called") \
+  X(LOG_TIMER_RESUME,         LOG_LEVEL_INFO,  LOG_TAG_TIMER,    "[TIMER] resumeTimer called") \
+  X(LOG_TIMER_STOP,           LOG_LEVEL_INFO,  LOG_TAG_TIMER,    "[TIMER] stopTimer called") \
+  X(LOG_TG_QUEUED,            LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG] Queued: %s") \
+  X(LOG_TG_SENDING,           LOG_LEVEL_DEBUG, LOG_TAG_TELEGRAM, "[TG TASK] Sending: %s") \
+  X(LOG_TG_SENT,              LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG TASK] Done (%u ms)") \
+  X(LOG_TG_COMMAND,           LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG] Command: %s") \
+  X(LOG_TG_CMD_START,         LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG CMD] Starting timer") \
+  X(LOG_TG_CMD_PAUSE,         LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG CMD] Pausing timer") \
+  X(LOG_TG_CMD_RESUME,        LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG CMD] Resuming timer") \
+  X(LOG_TG_CMD_STOP,          LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG CMD] Stopping timer") \
+  X(LOG_TG_CMD_MODE,          LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG CMD] Changing mode") \
+  X(LOG_NVS_SAVED_WORK,       LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Saved work color to NVS: 0x%X") \
+  X(LOG_NVS_SAVED_REST,       LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Saved rest color to NVS: 0x%X") \
+  X(LOG_NVS_LOADED_WORK,      LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Loaded work color from NVS: 0x%X") \
+  X(LOG_NVS_LOADED_REST,      LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Loaded rest color from NVS: 0x%X") \
+  X(LOG_NVS_REST_INVERT,      LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Rest color: using inverted work color") \
+  X(LOG_ROTATION_CHANGED,     LOG_LEVEL_INFO,  LOG_TAG_ROTATION, "Rotation changed: %u -> %u") \
+  X(LOG_RETIRED_47,           LOG_LEVEL_DEBUG, LOG_TAG_DISPLAY,  "(retired)") \
+  X(LOG_SETTINGS_LOADED,      LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Settings loaded (v%u)") \
+  X(LOG_SETTINGS_MIGRATED,    LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Settings migrated from v%u") \
+  X(LOG_SETTINGS_INVALID,     LOG_LEVEL_WARN,  LOG_TAG_STORAGE,  "Settings blob rejected (%u bytes), using defaults") \
+  X(LOG_SETTINGS_COMMITTED,   LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Settings committed (%u bytes)") \
+  X(LOG_SETTINGS_WRITE_FAILED, LOG_LEVEL_ERROR, LOG_TAG_STORAGE, "Settings write failed") \
+  X(LOG_SESSION_NO_PARTITION, LOG_LEVEL_WARN,  LOG_TAG_STORAGE,  "Session log: no usable \"%s\" partition, history not kept") \
+  X(LOG_SESSION_LOG_READY,    LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Session log: last seq %u, head slot %u") \
+  X(LOG_SESSION_LOGGED,       LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "Session #%u logged: %s, %u s active, interrupted=%u") \
+  X(LOG_SESSION_WRITE_FAILED, LOG_LEVEL_ERROR, LOG_TAG_STORAGE,  "Session log write failed at slot %u") \
+  X(LOG_SD_MOUNTED,           LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "SD card mounted (%u MB)") \
+  X(LOG_SD_NO_CARD,           LOG_LEVEL_WARN,  LOG_TAG_STORAGE,  "SD card not found") \
+  X(LOG_SD_OPEN_FAILED,       LOG_LEVEL_ERROR, LOG_TAG_STORAGE,  "SD open failed: %s") \
+  X(LOG_SD_WRITE_FAILED,      LOG_LEVEL_ERROR, LOG_TAG_STORAGE,  "SD write failed after %u bytes") \
+  X(LOG_SD_EXPORT_DONE,       LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "SD export: %u bytes, %u blocks in %u ms") \
+  X(LOG_SD_THROUGHPUT,        LOG_LEVEL_INFO,  LOG_TAG_STORAGE,  "SD write: %u KB/s, worst block %u us, %u deferred") \
+  X(LOG_TRACE_NO_MEMORY,      LOG_LEVEL_ERROR, LOG_TAG_TOUCH,    "[TRACE] Cannot allocate %u bytes") \
+  X(LOG_TRACE_RECORDING,      LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "[TRACE] Recording") \
+  X(LOG_TRACE_RECORDED,       LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "[TRACE] %u events over %u ms, overflow=%u") \
+  X(LOG_RETIRED_66,           LOG_LEVEL_DEBUG, LOG_TAG_TOUCH,    "(retired)") \
+  X(LOG_TRACE_INTERACTION,    LOG_LEVEL_INFO,  LOG_TAG_TOUCH,    "[TRACE] %s: event->action %u ms, action->pixel %u us") \
+  X(LOG_TG_POLL_FAILED,       LOG_LEVEL_WARN,  LOG_TAG_TELEGRAM, "[TG TASK] getUpdates failed: %s (%u)") \
+  X(LOG_TG_DRAINED,           LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG TASK] Backlog: %u stale updates skipped, %u requests, %u ms") \
+  X(LOG_TG_STATUS_LOST,       LOG_LEVEL_WARN,  LOG_TAG_TELEGRAM, "[TG TASK] Status message %u cannot be edited, sending a new one") \
+  X(LOG_TG_STATUS_PIN_FAILED, LOG_LEVEL_WARN,  LOG_TAG_TELEGRAM, "[TG TASK] Pinning the status message failed (%u)") \
+  X(LOG_TG_FANOUT_DROPPED,    LOG_LEVEL_WARN,  LOG_TAG_TELEGRAM, "[TG TASK] Recipient dropped: %u %s") \
+  X(LOG_TG_REPLY_FAILED,      LOG_LEVEL_WARN,  LOG_TAG_TELEGRAM, "[TG TASK] Reply failed: %u %s") \
+  X(LOG_HTTP_STARTED,         LOG_LEVEL_INFO,  LOG_TAG_HTTP,     "[HTTP] Listening on port %u") \
+  X(LOG_HTTP_FAILED,          LOG_LEVEL_ERROR, LOG_TAG_HTTP,     "[HTTP] Cannot listen on port %u") \
+  X(LOG_HTTP_COMMAND,         LOG_LEVEL_INFO,  LOG_TAG_HTTP,     "[HTTP] Command: %s") \
+  X(LOG_MQTT_CONNECTED,       LOG_LEVEL_INFO,  LOG_TAG_MQTT,     "[MQTT] Connected as %s") \
+  X(LOG_MQTT_CONNECT_FAILED,  LOG_LEVEL_WARN,  LOG_TAG_MQTT,     "[MQTT] Connect failed, return code %u") \
+  X(LOG_MQTT_DISCONNECTED,    LOG_LEVEL_WARN,  LOG_TAG_MQTT,     "[MQTT] Connection lost") \
+  X(LOG_MQTT_COMMAND,         LOG_LEVEL_INFO,  LOG_TAG_MQTT,     "[MQTT] Command: %s") \
+  X(LOG_BATTERY_STARTED,      LOG_LEVEL_INFO,  LOG_TAG_BATTERY,  "[BAT] Sampling GPIO %u at %u Hz") \
+  X(LOG_BATTERY_FAILED,       LOG_LEVEL_WARN,  LOG_TAG_BATTERY,  "[BAT] Not sampling: %s") \
+  X(LOG_BACKLIGHT_FAILED,     LOG_LEVEL_WARN,  LOG_TAG_DISPLAY,  "[BL] LEDC setup failed, backlight fully on") \
+  X(LOG_MEM_TLS_LOW,          LOG_LEVEL_WARN,  LOG_TAG_MEM,      "[MEM] Heap too low for TLS: %u free, %u largest block") \
+  X(LOG_MEM_TLS_OK,           LOG_LEVEL_INFO,  LOG_TAG_MEM,      "[MEM] Heap back above TLS needs: %u free, %u largest block") \
+  X(LOG_MEM_STACK_LOW,        LOG_LEVEL_WARN,  LOG_TAG_MEM,      "[MEM] %s stack headroom down to %u bytes") \
+  X(LOG_SESSION_QUEUE_FULL,   LOG_LEVEL_ERROR, LOG_TAG_STORAGE,  "Session log: %u records already waiting, session not kept") \
+  X(LOG_TG_FANOUT_DONE,       LOG_LEVEL_INFO,  LOG_TAG_TELEGRAM, "[TG TASK] Delivered to %u/%u chats in %u batches, last after %u ms") \
+  X(LOG_MQTT_RETAINED_CMD,    LOG_LEVEL_WARN,  LOG_TAG_MQTT,     "[MQTT] Retained command ignored: %s")
+
+#endif // LOG_FORMATS_H
@@ -15,6 +15,7 @@
 #include "pomodoro_config.h"
 #include "pomodoro_globals.h"
 #include "wifi_telegram.h"
+#include "remote_commands.h"
 #include "color_utils.h"
 #include "storage.h"
 #include "display_graphics.h"
@@ -22,23 +23,51 @@
 #include "touch_handler.h"
 #include "display_updates.h"
 #include "auto_rotation.h"
+#include "deferred_log.h"
+#include "profiler.h"
+#include "session_log.h"
+#include "sd_export.h"
+#include "input_trace.h"
+#include "telegram_status.h"
+#include "http_api.h"
+#include "mqtt_state.h"
+#include "battery.h"
+#include "backlight.h"
+#include "mem_telemetry.h"
+
+// --- Helper: single-letter debug commands on Serial ---
+static void checkSerialCommands() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (profileCommand(c)) continue;  // p, r (profiling builds)
+    if (traceCommand(c)) continue;    // t, d
+    if (batteryCommand(c)) continue;  // b
+    if (backlightCommand(c)) continue; // l
+    memCommand(c);                    // h
+  }
+}
 
 // --- Arduino setup / loop ---
 void setup(void) {
   Serial.begin(115200);
   Serial.println("Pomodoro Timer (Arduino_GFX) starting...");
+  startLogTask();  // Drains LOG() records to Serial from here on
 
   if (!gfx->begin()) {
     Serial.println("gfx->begin() failed!");
   }
 
   lcd_reg_init();
-  gfx->setRotation(ROTATION);
+  initSdCard();  // Same SPI bus, begun by gfx->begin() with the SD's MISO
+  loadSettings();  // Colors, mode and rotation from NVS
+  initSessionLog();
+  initBattery();  // First percentage about a second later
+  initUIColorSlots(selectedWorkColor);  // Before the first draw
+  gfx->setRotation(currentRotation);
   gfx->fillScreen(COLOR_BLACK);
 
 #ifdef GFX_BL
-  pinMode(GFX_BL, OUTPUT);
-  digitalWrite(GFX_BL, HIGH);
+  initBacklight();  // Fades in over the black screen
   Serial.println("Initializing I2C for touch...");
 #endif
 
@@ -67,9 +96,6 @@ void setup(void) {
     imuInitialized = true;
   }
 
-  // Load saved color from NVS
-  loadSelectedColor();
-  
   // Connect to WiFi
   connectWiFi();
   
@@ -78,20 +104,37 @@ void setup(void) {
   
   // Start Telegram task on separate core
   startTelegramTask();
+  startHttpApi();
+  startMqtt();
 
   displayStoppedState();
 }
 
 void loop() {
-  // Handle touch FIRST - highest priority for responsiveness
-  handleTouchInput();
-  
-  // Process commands from Telegram (non-blocking - just checks flags)
-  processTelegramCommands();
-  
-  updateTimer();
-  updateDisplay();
-  checkAutoRotation();  // Check IMU for auto-rotation
+  profileNextPass();
+  {
+    PROFILE_SCOPE(PROF_LOOP);
+
+    // Handle touch FIRST - highest priority for responsiveness
+    PROFILE_CALL(PROF_TOUCH, handleTouchInput());
+
+    // Process commands from Telegram (non-blocking - just checks flags)
+    PROFILE_CALL(PROF_TELEGRAM_CMDS, processTelegramCommands());
+
+    PROFILE_CALL(PROF_UPDATE_TIMER, updateTimer());
+    PROFILE_CALL(PROF_UPDATE_DISPLAY, updateDisplay());
+    PROFILE_CALL(PROF_AUTO_ROTATION, checkAutoRotation());  // Check IMU for auto-rotation
+    PROFILE_CALL(PROF_FLUSH, flushDisplay());  // Push this iteration's drawing to the panel
+  }
+  serviceSettings();  // Write changed settings once they settle
+  serviceTelegramStatus();  // Hand a changed status text to the Telegram task
+  serviceBacklight();  // Level for the new state, after this pass's commands
+  serviceBattery();  // Drain the ADC ring once a second, before the state is published
+  publishHttpState();  // Changed state or remaining second to /events
+  publishMqttState();  // Changed topics to the MQTT task
+  serviceMemTelemetry();  // Heap and stack low points, every MEM_SAMPLE_MS
+  serviceSdExport();  // One SD block at most, between display frames
+  checkSerialCommands();
 
   // Tap indicator disabled for better touch responsiveness
   // (was causing lag due to drawing overhead)
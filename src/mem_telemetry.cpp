@@ -0,0 +1,171 @@
+// Heap and stack telemetry implementation
+
+#include "mem_telemetry.h"
+
+#if USE_MEM_TELEMETRY
+
+#include "deferred_log.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Tasks created by the app (names as passed to xTaskCreate)
+static const char* const watchedTasks[] = { "loopTask", "TelegramTask", "HttpTask", "MqttTask", "LogDrain",
+                                             "SettingsTask", "SessionLog" };
+#define WATCHED_TASKS (sizeof(watchedTasks) / sizeof(watchedTasks[0]))
+#define STACK_UNKNOWN 0xFFFFFFFFUL  // Task not running (feature off or not started)
+
+struct HeapSample {
+  uint32_t freeBytes;
+  uint32_t largestBlock;
+};
+
+struct HeapLows {
+  uint32_t freeBytes;
+  uint32_t largestBlock;
+  uint8_t fragPct;  // Highest
+};
+
+enum { HEAP_INTERNAL, HEAP_DMA, HEAP_KINDS };
+static const uint32_t heapCaps[HEAP_KINDS] = { MALLOC_CAP_INTERNAL, MALLOC_CAP_DMA };
+static const char* const heapNames[HEAP_KINDS] = { "internal", "dma" };
+
+static HeapSample last[HEAP_KINDS];
+static HeapLows buckets[MEM_BUCKETS][HEAP_KINDS];  // Rolling window, one bucket per MEM_BUCKET_MS
+static uint8_t bucket = 0;
+static uint32_t bucketStart = 0;
+static uint32_t stackFree[WATCHED_TASKS];
+static uint32_t stackWarned = 0;  // One bit per watched task
+static bool tlsLow = false;
+static bool sampled = false;
+static uint32_t lastSample = 0;
+
+// --- Helper: share of the free bytes outside the largest block ---
+static uint8_t fragPct(const HeapSample& s) {
+  return s.freeBytes ? 100 - (uint8_t)((uint64_t)s.largestBlock * 100 / s.freeBytes) : 0;
+}
+
+static void resetLows(HeapLows& lows) {
+  lows.freeBytes = UINT32_MAX;
+  lows.largestBlock = UINT32_MAX;
+  lows.fragPct = 0;
+}
+
+static void lowerLows(HeapLows& lows, const HeapSample& s) {
+  if (s.freeBytes < lows.freeBytes) lows.freeBytes = s.freeBytes;
+  if (s.largestBlock < lows.largestBlock) lows.largestBlock = s.largestBlock;
+  if (fragPct(s) > lows.fragPct) lows.fragPct = fragPct(s);
+}
+
+// --- Helper: low points over every bucket of the window ---
+static HeapLows rollingLows(uint8_t kind) {
+  HeapLows lows;
+  resetLows(lows);
+  for (uint8_t b = 0; b < MEM_BUCKETS; b++) {
+    if (buckets[b][kind].freeBytes < lows.freeBytes) lows.freeBytes = buckets[b][kind].freeBytes;
+    if (buckets[b][kind].largestBlock < lows.largestBlock) lows.largestBlock = buckets[b][kind].largestBlock;
+    if (buckets[b][kind].fragPct > lows.fragPct) lows.fragPct = buckets[b][kind].fragPct;
+  }
+  return lows;
+}
+
+// --- Helper: warn once when the TLS handshake would no longer fit ---
+static void checkTlsHeadroom() {
+  const HeapSample& s = last[HEAP_INTERNAL];
+  bool low = s.freeBytes < MEM_TLS_MIN_FREE || s.largestBlock < MEM_TLS_MIN_BLOCK;
+  // Recovered only with 10% to spare, so a value hovering at the line logs once
+  bool clear = s.freeBytes >= MEM_TLS_MIN_FREE + MEM_TLS_MIN_FREE / 10 &&
+               s.largestBlock >= MEM_TLS_MIN_BLOCK + MEM_TLS_MIN_BLOCK / 10;
+  if (low && !tlsLow) {
+    tlsLow = true;
+    LOG(LOG_MEM_TLS_LOW, s.freeBytes, s.largestBlock);
+  } else if (clear && tlsLow) {
+    tlsLow = false;
+    LOG(LOG_MEM_TLS_OK, s.freeBytes, s.largestBlock);
+  }
+}
+
+static void sampleStacks() {
+  for (uint8_t t = 0; t < WATCHED_TASKS; t++) {
+    TaskHandle_t handle = xTaskGetHandle(watchedTasks[t]);
+    // High-water marks are in bytes on ESP-IDF (StackType_t is a byte)
+    stackFree[t] = handle ? uxTaskGetStackHighWaterMark(handle) : STACK_UNKNOWN;
+    bool low = stackFree[t] < MEM_STACK_WARN_BYTES;
+    if (low && !(stackWarned & (1UL << t))) LOG(LOG_MEM_STACK_LOW, watchedTasks[t], stackFree[t]);
+    if (low) stackWarned |= 1UL << t;
+  }
+}
+
+void serviceMemTelemetry() {
+  uint32_t now = millis();
+  if (sampled && now - lastSample < MEM_SAMPLE_MS) return;
+  lastSample = now;
+
+  if (!sampled) {
+    for (uint8_t k = 0; k < HEAP_KINDS; k++) {
+      for (uint8_t b = 0; b < MEM_BUCKETS; b++) resetLows(buckets[b][k]);
+    }
+    bucketStart = now;
+    sampled = true;
+  }
+  if (now - bucketStart >= MEM_BUCKET_MS) {
+    bucket = (bucket + 1) % MEM_BUCKETS;
+    bucketStart = now;
+    for (uint8_t k = 0; k < HEAP_KINDS; k++) resetLows(buckets[bucket][k]);
+  }
+
+  for (uint8_t k = 0; k < HEAP_KINDS; k++) {
+    last[k].freeBytes = heap_caps_get_free_size(heapCaps[k]);
+    last[k].largestBlock = heap_caps_get_largest_free_block(heapCaps[k]);
+    lowerLows(buckets[bucket][k], last[k]);
+  }
+  checkTlsHeadroom();
+  sampleStacks();
+}
+
+bool memLowForTls() {
+  return tlsLow;
+}
+
+size_t memReport(char* out, size_t size) {
+  if (size == 0) return 0;
+  out[0] = '\0';
+  if (!sampled) return 0;
+  size_t len = 0;
+  // Appends, stopping quietly once out is full
+#define MEM_APPEND(...)                                                        \
+  do {                                                                         \
+    if (len < size) len += snprintf(out + len, size - len, __VA_ARGS__);       \
+  } while (0)
+
+  // Boot low from the allocator itself, which sees every allocation
+  MEM_APPEND("heap     free/1h low/boot low  block/1h low   frag/1h high\n");
+  for (uint8_t k = 0; k < HEAP_KINDS; k++) {
+    HeapLows rolling = rollingLows(k);
+    MEM_APPEND("%-8s %6lu/%6lu/%6lu  %6lu/%6lu  %3u%%/%3u%%\n", heapNames[k], (unsigned long)last[k].freeBytes,
+               (unsigned long)rolling.freeBytes, (unsigned long)heap_caps_get_minimum_free_size(heapCaps[k]),
+               (unsigned long)last[k].largestBlock, (unsigned long)rolling.largestBlock, fragPct(last[k]),
+               rolling.fragPct);
+  }
+  MEM_APPEND("tls %s (needs %u free, %u block)\n", tlsLow ? "LOW" : "ok", MEM_TLS_MIN_FREE, MEM_TLS_MIN_BLOCK);
+  MEM_APPEND("stack free, bytes:");
+  for (uint8_t t = 0; t < WATCHED_TASKS; t++) {
+    if (stackFree[t] == STACK_UNKNOWN) continue;
+    MEM_APPEND(" %s %lu%s", watchedTasks[t], (unsigned long)stackFree[t],
+               stackFree[t] < MEM_STACK_WARN_BYTES ? "!" : "");
+  }
+  MEM_APPEND("\n");
+#undef MEM_APPEND
+  return len < size ? len : size - 1;
+}
+
+bool memCommand(char c) {
+  if (c != 'h') return false;
+  serviceMemTelemetry();
+  char report[512];
+  memReport(report, sizeof(report));
+  Serial.print(report);
+  return true;
+}
+
+#endif // USE_MEM_TELEMETRY
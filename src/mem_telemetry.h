@@ -0,0 +1,33 @@
+// Heap and stack telemetry
+//
+// serviceMemTelemetry() samples the internal and DMA-capable heaps (free
+// bytes, largest free block, fragmentation = share of the free bytes not in
+// the largest block) and the stack high-water marks of the app's tasks.
+// Low points are kept over a rolling window (the allocator keeps the one
+// since boot); crossing the
+// TLS or stack thresholds logs a warning once, until it recovers.
+
+#ifndef MEM_TELEMETRY_H
+#define MEM_TELEMETRY_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+#if USE_MEM_TELEMETRY
+void serviceMemTelemetry();  // Loop: one sample every MEM_SAMPLE_MS
+bool memLowForTls();         // Last sample below the TLS handshake needs
+
+// Text report into out (NUL-terminated, cut to size); returns its length
+size_t memReport(char* out, size_t size);
+bool memCommand(char c);     // 'h' on Serial: the report
+#else
+inline void serviceMemTelemetry() {}
+inline bool memLowForTls() { return false; }
+inline size_t memReport(char* out, size_t size) {
+  if (size) out[0] = '\0';
+  return 0;
+}
+inline bool memCommand(char c) { return false; }
+#endif
+
+#endif // MEM_TELEMETRY_H
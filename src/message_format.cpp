@@ -0,0 +1,102 @@
+// Allocation-free message formatting implementation
+
+#include "message_format.h"
+#include <string.h>
+
+#define MSG_X_TEXT(id, text) text,
+static const char* const messageTemplates[] = { TG_MESSAGES(MSG_X_TEXT) };
+#undef MSG_X_TEXT
+
+const char* messageTemplate(MessageId id) {
+  return (id < MSG_COUNT) ? messageTemplates[id] : "";
+}
+
+struct MessageOut {
+  char* out;
+  size_t size;
+  size_t len;  // size once full
+};
+
+// --- Helper: n bytes that belong together, or mark the buffer full ---
+static bool put(MessageOut& o, const char* s, size_t n) {
+  if (o.len >= o.size) return false;
+  if (o.len + n >= o.size) {
+    o.out[o.len] = '\0';
+    o.len = o.size;
+    return false;
+  }
+  memcpy(o.out + o.len, s, n);
+  o.len += n;
+  return true;
+}
+
+// --- Helper: text of n bytes, whole UTF-8 characters, optionally HTML-escaped ---
+static bool putText(MessageOut& o, const char* s, size_t n, bool escape) {
+  const char* end = s + n;
+  while (s < end) {
+    uint8_t c = (uint8_t)*s;
+    if (escape && (c == '&' || c == '<' || c == '>')) {
+      const char* entity = (c == '&') ? "&amp;" : (c == '<') ? "&lt;" : "&gt;";
+      if (!put(o, entity, strlen(entity))) return false;
+      s++;
+      continue;
+    }
+    size_t seq = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+    if (seq > (size_t)(end - s)) seq = end - s;  // Broken sequence at the end: copied as is
+    if (!put(o, s, seq)) return false;
+    s += seq;
+  }
+  return true;
+}
+
+// --- Helper: decimal digits of v ---
+static bool putUint(MessageOut& o, uint32_t v) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[sizeof(digits) - 1 - n++] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  return put(o, digits + sizeof(digits) - n, n);
+}
+
+static bool putArg(MessageOut& o, const MessageArg& a) {
+  switch (a.kind) {
+    case MessageArg::TEXT:
+      return putText(o, a.str, strlen(a.str), true);
+    case MessageArg::MARKUP:
+      return putText(o, a.str, strlen(a.str), false);
+    case MessageArg::UINT:
+      return putUint(o, a.u);
+    case MessageArg::INT:
+    case MessageArg::TENTHS: {
+      // Magnitude as unsigned, so INT32_MIN converts too
+      uint32_t mag = (a.i < 0) ? 0u - (uint32_t)a.i : (uint32_t)a.i;
+      if (a.i < 0 && !put(o, "-", 1)) return false;
+      if (a.kind == MessageArg::INT) return putUint(o, mag);
+      char tenth[2] = { '.', (char)('0' + mag % 10) };
+      return putUint(o, mag / 10) && put(o, tenth, 2);
+    }
+  }
+  return true;
+}
+
+size_t appendMessage(char* out, size_t size, size_t len, const char* tmpl, std::initializer_list<MessageArg> args) {
+  if (size == 0 || len >= size) return len;
+  MessageOut o = { out, size, len };
+  const char* p = tmpl;
+  while (*p) {
+    if (p[0] == '{' && p[1] >= '0' && p[1] <= '9' && p[2] == '}') {
+      size_t index = p[1] - '0';
+      if (index < args.size() && !putArg(o, args.begin()[index])) break;
+      p += 3;
+      continue;
+    }
+    // Literal run up to the next brace (a brace that starts no placeholder is part of it)
+    const char* run = p++;
+    while (*p && *p != '{') p++;
+    if (!putText(o, run, p - run, false)) break;
+  }
+  if (o.len < size) out[o.len] = '\0';
+  return o.len;
+}
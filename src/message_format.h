@@ -0,0 +1,87 @@
+// Allocation-free message formatting
+//
+// Messages are written into a caller's fixed buffer from the templates in
+// telegram_messages.h (or any template string). "{0}".."{9}" take typed
+// arguments: numbers are converted here, text is HTML-escaped for Telegram's
+// HTML parse mode unless it is passed as markup; other braces are literal.
+// A message that does not fit is cut after a whole UTF-8 character or
+// entity, never inside one. No heap is used, and no printf. Portable, so
+// tools/message_alloc_bench.py builds it on the host.
+
+#ifndef MESSAGE_FORMAT_H
+#define MESSAGE_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <initializer_list>
+#include "telegram_messages.h"
+
+#define MSG_X_ID(id, text) id,
+enum MessageId : uint8_t { TG_MESSAGES(MSG_X_ID) MSG_COUNT };
+#undef MSG_X_ID
+
+struct MessageArg {
+  enum Kind : uint8_t { TEXT, MARKUP, UINT, INT, TENTHS };
+  Kind kind;
+  union {
+    const char* str;
+    uint32_t u;
+    int32_t i;
+  };
+};
+
+inline MessageArg msgText(const char* s) {  // Escaped: names, reports, anything not ours
+  MessageArg a;
+  a.kind = MessageArg::TEXT;
+  a.str = s;
+  return a;
+}
+inline MessageArg msgMarkup(const char* s) {  // Inserted as is: our own labels and tags
+  MessageArg a;
+  a.kind = MessageArg::MARKUP;
+  a.str = s;
+  return a;
+}
+inline MessageArg msgUint(uint32_t v) {
+  MessageArg a;
+  a.kind = MessageArg::UINT;
+  a.u = v;
+  return a;
+}
+inline MessageArg msgInt(int32_t v) {
+  MessageArg a;
+  a.kind = MessageArg::INT;
+  a.i = v;
+  return a;
+}
+inline MessageArg msgTenths(int32_t v) {  // One decimal: 12 -> "1.2", -5 -> "-0.5"
+  MessageArg a;
+  a.kind = MessageArg::TENTHS;
+  a.i = v;
+  return a;
+}
+
+const char* messageTemplate(MessageId id);
+
+// Append the filled template at out[len]. Returns the new length, or size
+// once the message was cut (out is still terminated; later appends do
+// nothing), like snprintf's len >= size.
+size_t appendMessage(char* out, size_t size, size_t len, const char* tmpl,
+                     std::initializer_list<MessageArg> args = {});
+
+inline size_t appendMessage(char* out, size_t size, size_t len, MessageId id,
+                            std::initializer_list<MessageArg> args = {}) {
+  return appendMessage(out, size, len, messageTemplate(id), args);
+}
+
+inline size_t formatMessage(char* out, size_t size, MessageId id, std::initializer_list<MessageArg> args = {}) {
+  if (size > 0) out[0] = '\0';
+  return appendMessage(out, size, 0, messageTemplate(id), args);
+}
+
+inline size_t formatMessage(char* out, size_t size, const char* tmpl, std::initializer_list<MessageArg> args = {}) {
+  if (size > 0) out[0] = '\0';
+  return appendMessage(out, size, 0, tmpl, args);
+}
+
+#endif // MESSAGE_FORMAT_H
@@ -0,0 +1,200 @@
+// Minimal MQTT 3.1.1 client implementation
+
+#include "mqtt_client.h"
+
+#define MQTT_HEADER_MAX 5  // Type byte and up to 4 bytes of remaining length
+
+enum MqttPacket : uint8_t {
+  MQTT_CONNECT = 0x10,
+  MQTT_CONNACK = 0x20,
+  MQTT_PUBLISH = 0x30,
+  MQTT_SUBSCRIBE = 0x82,  // Reserved flag bits 0010
+  MQTT_PINGREQ = 0xC0,
+  MQTT_PINGRESP = 0xD0,
+  MQTT_DISCONNECT = 0xE0
+};
+
+// --- Packet building: the body goes after room for the fixed header ---
+void MqttClient::begin(uint8_t type) {
+  packetType = type;
+  len = MQTT_HEADER_MAX;
+  overflow = false;
+}
+
+bool MqttClient::addBytes(const void* data, size_t n) {
+  if (len + n > sizeof(buf)) {
+    overflow = true;
+    return false;
+  }
+  memcpy(buf + len, data, n);
+  len += n;
+  return true;
+}
+
+bool MqttClient::addString(const char* s) {
+  size_t n = strlen(s);
+  uint8_t prefix[2] = { (uint8_t)(n >> 8), (uint8_t)n };
+  return addBytes(prefix, 2) && addBytes(s, n);
+}
+
+bool MqttClient::send() {
+  if (overflow) return false;
+  uint8_t header[MQTT_HEADER_MAX];
+  size_t headerLen = 0;
+  header[headerLen++] = packetType;
+  size_t remaining = len - MQTT_HEADER_MAX;
+  do {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    header[headerLen++] = digit | (remaining ? 0x80 : 0);
+  } while (remaining);
+  uint8_t* start = buf + MQTT_HEADER_MAX - headerLen;
+  memcpy(start, header, headerLen);
+
+  size_t total = len - (start - buf);
+  if (client.write(start, total) != total) {
+    client.stop();
+    return false;
+  }
+  lastSent = millis();
+  return true;
+}
+
+// --- Packet reading ---
+int MqttClient::readByte(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (client.available() <= 0) {
+    if (!client.connected() || millis() - start >= timeoutMs) return -1;
+    delay(1);
+  }
+  return client.read();
+}
+
+int MqttClient::readPacket(uint32_t timeoutMs) {
+  int type = readByte(timeoutMs);
+  if (type < 0) return -1;
+  uint32_t remaining = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    int b = readByte(timeoutMs);
+    if (b < 0) return -1;
+    remaining |= (uint32_t)(b & 0x7F) << (7 * i);
+    if (!(b & 0x80)) break;
+  }
+  // Keep what fits, one byte spare for a NUL after a payload
+  for (uint32_t i = 0; i < remaining; i++) {
+    int b = readByte(timeoutMs);
+    if (b < 0) return -1;
+    if (i < sizeof(buf) - 1) buf[i] = b;
+  }
+  if (remaining >= sizeof(buf)) return 0;  // Too large, skipped
+  bodyLen = remaining;
+  return type;
+}
+
+bool MqttClient::connect(const char* host, uint16_t port, const char* clientId, const char* user,
+                         const char* password, const MqttWill* will, uint16_t keepAliveS) {
+  connackCode = 0xFF;
+  if (!client.connect(host, port)) return false;
+  keepAliveMs = keepAliveS * 1000UL;
+  pingPending = false;
+
+  static const uint8_t protocol[] = { 0, 4, 'M', 'Q', 'T', 'T', 4 };  // Level 4 = 3.1.1
+  bool login = user != nullptr && user[0] != '\0';
+  uint8_t flags = 0x02;  // Clean session
+  if (will) flags |= 0x04 | 0x20;  // Will, retained, QoS 0
+  if (login) flags |= 0x80 | (password ? 0x40 : 0);
+  uint8_t keepAlive[2] = { (uint8_t)(keepAliveS >> 8), (uint8_t)keepAliveS };
+
+  begin(MQTT_CONNECT);
+  addBytes(protocol, sizeof(protocol));
+  addBytes(&flags, 1);
+  addBytes(keepAlive, 2);
+  addString(clientId);
+  if (will) {
+    addString(will->topic);
+    addString(will->payload);
+  }
+  if (login) {
+    addString(user);
+    if (password) addString(password);
+  }
+  if (!send()) {
+    client.stop();
+    return false;
+  }
+
+  int type = readPacket(MQTT_TIMEOUT_MS);
+  if (type == MQTT_CONNACK && bodyLen >= 2) connackCode = buf[1];
+  if (connackCode != 0) {
+    client.stop();
+    return false;
+  }
+  return true;
+}
+
+bool MqttClient::publish(const char* topic, const char* payload, bool retain) {
+  begin(MQTT_PUBLISH | (retain ? 0x01 : 0));
+  addString(topic);
+  addBytes(payload, strlen(payload));
+  return send();
+}
+
+bool MqttClient::subscribe(const char* topic) {
+  if (++packetId == 0) packetId = 1;
+  uint8_t id[2] = { (uint8_t)(packetId >> 8), (uint8_t)packetId };
+  uint8_t qos = 0;
+  begin(MQTT_SUBSCRIBE);
+  addBytes(id, 2);
+  addString(topic);
+  addBytes(&qos, 1);
+  return send();
+}
+
+bool MqttClient::poll() {
+  if (!client.connected()) return false;
+
+  while (client.available() > 0) {
+    int type = readPacket(MQTT_TIMEOUT_MS);
+    if (type < 0) {
+      client.stop();
+      return false;
+    }
+    if ((type & 0xF0) == MQTT_PUBLISH && bodyLen >= 2) {
+      size_t topicLen = (buf[0] << 8) | buf[1];
+      size_t payloadAt = 2 + topicLen + (((type >> 1) & 0x03) ? 2 : 0);  // Packet id above QoS 0
+      if (payloadAt > bodyLen) continue;
+      // Topic moved down over its length prefix to make room for its NUL
+      memmove(buf, buf + 2, topicLen);
+      buf[topicLen] = '\0';
+      buf[bodyLen] = '\0';
+      bool retained = type & 0x01;
+      if (handler) handler((const char*)buf, (const char*)buf + payloadAt, bodyLen - payloadAt, retained);
+    } else if (type == MQTT_PINGRESP) {
+      pingPending = false;
+    }
+  }
+
+  uint32_t now = millis();
+  if (pingPending && now - pingSentAt >= MQTT_TIMEOUT_MS) {
+    client.stop();
+    return false;
+  }
+  if (!pingPending && keepAliveMs > 0 && now - lastSent >= keepAliveMs / 4 * 3) {
+    begin(MQTT_PINGREQ);
+    if (!send()) return false;
+    pingPending = true;
+    pingSentAt = now;
+  }
+  return true;
+}
+
+bool MqttClient::connected() {
+  return client.connected();
+}
+
+void MqttClient::disconnect() {
+  if (!client.connected()) return;
+  begin(MQTT_DISCONNECT);
+  send();
+  client.stop();
+}
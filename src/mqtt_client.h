@@ -0,0 +1,67 @@
+// Minimal MQTT 3.1.1 client
+//
+// QoS 0 only: CONNECT (clean session, optional will and login), PUBLISH
+// with or without retain, SUBSCRIBE, and PINGREQ when nothing else was
+// sent for three quarters of the keepalive. Packets are built and read in
+// one MQTT_PACKET_MAX buffer; larger incoming ones are skipped. Works on any
+// Arduino Client, so it can be pointed at a local broker or a fake
+// (tools/mqtt_host_test.py runs it on the host against one).
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "pomodoro_config.h"
+
+// retained: the broker replayed a stored message because of a new
+// subscription, rather than forwarding one published just now
+typedef void (*MqttMessageHandler)(const char* topic, const char* payload, size_t len, bool retained);
+
+struct MqttWill {
+  const char* topic;
+  const char* payload;  // Published retained by the broker if the connection drops
+};
+
+class MqttClient {
+ public:
+  explicit MqttClient(Client& client) : client(client) {}
+
+  // Open the TCP connection and wait for CONNACK. user and will may be nullptr.
+  bool connect(const char* host, uint16_t port, const char* clientId, const char* user,
+               const char* password, const MqttWill* will, uint16_t keepAliveS);
+  bool publish(const char* topic, const char* payload, bool retain);
+  bool subscribe(const char* topic);
+  void onMessage(MqttMessageHandler handler) { this->handler = handler; }
+
+  // Handle what the broker sent and keep the connection alive. false once
+  // it is gone (closed, or no PINGRESP within MQTT_TIMEOUT_MS).
+  bool poll();
+  bool connected();
+  void disconnect();
+  uint8_t returnCode() const { return connackCode; }  // Of the last CONNACK, 0 = accepted
+
+ private:
+  void begin(uint8_t type);
+  bool addBytes(const void* data, size_t len);
+  bool addString(const char* s);
+  bool send();
+  int readByte(uint32_t timeoutMs);
+  int readPacket(uint32_t timeoutMs);  // Packet type, body in buf (bodyLen), -1 on error
+
+  Client& client;
+  MqttMessageHandler handler = nullptr;
+  uint8_t buf[MQTT_PACKET_MAX];
+  uint8_t packetType = 0;   // Packet being built: first byte and the body from buf[5]
+  size_t len = 0;
+  bool overflow = false;
+  size_t bodyLen = 0;       // Packet read
+  uint16_t packetId = 0;
+  uint8_t connackCode = 0;
+  uint32_t keepAliveMs = 0;
+  uint32_t lastSent = 0;
+  uint32_t pingSentAt = 0;
+  bool pingPending = false;
+};
+
+#endif // MQTT_CLIENT_H
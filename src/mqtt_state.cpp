@@ -0,0 +1,180 @@
+// Timer state over MQTT implementation
+
+#include "mqtt_state.h"
+#include "mqtt_client.h"
+#include "pomodoro_globals.h"
+#include "timer_logic.h"
+#include "remote_commands.h"
+#include "display_graphics.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "deferred_log.h"
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+struct MqttState {
+  uint8_t state;          // TimerState
+  uint8_t work;
+  uint8_t mode;           // PomodoroMode
+  uint8_t battery;        // Percent, BATTERY_UNKNOWN before a reading
+  uint32_t remainingS;    // Rounded up to MQTT_REMAINING_STEP_S
+};
+
+static QueueHandle_t stateQueue = nullptr;  // Loop -> MQTT task, newest snapshot only
+static MqttState lastQueued;                // Loop's copy
+
+// --- Helper: full topic name under the prefix ---
+static const char* topic(char* out, size_t size, const char* name) {
+  snprintf(out, size, MQTT_TOPIC_PREFIX "/%s", name);
+  return out;
+}
+
+// A retained cmd comes back on every subscribe, so after each reconnect;
+// only commands published while connected are run
+static void onCommand(const char* topicName, const char* payload, size_t len, bool retained) {
+  char word[16];
+  size_t n = 0;
+  while (n < len && n < sizeof(word) - 1 && payload[n] >= 'a' && payload[n] <= 'z') {
+    word[n] = payload[n];
+    n++;
+  }
+  word[n] = '\0';
+  if (retained) {
+    LOG(LOG_MQTT_RETAINED_CMD, word);
+    return;
+  }
+  if (queueRemoteCommand(word)) LOG(LOG_MQTT_COMMAND, word);
+}
+
+// --- Helper: publish the topics that differ from sent; all when force ---
+static bool publishChanged(MqttClient& mqtt, const MqttState& s, MqttState& sent, bool force) {
+  static const char* const stateNames[] = { "stopped", "running", "paused" };
+  static const char* const modeNames[] = { "1/1", "25/5", "50/10" };
+  char name[48];
+  char value[12];
+  if (force || s.state != sent.state) {
+    if (!mqtt.publish(topic(name, sizeof(name), "state"), stateNames[s.state], true)) return false;
+  }
+  if (force || s.work != sent.work) {
+    if (!mqtt.publish(topic(name, sizeof(name), "session"), s.work ? "work" : "rest", true)) return false;
+  }
+  if (force || s.mode != sent.mode) {
+    if (!mqtt.publish(topic(name, sizeof(name), "mode"), modeNames[s.mode], true)) return false;
+  }
+  if (force || s.remainingS != sent.remainingS) {
+    snprintf(value, sizeof(value), "%lu", (unsigned long)s.remainingS);
+    if (!mqtt.publish(topic(name, sizeof(name), "remaining"), value, true)) return false;
+  }
+  if (s.battery != BATTERY_UNKNOWN && (force || s.battery != sent.battery)) {
+    snprintf(value, sizeof(value), "%u", s.battery);
+    if (!mqtt.publish(topic(name, sizeof(name), "battery"), value, true)) return false;
+  }
+  sent = s;
+  return true;
+}
+
+// --- Helper: one batched telemetry message ---
+static bool publishTelemetry(MqttClient& mqtt, uint32_t& framesAtLast, uint32_t reconnects) {
+  char name[48];
+  char json[224];
+  uint32_t frames = displayFramesDrawn();
+  snprintf(json, sizeof(json),
+           "{\"uptime_s\":%lu,\"heap_free\":%lu,\"heap_min\":%lu,\"heap_max_block\":%lu,\"rssi\":%d,"
+           "\"frames\":%lu,\"reconnects\":%lu,\"battery_mv\":%u,\"battery_sample_us_per_s\":%lu}",
+           (unsigned long)(millis() / 1000), (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+           (unsigned long)ESP.getMaxAllocHeap(), (int)WiFi.RSSI(), (unsigned long)(frames - framesAtLast),
+           (unsigned long)reconnects, batteryMillivolts(), (unsigned long)batteryCpuUsPerS());
+  framesAtLast = frames;
+  return mqtt.publish(topic(name, sizeof(name), "telemetry"), json, false);
+}
+
+// --- Helper: connect with the will, announce, subscribe ---
+static bool connectBroker(MqttClient& mqtt) {
+  char clientId[24];
+  char willTopic[48];
+  char name[48];
+  snprintf(clientId, sizeof(clientId), "pomodoro-%06lx", (unsigned long)(ESP.getEfuseMac() & 0xFFFFFF));
+  MqttWill will = { topic(willTopic, sizeof(willTopic), "availability"), "offline" };
+  const char* password = MQTT_PASSWORD[0] ? MQTT_PASSWORD : nullptr;
+  if (!mqtt.connect(MQTT_HOST, MQTT_PORT, clientId, MQTT_USER, password, &will, MQTT_KEEPALIVE_S)) {
+    LOG(LOG_MQTT_CONNECT_FAILED, (uint32_t)mqtt.returnCode());
+    return false;
+  }
+  if (!mqtt.publish(willTopic, "online", true) || !mqtt.subscribe(topic(name, sizeof(name), "cmd"))) return false;
+  LOG(LOG_MQTT_CONNECTED, clientId);
+  return true;
+}
+
+static void mqttTask(void* parameter) {
+  WiFiClient net;
+  MqttClient mqtt(net);
+  mqtt.onMessage(onCommand);
+
+  MqttState current = lastQueued;
+  MqttState sent;
+  bool online = false;
+  uint32_t lastAttempt = 0;
+  bool attempted = false;
+  uint32_t lastTelemetry = millis();
+  uint32_t framesAtLast = displayFramesDrawn();
+  uint32_t reconnects = 0;
+
+  while (true) {
+    // Blocks here between socket checks, which lets the CPU idle
+    MqttState s;
+    if (xQueueReceive(stateQueue, &s, pdMS_TO_TICKS(MQTT_POLL_MS)) == pdTRUE) current = s;
+
+    uint32_t now = millis();
+    if (!online) {
+      if (attempted && now - lastAttempt < MQTT_RECONNECT_MS) continue;
+      if (WiFi.status() != WL_CONNECTED) continue;
+      lastAttempt = now;
+      if (attempted) reconnects++;
+      attempted = true;
+      if (!connectBroker(mqtt) || !publishChanged(mqtt, current, sent, true)) {
+        mqtt.disconnect();
+        continue;
+      }
+      online = true;
+    }
+
+    bool ok = mqtt.poll() && publishChanged(mqtt, current, sent, false);
+    if (ok && now - lastTelemetry >= MQTT_TELEMETRY_MS) {
+      lastTelemetry = now;
+      ok = publishTelemetry(mqtt, framesAtLast, reconnects);
+    }
+    if (!ok) {
+      LOG(LOG_MQTT_DISCONNECTED);
+      mqtt.disconnect();
+      online = false;
+    }
+  }
+}
+
+void startMqtt() {
+  if (MQTT_HOST[0] == '\0' || WiFi.status() != WL_CONNECTED) return;
+  stateQueue = xQueueCreate(1, sizeof(MqttState));
+  memset(&lastQueued, 0xFF, sizeof(lastQueued));  // First publish always differs
+  publishMqttState();
+  xTaskCreatePinnedToCore(mqttTask, "MqttTask", 4096, NULL, 1, NULL, 0);
+  Serial.println("MQTT task created for " MQTT_HOST);
+}
+
+void publishMqttState() {
+  if (stateQueue == nullptr) return;
+  MqttState s = lastQueued;
+  unsigned long duration = getCurrentDuration();
+  unsigned long elapsed = (currentState == RUNNING) ? (unsigned long)(appMillis64() - startTime)
+                        : (currentState == PAUSED) ? elapsedBeforePause : 0;
+  const unsigned long step = MQTT_REMAINING_STEP_S * 1000UL;
+  s.state = currentState;
+  s.work = isWorkSession;
+  s.mode = currentMode;
+  s.battery = batteryPercent();
+  s.remainingS = (elapsed < duration) ? (duration - elapsed + step - 1) / step * MQTT_REMAINING_STEP_S : 0;
+  if (memcmp(&s, &lastQueued, sizeof(s)) == 0) return;
+  lastQueued = s;
+  xQueueOverwrite(stateQueue, &s);
+}
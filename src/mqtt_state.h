@@ -0,0 +1,47 @@
+// Timer state over MQTT
+//
+// Retained topics under MQTT_TOPIC_PREFIX, so a new subscriber gets the
+// current values at once:
+//
+//   <prefix>/availability  "online", or "offline" from the broker (will)
+//   <prefix>/state         "stopped", "running" or "paused"
+//   <prefix>/session       "work" or "rest"
+//   <prefix>/mode          "1/1", "25/5" or "50/10"
+//   <prefix>/remaining     Seconds left, in MQTT_REMAINING_STEP_S steps
+//   <prefix>/battery       State of charge in percent (battery.h)
+//   <prefix>/telemetry     JSON every MQTT_TELEMETRY_MS: uptime, heap,
+//                          RSSI, frames drawn, reconnects, battery
+//                          voltage and sampling cost (not retained)
+//
+// <prefix>/cmd takes "start", "pause", "resume", "stop" or "mode" and runs it
+// like the Telegram commands. A retained cmd is not run: the broker would
+// replay it on every reconnect. Only changed topics are published, from a task
+// holding one persistent connection. Against a local broker:
+//
+//   mosquitto -v
+//   mosquitto_sub -t 'pomodoro/#' -v
+//   mosquitto_pub -t pomodoro/cmd -m start
+
+#ifndef MQTT_STATE_H
+#define MQTT_STATE_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+#ifndef MQTT_HOST
+  #define MQTT_HOST ""  // Empty: MQTT stays off
+#endif
+#ifndef MQTT_USER
+  #define MQTT_USER ""
+#endif
+#ifndef MQTT_PASSWORD
+  #define MQTT_PASSWORD ""
+#endif
+
+// Start the MQTT task once WiFi is up, if MQTT_HOST is set
+void startMqtt();
+
+// Loop side: hand the task the timer state when a topic would change
+void publishMqttState();
+
+#endif // MQTT_STATE_H
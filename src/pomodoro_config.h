@@ -3,7 +3,11 @@
 #ifndef POMODORO_CONFIG_H
 #define POMODORO_CONFIG_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>  // Host builds of the portable modules (http_server.cpp)
+#endif
 
 // Backlight pin (official: GPIO23 = LCD_BL)
 #define GFX_BL 23
@@ -11,6 +15,192 @@
 // Rotation (0 = portrait, like official demo)
 #define ROTATION 0
 
+// Render into an 8-bit indexed canvas (~55 KB) that is flushed to the panel,
+// instead of drawing straight to it. The UI color lives in palette slots,
+// so a work/rest color swap is a palette edit, not a redraw.
+#define USE_INDEXED_CANVAS 1
+
+// Hash every canvas row sent to the panel and skip the ones a redraw leaves
+// identical (pause/resume redraws are mostly unchanged). ~1.6 KB of RAM.
+#define USE_ROW_HASH_FLUSH 1
+
+// Deferred logging (deferred_log.h): messages up to LOG_LEVEL from the
+// modules in LOG_TAG_MASK are kept, the rest compile away. Binary frames are
+// turned back into text on the host by tools/decode_log.py; set
+// LOG_BINARY_OUTPUT to 0 to format on the device (in the drain task) instead.
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_TAG_MASK 0x7FF  // One bit per LogTag
+#define LOG_BINARY_OUTPUT 1
+
+// Cycle-counter probes on the loop stages and GFX primitives (profiler.h).
+// Switched on by -DGFX_PROFILE in platformio.ini so the library sees it too.
+#ifdef GFX_PROFILE
+#define USE_PROFILER 1
+#else
+#define USE_PROFILER 0
+#endif
+
+// Hot render and touch paths run from IRAM instead of through the flash
+// cache (HOT_IRAM_ATTR here, GFX_IRAM_ATTR in the library). Switched on by
+// -DGFX_IRAM_HOT; tools/iram_report.py checks the cost against a budget.
+#ifdef GFX_IRAM_HOT
+#define HOT_IRAM_ATTR IRAM_ATTR
+#else
+#define HOT_IRAM_ATTR
+#endif
+
+// Input recording (input_trace.h): 't' on Serial starts/stops recording and
+// reports per-interaction latency, 'd' dumps the trace for
+// tools/trace_replay.py. The trace buffer (12 bytes per event) is only
+// allocated when recording first starts.
+#define USE_INPUT_TRACE 1
+#define TRACE_CAPACITY 2048
+
+// Session history (session_log.h): 16-byte records appended to a raw data
+// partition used as a ring of 4 KB sectors (256 sessions each). The default
+// partition table's "spiffs" partition is otherwise unused.
+#define SESSION_LOG_PARTITION "spiffs"
+#define SESSION_LOG_MAX_SECTORS 16      // 4096 sessions, bounds boot recovery too
+#define SESSION_STATS_SCAN_MAX 512      // Records read to rebuild the week totals
+#define SESSION_WRITE_QUEUE 4           // Ended sessions waiting for the writer task
+
+// microSD slot: shares SCK/MOSI with the LCD and has its own CS and MISO
+// (pins as in Waveshare's 03_sd_card_test example). /export writes the
+// session history (and profile.csv when profiling) to SD_EXPORT_DIR.
+#define USE_SD_EXPORT 1
+#define SD_CS 4
+#define SD_MISO 3
+#define SD_SPI_FREQ 20000000
+#define SD_EXPORT_DIR "/pomodoro"
+#define SD_BLOCK_ESTIMATE_US 10000  // First guess for a 4 KB write, then measured
+#define SD_FRAME_MARGIN_MS 5        // Slack left before the next display frame
+
+// POSIX TZ string for NTP time, decides where days and weeks begin
+#define TIMEZONE "UTC0"
+
+// Telegram polling (telegram_updates.h): updates requested per getUpdates
+// call and bytes of message text kept (commands are short, longer text is cut)
+#define TG_UPDATES_PER_POLL 4
+#define TG_TEXT_MAX 64
+
+// Boot backlog drain: commands older than this when the device comes up are
+// confirmed without running; bounded number of getUpdates calls
+#define TG_STALE_COMMAND_S 120
+#define TG_DRAIN_MAX_REQUESTS 4
+#define TG_DRAIN_TIMEOUT_MS 3000
+
+// Command replies (message_format.h) are formatted into TG_REPLY_MAX bytes
+// on the task stack and posted on the task's own connection
+#define TG_POLL_TIMEOUT_MS 5000
+#define TG_REPLY_MAX 640
+#define TG_REPLY_TIMEOUT_MS 5000
+
+// Live status (telegram_status.h): one pinned message edited in place instead
+// of a message per timer event. The time left is shown in TG_STATUS_COARSE_MIN
+// steps, per minute in the last TG_STATUS_FINE_MIN minutes.
+#define TG_LIVE_STATUS 1
+#define TG_STATUS_CHECK_MS 15000      // Re-render while running
+#define TG_STATUS_MIN_GAP_MS 3000     // Between API calls; bursts of events coalesce
+#define TG_STATUS_COARSE_MIN 5
+#define TG_STATUS_FINE_MIN 5
+#define TG_STATUS_TEXT_MAX 160
+#define TG_STATUS_TIMEOUT_MS 5000
+
+// Notification fan-out (telegram_fanout.h): chats that sent /subscribe get
+// notifications besides TELEGRAM_CHAT_ID. Requests are pipelined a few at a
+// time on one connection, within Telegram's limits of about one message per
+// second per chat and 30 per second overall.
+#define TG_MAX_SUBSCRIBERS 8
+#define TG_PIPELINE_DEPTH 4
+#define TG_CHAT_MIN_GAP_MS 1000
+#define TG_FANOUT_MAX_PER_S 30
+#define TG_FANOUT_MAX_TRIES 3      // Per recipient before the notification is dropped for it
+#define TG_FANOUT_TIMEOUT_MS 5000
+
+// HTTP API (http_api.h) on the LAN: GET /state, POST /cmd, GET /events (SSE).
+// Memory is fixed: HTTP_MAX_CLIENTS connections with one request and one
+// response buffer each; at most HTTP_MAX_CLIENTS - 1 of them are streams.
+#define HTTP_API 1
+#define HTTP_PORT 80
+#define HTTP_MAX_CLIENTS 4
+#define HTTP_REQUEST_MAX 512        // Request head and body
+#define HTTP_RESPONSE_MAX 512       // Response, or the events a stream has not taken yet
+#define HTTP_EVENT_MAX 256
+#define HTTP_PIPELINE_MAX 8         // Pipelined requests answered per connection and poll() round
+#define HTTP_POLL_MS 20             // select() period, bounds the event latency
+#define HTTP_IDLE_MS 5000           // Keep-alive connections without a request are closed
+#define HTTP_SSE_PING_MS 15000      // Comment line that keeps idle streams open
+
+// MQTT (mqtt_state.h): state on retained topics under MQTT_TOPIC_PREFIX,
+// commands from <prefix>/cmd, telemetry batched into one message. Started
+// when MQTT_HOST is set (build flag). The keepalive is long so an idle
+// connection only wakes the radio from light sleep for a ping every
+// 3/4 of it; the task blocks on the state queue between socket checks.
+#define MQTT_PORT 1883
+#define MQTT_TOPIC_PREFIX "pomodoro"
+#define MQTT_KEEPALIVE_S 120
+#define MQTT_TIMEOUT_MS 5000        // CONNACK and PINGRESP
+#define MQTT_RECONNECT_MS 15000
+#define MQTT_POLL_MS 250            // Socket check for commands while idle
+#define MQTT_REMAINING_STEP_S 60    // Remaining time is published in these steps
+#define MQTT_TELEMETRY_MS 60000
+#define MQTT_PACKET_MAX 256
+
+// Battery monitor (battery.h): the continuous ADC driver samples BAT_PIN into
+// a DMA ring at its lowest rate with large frames, so the CPU only sees a few
+// interrupts a second; the loop drains the ring every BATTERY_READ_MS through
+// a median of BATTERY_MEDIAN_N and a 1/2^BATTERY_IIR_SHIFT IIR (fixed point).
+// 'b' on Serial prints the reading and the CPU time sampling takes.
+#define USE_BATTERY_MONITOR 1
+#define BAT_PIN 0                   // ADC1 channel 0, behind a 1:3 divider (official example)
+#define BATTERY_DIVIDER 3
+#define BATTERY_SAMPLE_HZ 611       // SOC_ADC_SAMPLE_FREQ_THRES_LOW on the C6
+#define BATTERY_FRAME_BYTES 512     // 128 samples per DMA frame, ~5 interrupts/s
+#define BATTERY_POOL_BYTES 1024     // Frames kept for the loop; older ones are flushed
+#define BATTERY_READ_MS 1000
+#define BATTERY_MEDIAN_N 5
+#define BATTERY_IIR_SHIFT 7
+#define BATTERY_LOW_PCT 15          // Shown in red below this
+
+// Backlight (backlight.h): LEDC PWM on GFX_BL with hardware fades. Levels
+// are perceived brightness in percent, gamma-corrected (2.2, a table in
+// backlight.cpp) to duty. Full after
+// touch, IMU motion or a timer state change (a session ending included),
+// dim after BACKLIGHT_DIM_MS without one, lower still after BACKLIGHT_IDLE_MS
+// when the timer is not running. At night the ceiling is BACKLIGHT_NIGHT_PCT.
+// 'l' on Serial prints the estimated backlight current per timer state.
+#define USE_BACKLIGHT_PWM 1
+#define BACKLIGHT_PWM_HZ 10000
+#define BACKLIGHT_PWM_BITS 12
+#define BACKLIGHT_ACTIVE_PCT 100
+#define BACKLIGHT_DIM_PCT 30
+#define BACKLIGHT_IDLE_PCT 10
+#define BACKLIGHT_DIM_MS 20000
+#define BACKLIGHT_IDLE_MS 120000
+#define BACKLIGHT_WAKE_FADE_MS 120
+#define BACKLIGHT_DIM_FADE_MS 1500
+#define BACKLIGHT_NIGHT_START_H 22  // Local time, once NTP has synced
+#define BACKLIGHT_NIGHT_END_H 7
+#define BACKLIGHT_NIGHT_PCT 40
+#define BACKLIGHT_MOTION_MG 150     // Change between IMU samples that counts as motion
+#define BACKLIGHT_MOTION_CHECK_MS 250  // IMU sample period while dimmed
+#define BACKLIGHT_FULL_MA 25        // LED current at full duty, for the estimate
+
+// Memory telemetry (mem_telemetry.h): internal and DMA heap, largest free
+// block and the app tasks' stack high-water marks, sampled from the loop.
+// Minima are kept since boot and over a rolling MEM_BUCKETS x MEM_BUCKET_MS.
+// A warning is logged when the heap gets too small or too fragmented for a
+// TLS handshake (mbedTLS takes a 16 KB record buffer plus ~20 KB in
+// pieces), before WiFiClientSecure fails. 'h' on Serial, /perf on Telegram
+// and HTTP print the report.
+#define USE_MEM_TELEMETRY 1
+#define MEM_SAMPLE_MS 2000
+#define MEM_BUCKET_MS 300000
+#define MEM_BUCKETS 12              // Rolling minima over the last hour
+#define MEM_TLS_MIN_FREE 45000
+#define MEM_TLS_MIN_BLOCK 20000
+#define MEM_STACK_WARN_BYTES 512
+
 // Touch pins from official Waveshare LVGL example
 #define TP_SDA 18
 #define TP_SCL 19
@@ -35,7 +225,8 @@ const unsigned long SHORT_TAP_BLOCK_MS = 1500;  // Block short taps for 1.5s aft
 const unsigned long TP_INT_DEBOUNCE_MS = 200;  // Ignore brief HIGH pulses
 const unsigned long TAP_INDICATOR_DURATION = 500;  // ms
 const unsigned long ROTATION_CHECK_INTERVAL = 2000;  // Check every 2 seconds
-const float ROTATION_THRESHOLD = 0.5;  // Threshold in g for rotation detection
+const int32_t ROTATION_THRESHOLD_MG = 500;  // Threshold in milli-g for rotation detection
+const unsigned long SETTINGS_COMMIT_DELAY_MS = 3000;  // Settings are written after 3s without changes
 
 // Touch padding
 const int16_t TOUCH_PADDING = 15;  // 15px extra on each side
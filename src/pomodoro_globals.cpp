@@ -6,12 +6,27 @@
 #include <Arduino_GFX_Library.h>
 
 // Display objects
+#if USE_SD_EXPORT
+Arduino_DataBus *bus = new Arduino_HWSPI(15 /* DC */, 14 /* CS */, 1 /* SCK */, 2 /* MOSI */, SD_MISO /* MISO, SD card only */);
+#else
 Arduino_DataBus *bus = new Arduino_HWSPI(15 /* DC */, 14 /* CS */, 1 /* SCK */, 2 /* MOSI */);
+#endif
+#if USE_INDEXED_CANVAS
+Arduino_GFX *lcd = new Arduino_ST7789(
+  bus, 22 /* RST */, 0 /* rotation */, false /* IPS */,
+  172 /* width */, 320 /* height */,
+  34 /*col_offset1*/, 0 /*uint8_t row_offset1*/,
+  34 /*col_offset2*/, 0 /*row_offset2*/);
+// All drawing goes to the canvas; the panel always stays at rotation 0
+Arduino_Canvas_Indexed *canvas = new Arduino_Canvas_Indexed(172 /* width */, 320 /* height */, lcd);
+Arduino_GFX *gfx = canvas;
+#else
 Arduino_GFX *gfx = new Arduino_ST7789(
   bus, 22 /* RST */, 0 /* rotation */, false /* IPS */,
   172 /* width */, 320 /* height */,
   34 /*col_offset1*/, 0 /*uint8_t row_offset1*/,
   34 /*col_offset2*/, 0 /*row_offset2*/);
+#endif
 
 Preferences preferences;
 
@@ -21,10 +36,10 @@ PomodoroMode currentMode = MODE_25_5;
 uint8_t currentViewMode = 0;
 bool gridViewActive = false;
 bool isWorkSession = true;
-unsigned long startTime = 0;
-unsigned long pausedTime = 0;
+uint64_t startTime = 0;
+uint64_t pausedTime = 0;
 unsigned long elapsedBeforePause = 0;
-unsigned long timerStartTime = 0;
+uint64_t timerStartTime = 0;
 
 // Display state
 bool displayInitialized = false;
@@ -12,6 +12,10 @@
 // Forward declarations
 extern Arduino_GFX *gfx;
 extern Arduino_DataBus *bus;
+#if USE_INDEXED_CANVAS
+extern Arduino_GFX *lcd;
+extern Arduino_Canvas_Indexed *canvas;
+#endif
 extern Preferences preferences;
 
 // Timer state
@@ -20,10 +24,10 @@ extern PomodoroMode currentMode;
 extern uint8_t currentViewMode;
 extern bool gridViewActive;
 extern bool isWorkSession;
-extern unsigned long startTime;
-extern unsigned long pausedTime;
+extern uint64_t startTime;        // appMillis64()
+extern uint64_t pausedTime;
 extern unsigned long elapsedBeforePause;
-extern unsigned long timerStartTime;
+extern uint64_t timerStartTime;
 
 // Display state
 extern bool displayInitialized;
@@ -0,0 +1,205 @@
+// Scoped cycle-counter profiler implementation
+
+#include "profiler.h"
+
+#if USE_PROFILER
+
+#include "soc/soc_caps.h"
+
+#define PROFILE_BUCKETS 32  // Bucket b holds samples in [2^b, 2^(b+1)) cycles
+#define PROFILE_PROBE_COUNT (PROF_APP_COUNT + GFX_PROBE_COUNT)
+
+struct ProfileHistogram {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  uint32_t buckets[PROFILE_BUCKETS];
+  uint32_t instrCount;       // Stall mode: calls measured in instructions
+  uint64_t totalInstructions;
+};
+
+static ProfileHistogram profileStats[PROFILE_PROBE_COUNT];
+
+// Performance counter event select (mpcer): bit 0 cycles, bit 1 retired
+// instructions. The cycle count the probes read is whatever it selects.
+#define PROFILE_EVENT_CYCLES 0x1
+#define PROFILE_EVENT_INSTRUCTIONS 0x2
+
+static bool profileStallMode = false;
+static bool profileCountingInstructions = false;  // This pass counts instructions
+
+#define PROFILE_X_NAME(id, name) name,
+static const char* const profileNames[PROFILE_PROBE_COUNT] = {
+  PROFILE_PROBES(PROFILE_X_NAME)
+  // Same order as gfx_probe_t
+  "gfx fillScreen",
+  "gfx fillRect",
+  "gfx drawRect",
+  "gfx drawFastHLine",
+  "gfx drawFastVLine",
+  "gfx fillRing",
+  "gfx fillArcQ16",
+  "gfx draw16bitRGB",
+  "gfx write (char)",
+  "gfx getTextBounds",
+  "gfx canvas flush"
+};
+
+void profileRecord(uint8_t probe, uint32_t cycles) {
+  ProfileHistogram& h = profileStats[probe];
+  if (profileCountingInstructions) {
+    h.instrCount++;
+    h.totalInstructions += cycles;
+    return;
+  }
+  if (h.count == 0 || cycles < h.minCycles) h.minCycles = cycles;
+  if (cycles > h.maxCycles) h.maxCycles = cycles;
+  h.count++;
+  h.totalCycles += cycles;
+  h.buckets[cycles ? 31 - __builtin_clz(cycles) : 0]++;
+}
+
+// Called by the GFX library for its primitives (Arduino_GFX_Profile.h)
+void gfx_profile_record(uint8_t probe, uint32_t cycles) {
+  profileRecord(PROF_APP_COUNT + probe, cycles);
+}
+
+void resetProfile() {
+  memset(profileStats, 0, sizeof(profileStats));
+}
+
+// --- Helper: select what the counter behind esp_cpu_get_cycle_count() counts ---
+static void profileSelectEvent(uint32_t event) {
+#if defined(__riscv) && SOC_CPU_HAS_CSR_PC
+  __asm__ volatile("csrw 0x7e0, %0" : : "r"(event));
+#else
+  (void)event;
+#endif
+}
+
+void profileNextPass() {
+  if (!profileStallMode) return;
+  profileCountingInstructions = !profileCountingInstructions;
+  profileSelectEvent(profileCountingInstructions ? PROFILE_EVENT_INSTRUCTIONS : PROFILE_EVENT_CYCLES);
+}
+
+// --- Helper: stall mode on or off; off always leaves the counter on cycles ---
+static bool setProfileStallMode(bool enable) {
+#if defined(__riscv) && SOC_CPU_HAS_CSR_PC
+  profileStallMode = enable;
+  profileCountingInstructions = false;
+  profileSelectEvent(PROFILE_EVENT_CYCLES);
+  return true;
+#else
+  return !enable;
+#endif
+}
+
+// --- Helper: cycles at quantile q (percent), interpolated inside its bucket ---
+static uint32_t profilePercentile(const ProfileHistogram& h, uint8_t q) {
+  uint32_t rank = (uint32_t)(((uint64_t)h.count * q + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < PROFILE_BUCKETS; b++) {
+    if (h.buckets[b] == 0) continue;
+    if (seen + h.buckets[b] >= rank) {
+      uint32_t lo = (b == 0) ? 0 : (1UL << b);
+      uint32_t hi = (b == 31) ? 0xFFFFFFFFUL : ((1UL << (b + 1)) - 1);
+      if (lo < h.minCycles) lo = h.minCycles;
+      if (hi > h.maxCycles) hi = h.maxCycles;
+      return lo + (uint32_t)((uint64_t)(hi - lo) * (rank - seen) / h.buckets[b]);
+    }
+    seen += h.buckets[b];
+  }
+  return h.maxCycles;
+}
+
+// --- Helper: cycles to microseconds with one decimal, as text ---
+static String profileMicros(uint64_t cycles) {
+  uint32_t mhz = getCpuFrequencyMhz();
+  uint32_t tenths = (uint32_t)(cycles * 10 / mhz);
+  return String(tenths / 10) + "." + String(tenths % 10);
+}
+
+// --- Helper: average cycles per call not covered by retired instructions ---
+static uint64_t profileStallCycles(const ProfileHistogram& h) {
+  uint64_t avgCycles = h.totalCycles / h.count;
+  uint64_t avgInstructions = h.totalInstructions / h.instrCount;
+  return (avgCycles > avgInstructions) ? avgCycles - avgInstructions : 0;
+}
+
+// --- Helper: where the hot paths run from, so reports of both builds can be told apart ---
+static const char* profilePlacement() {
+#ifdef GFX_IRAM_HOT
+  return "hot paths in IRAM";
+#else
+  return "hot paths in flash";
+#endif
+}
+
+// --- Helper: one report line per probe that has samples ---
+static String profileLine(uint8_t probe) {
+  const ProfileHistogram& h = profileStats[probe];
+  String line = profileNames[probe];
+  while (line.length() < 20) line += ' ';
+  line += " n=" + String(h.count);
+  line += " min=" + profileMicros(h.minCycles);
+  line += " p50=" + profileMicros(profilePercentile(h, 50));
+  line += " p99=" + profileMicros(profilePercentile(h, 99));
+  line += " max=" + profileMicros(h.maxCycles);
+  line += " avg=" + profileMicros(h.totalCycles / h.count);
+  if (h.instrCount > 0) line += " stall=" + profileMicros(profileStallCycles(h));
+  return line;
+}
+
+void printProfileReport(Print& out) {
+  out.println("[PROF] times in us, " + String(profilePlacement()));
+  for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++) {
+    if (profileStats[i].count == 0) continue;
+    out.println(profileLine(i));
+  }
+}
+
+String profileReport() {
+  String report = "times in us, " + String(profilePlacement()) + "\n";
+  for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++) {
+    if (profileStats[i].count == 0) continue;
+    report += profileLine(i) + "\n";
+  }
+  return report;
+}
+
+// Same numbers as the report, one CSV row per probe (for the SD export)
+void printProfileCsv(Print& out) {
+  out.print("probe,count,min_us,p50_us,p99_us,max_us,avg_us,stall_us\n");
+  for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++) {
+    const ProfileHistogram& h = profileStats[i];
+    if (h.count == 0) continue;
+    out.print(String(profileNames[i]) + "," + String(h.count) + "," + profileMicros(h.minCycles) + "," +
+              profileMicros(profilePercentile(h, 50)) + "," + profileMicros(profilePercentile(h, 99)) + "," +
+              profileMicros(h.maxCycles) + "," + profileMicros(h.totalCycles / h.count) + "," +
+              (h.instrCount > 0 ? profileMicros(profileStallCycles(h)) : String()) + "\n");
+  }
+}
+
+// Serial: 'p' prints the report, 'r' resets it, 'i' toggles stall mode
+bool profileCommand(char c) {
+  if (c == 'p') {
+    printProfileReport(Serial);
+  } else if (c == 'r') {
+    resetProfile();
+    Serial.println("[PROF] reset");
+  } else if (c == 'i') {
+    if (!setProfileStallMode(!profileStallMode)) {
+      Serial.println("[PROF] stall mode needs the RISC-V performance counter");
+    } else {
+      resetProfile();
+      Serial.println(profileStallMode ? "[PROF] stall mode on (reset)" : "[PROF] stall mode off (reset)");
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+#endif // USE_PROFILER
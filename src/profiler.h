@@ -0,0 +1,78 @@
+// Scoped cycle-counter profiler
+//
+// PROFILE_SCOPE(id) times the rest of the enclosing block with the CPU
+// cycle counter and adds it to that probe's histogram (count, min, max,
+// log2 buckets for p50/p99). The GFX library primitives report into the
+// same table through gfx_profile_record(). Build with -DGFX_PROFILE to
+// enable; otherwise every probe compiles away.
+//
+// Stall mode ('i') alternates the counter between cycles and retired
+// instructions on every loop pass. The core retires about one instruction
+// per cycle when it is not waiting, so cycles minus instructions per call
+// is the time a probe spent stalled, mostly on flash cache misses. Compare
+// builds with and without -DGFX_IRAM_HOT to see what IRAM placement buys.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <Arduino_GFX_Library.h>
+#include "pomodoro_config.h"
+
+// Application probes: X(id, "name")
+#define PROFILE_PROBES(X) \
+  X(PROF_LOOP,            "loop") \
+  X(PROF_TOUCH,           "handleTouchInput") \
+  X(PROF_READ_TOUCH,      "readTouchData") \
+  X(PROF_TELEGRAM_CMDS,   "processTelegramCmds") \
+  X(PROF_UPDATE_TIMER,    "updateTimer") \
+  X(PROF_UPDATE_DISPLAY,  "updateDisplay") \
+  X(PROF_DRAW_TIMER,      "drawTimer") \
+  X(PROF_PROGRESS_CIRCLE, "drawProgressCircle") \
+  X(PROF_AUTO_ROTATION,   "checkAutoRotation") \
+  X(PROF_FLUSH,           "flushDisplay")
+
+#define PROFILE_X_ID(id, name) id,
+enum ProfileProbe : uint8_t {
+  PROFILE_PROBES(PROFILE_X_ID)
+  PROF_APP_COUNT
+};
+
+#if USE_PROFILER
+
+void profileRecord(uint8_t probe, uint32_t cycles);
+void printProfileReport(Print& out);
+String profileReport();
+void printProfileCsv(Print& out);
+void resetProfile();
+void profileNextPass();  // Start of each loop pass, switches the counter in stall mode
+bool profileCommand(char c);
+
+class ProfileScope {
+ public:
+  explicit ProfileScope(uint8_t probe) : probe(probe), start(gfx_profile_cycles()) {}
+  ~ProfileScope() { profileRecord(probe, gfx_profile_cycles() - start); }
+
+ private:
+  uint8_t probe;
+  uint32_t start;
+};
+
+#define PROFILE_SCOPE(id) ProfileScope _profileScope(id)
+
+#else
+
+#define PROFILE_SCOPE(id)
+inline void profileNextPass() {}
+inline bool profileCommand(char) { return false; }
+
+#endif // USE_PROFILER
+
+// Time a single statement: PROFILE_CALL(PROF_TOUCH, handleTouchInput());
+#define PROFILE_CALL(id, call) \
+  do { \
+    PROFILE_SCOPE(id); \
+    call; \
+  } while (0)
+
+#endif // PROFILER_H
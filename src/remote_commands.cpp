@@ -0,0 +1,93 @@
+// Remote command queue implementation
+
+#include "remote_commands.h"
+#include "pomodoro_globals.h"
+#include "display_updates.h"
+#include "timer_logic.h"
+#include "storage.h"
+#include "sd_export.h"
+#include "input_trace.h"
+#include "deferred_log.h"
+#include "wifi_telegram.h"
+#include "message_format.h"
+
+// Thread-safe command queue from Telegram to main loop
+volatile bool telegramCmdStart = false;
+volatile bool telegramCmdPause = false;
+volatile bool telegramCmdResume = false;
+volatile bool telegramCmdStop = false;
+volatile bool telegramCmdMode = false;
+volatile uint8_t telegramCmdExport = 0;  // 1 = CSV, 2 = binary
+
+static const struct {
+  const char* name;
+  volatile bool* flag;
+} remoteCommands[] = {
+  { "start", &telegramCmdStart },
+  { "pause", &telegramCmdPause },
+  { "resume", &telegramCmdResume },
+  { "stop", &telegramCmdStop },
+  { "mode", &telegramCmdMode }
+};
+
+bool queueRemoteCommand(const char* word) {
+  for (const auto& cmd : remoteCommands) {
+    if (strcmp(word, cmd.name) != 0) continue;
+    *cmd.flag = true;
+    return true;
+  }
+  return false;
+}
+
+// Process Telegram commands in main loop (thread-safe)
+void processTelegramCommands() {
+  traceTelegramCommands();
+  if (telegramCmdStart) {
+    telegramCmdStart = false;
+    if (currentState == STOPPED) {
+      LOG(LOG_TG_CMD_START);
+      startTimer();
+    }
+  }
+  if (telegramCmdPause) {
+    telegramCmdPause = false;
+    if (currentState == RUNNING) {
+      LOG(LOG_TG_CMD_PAUSE);
+      pauseTimer();
+    }
+  }
+  if (telegramCmdResume) {
+    telegramCmdResume = false;
+    if (currentState == PAUSED) {
+      LOG(LOG_TG_CMD_RESUME);
+      resumeTimer();
+    }
+  }
+  if (telegramCmdStop) {
+    telegramCmdStop = false;
+    if (currentState != STOPPED) {
+      LOG(LOG_TG_CMD_STOP);
+      stopTimer();
+    }
+  }
+  if (telegramCmdMode) {
+    telegramCmdMode = false;
+    LOG(LOG_TG_CMD_MODE);
+    traceAction(ACT_MODE);
+    switch (currentMode) {
+      case MODE_1_1: currentMode = MODE_25_5; break;
+      case MODE_25_5: currentMode = MODE_50_10; break;
+      case MODE_50_10: currentMode = MODE_1_1; break;
+    }
+    saveSettings();
+    displayInitialized = false;
+    forceCircleRedraw = true;
+  }
+  if (telegramCmdExport) {
+    SdExportFormat format = (telegramCmdExport == 2) ? SD_EXPORT_BINARY : SD_EXPORT_CSV;
+    telegramCmdExport = 0;
+    if (!startSdExport(format)) {
+      sendTelegramMessage(messageTemplate(sdExportBusy() ? MSG_EXPORT_BUSY : MSG_EXPORT_NO_SD));
+    }
+  }
+}
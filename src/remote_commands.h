@@ -0,0 +1,29 @@
+// Commands from the other tasks (Telegram, HTTP API, MQTT) to the main loop
+//
+// The tasks only set a flag; processTelegramCommands() runs the pending
+// ones between loop stages, so the timer and display are only touched from
+// the loop. Kept apart from the Telegram client so host drivers in tools/
+// can build it.
+
+#ifndef REMOTE_COMMANDS_H
+#define REMOTE_COMMANDS_H
+
+#include <Arduino.h>
+
+// Thread-safe command queue from Telegram (and the HTTP API) to main loop
+extern volatile bool telegramCmdStart;
+extern volatile bool telegramCmdPause;
+extern volatile bool telegramCmdResume;
+extern volatile bool telegramCmdStop;
+extern volatile bool telegramCmdMode;
+extern volatile uint8_t telegramCmdExport;  // 1 = CSV, 2 = binary
+
+// Set the flag of a command named "start", "pause", "resume", "stop" or
+// "mode", as the Telegram commands do; false if word names none. For the
+// other remote paths (HTTP API, MQTT).
+bool queueRemoteCommand(const char* word);
+
+// Process Telegram commands in main loop (thread-safe)
+void processTelegramCommands();
+
+#endif // REMOTE_COMMANDS_H
@@ -0,0 +1,248 @@
+// SD export implementation
+//
+// The card shares SCK/MOSI with the LCD. Both are only driven from loop(),
+// so their transactions never overlap on the wire; the arbiter decides when
+// the card gets the bus. A block goes out only if the next scheduled display
+// frame is further away than recent block writes have taken, so an export
+// never pushes a frame back. Output is staged in one 4 KB block and written
+// whole, which keeps file offsets 4 KB aligned (full clusters on a card
+// formatted with 4 KB or larger clusters); only the last block is partial.
+
+#include "sd_export.h"
+
+#if USE_SD_EXPORT
+
+#include "session_log.h"
+#include "display_updates.h"
+#include "wifi_telegram.h"
+#include "message_format.h"
+#include "deferred_log.h"
+#include "profiler.h"
+#include <SD.h>
+#include <SPI.h>
+
+#define SD_BLOCK_SIZE 4096
+#define SD_LINE_MAX 64            // Longest CSV line
+#define SD_RECORDS_PER_PASS 64    // Session reads per loop pass while filling
+
+enum SdExportStage : uint8_t {
+  SD_STAGE_IDLE,
+  SD_STAGE_SESSIONS,
+  SD_STAGE_PROFILE
+};
+
+static bool sdMounted = false;
+static SdExportStage sdStage = SD_STAGE_IDLE;
+static SdExportFormat sdFormat = SD_EXPORT_CSV;
+static File sdFile;
+static bool sdFileOpen = false;
+static bool sdSourceDone = false;
+
+static uint8_t sdBlock[SD_BLOCK_SIZE] __attribute__((aligned(4)));
+static uint16_t sdFill = 0;
+static char sdCarry[SD_LINE_MAX];  // Tail of the line that overflowed the last block
+static uint8_t sdCarryLen = 0;
+
+static uint32_t sdNextSeq = 0;  // Sessions sdNextSeq..sdLastSeq still to export
+static uint32_t sdLastSeq = 0;
+
+static uint32_t sdBlockEstimateUs = SD_BLOCK_ESTIMATE_US;
+static unsigned long sdStartMs = 0;
+static SdExportStats sdStats = {};
+
+// Print sink for the profiler CSV, which fits one block
+class SdBlockPrint : public Print {
+ public:
+  size_t write(uint8_t c) override {
+    if (sdFill >= SD_BLOCK_SIZE) return 0;
+    sdBlock[sdFill++] = c;
+    return 1;
+  }
+};
+
+bool initSdCard() {
+  sdMounted = SD.begin(SD_CS, SPI, SD_SPI_FREQ);
+  if (!sdMounted) {
+    LOG(LOG_SD_NO_CARD);
+    return false;
+  }
+  SD.mkdir(SD_EXPORT_DIR);
+  LOG(LOG_SD_MOUNTED, (uint32_t)(SD.cardSize() / (1024ULL * 1024ULL)));
+  return true;
+}
+
+// --- Helper: bus arbiter, true if a block write fits before the next frame ---
+static bool sdBusGranted() {
+  return msUntilNextFrame() > sdBlockEstimateUs / 1000 + SD_FRAME_MARGIN_MS;
+}
+
+// --- Helper: copy into the block, keeping what does not fit for the next one ---
+static void sdAppend(const void* data, size_t len) {
+  size_t room = SD_BLOCK_SIZE - sdFill;
+  size_t n = (len < room) ? len : room;
+  memcpy(sdBlock + sdFill, data, n);
+  sdFill += n;
+  if (n < len) {
+    memcpy(sdCarry, (const uint8_t*)data + n, len - n);
+    sdCarryLen = len - n;
+  }
+}
+
+// --- Helper: one session as a CSV line ---
+static size_t sdSessionLine(const SessionRecord& rec, char* line) {
+  static const char* const modeNames[] = { "1/1", "25/5", "50/10", "?" };
+  return snprintf(line, SD_LINE_MAX, "%lu,%lu,%lu,%u,%s,%s,%u,%u\n",
+                  (unsigned long)rec.seq, (unsigned long)rec.start, (unsigned long)rec.end,
+                  rec.activeSec,
+                  (rec.flags & SESSION_FLAG_REST) ? "rest" : "work",
+                  modeNames[(rec.flags & SESSION_FLAG_MODE_MASK) >> 1],
+                  (rec.flags & SESSION_FLAG_INTERRUPTED) ? 1 : 0,
+                  (rec.flags & SESSION_FLAG_NO_CLOCK) ? 0 : 1);
+}
+
+// --- Helper: produce output for the current stage until the block is full ---
+static void sdFillBlock() {
+  if (sdStage == SD_STAGE_PROFILE) {
+#if USE_PROFILER
+    SdBlockPrint out;
+    printProfileCsv(out);
+#endif
+    sdSourceDone = true;
+    return;
+  }
+
+  for (uint8_t i = 0; i < SD_RECORDS_PER_PASS && sdFill < SD_BLOCK_SIZE && sdNextSeq <= sdLastSeq; i++) {
+    SessionRecord rec;
+    if (!readSessionSeq(sdNextSeq++, rec)) continue;  // Erased by the ring, or torn
+    if (sdFormat == SD_EXPORT_BINARY) {
+      sdAppend(&rec, sizeof(rec));  // 256 per block, never split
+    } else {
+      char line[SD_LINE_MAX];
+      sdAppend(line, sdSessionLine(rec, line));
+    }
+  }
+  if (sdNextSeq > sdLastSeq) sdSourceDone = true;
+}
+
+// --- Helper: write the staged block and track the card's throughput ---
+static bool sdWriteBlock() {
+  uint32_t t0 = micros();
+  size_t written = sdFile.write(sdBlock, sdFill);
+  uint32_t us = micros() - t0;
+  if (written != sdFill) {
+    LOG(LOG_SD_WRITE_FAILED, sdStats.bytes);
+    return false;
+  }
+  sdStats.bytes += sdFill;
+  sdStats.blocks++;
+  sdStats.writeUs += us;
+  if (us > sdStats.worstBlockUs) sdStats.worstBlockUs = us;
+  // Follow slow writes at once, fast ones gradually (card GC stalls come back)
+  sdBlockEstimateUs = (us > sdBlockEstimateUs) ? us : (sdBlockEstimateUs * 3 + us) / 4;
+
+  sdFill = 0;
+  if (sdCarryLen > 0) {
+    memcpy(sdBlock, sdCarry, sdCarryLen);
+    sdFill = sdCarryLen;
+    sdCarryLen = 0;
+  }
+  return true;
+}
+
+// --- Helper: stop the export, reporting the numbers when it completed ---
+static void sdFinish(bool ok) {
+  if (sdFileOpen) sdFile.close();
+  sdFileOpen = false;
+  sdStage = SD_STAGE_IDLE;
+  sdFill = 0;
+  sdCarryLen = 0;
+  sdStats.elapsedMs = millis() - sdStartMs;
+  if (!ok) {
+    sendTelegramMessage(messageTemplate(MSG_EXPORT_FAILED));
+    return;
+  }
+
+  // bytes per ms is KB/s; the write time excludes the waits for frame gaps
+  uint32_t writeMs = sdStats.writeUs / 1000;
+  uint32_t kbps = (writeMs > 0) ? sdStats.bytes / writeMs : 0;
+  LOG(LOG_SD_EXPORT_DONE, sdStats.bytes, sdStats.blocks, sdStats.elapsedMs);
+  LOG(LOG_SD_THROUGHPUT, kbps, sdStats.worstBlockUs, sdStats.deferred);
+  char text[96];
+  formatMessage(text, sizeof(text), MSG_EXPORTED, { msgUint(sdStats.bytes), msgUint(kbps), msgUint(sdStats.worstBlockUs / 1000) });
+  sendTelegramMessage(text);
+}
+
+bool startSdExport(SdExportFormat format) {
+  if (sdStage != SD_STAGE_IDLE) return false;
+  if (!sdMounted && !initSdCard()) return false;  // The card may have been inserted since boot
+
+  sdFormat = format;
+  sdStage = SD_STAGE_SESSIONS;
+  sdSourceDone = false;
+  sdFill = 0;
+  sdCarryLen = 0;
+  sdLastSeq = lastSessionSeq();
+  sdNextSeq = sdLastSeq - sessionLogSize() + 1;
+  memset(&sdStats, 0, sizeof(sdStats));
+  sdStartMs = millis();
+  return true;
+}
+
+bool sdExportBusy() {
+  return sdStage != SD_STAGE_IDLE;
+}
+
+const SdExportStats& lastSdExportStats() {
+  return sdStats;
+}
+
+void serviceSdExport() {
+  if (sdStage == SD_STAGE_IDLE) return;
+
+  if (sdFileOpen && sdFill < SD_BLOCK_SIZE && !sdSourceDone) sdFillBlock();
+  bool blockReady = (sdFill == SD_BLOCK_SIZE) || (sdSourceDone && sdFill > 0);
+  bool needBus = blockReady || !sdFileOpen || sdSourceDone;
+  if (!needBus) return;  // Still filling
+  if (!sdBusGranted()) {
+    sdStats.deferred++;
+    return;
+  }
+
+  // One bus operation per pass: open, write a block, or close
+  if (!sdFileOpen) {
+    const char* path;
+    if (sdStage == SD_STAGE_PROFILE) {
+      path = SD_EXPORT_DIR "/profile.csv";
+    } else {
+      path = (sdFormat == SD_EXPORT_BINARY) ? SD_EXPORT_DIR "/sessions.bin" : SD_EXPORT_DIR "/sessions.csv";
+    }
+    sdFile = SD.open(path, FILE_WRITE);
+    if (!sdFile) {
+      LOG(LOG_SD_OPEN_FAILED, path);
+      sdFinish(false);
+      return;
+    }
+    sdFileOpen = true;
+    if (sdStage == SD_STAGE_SESSIONS && sdFormat == SD_EXPORT_CSV) {
+      static const char header[] = "seq,start,end,active_s,type,mode,interrupted,clock_set\n";
+      sdAppend(header, sizeof(header) - 1);
+    }
+    return;
+  }
+  if (blockReady) {
+    if (!sdWriteBlock()) sdFinish(false);
+    return;
+  }
+
+  // Source drained and written out
+  sdFile.close();
+  sdFileOpen = false;
+  if (sdStage == SD_STAGE_SESSIONS && USE_PROFILER) {
+    sdStage = SD_STAGE_PROFILE;
+    sdSourceDone = false;
+    return;
+  }
+  sdFinish(true);
+}
+
+#endif // USE_SD_EXPORT
@@ -0,0 +1,48 @@
+// microSD export of the session history and profiler traces
+
+#ifndef SD_EXPORT_H
+#define SD_EXPORT_H
+
+#include <Arduino.h>
+#include "pomodoro_config.h"
+
+enum SdExportFormat : uint8_t {
+  SD_EXPORT_CSV,     // sessions.csv, one line per session
+  SD_EXPORT_BINARY   // sessions.bin, raw 16-byte SessionRecords, 256 per block
+};
+
+// Throughput of the last export
+struct SdExportStats {
+  uint32_t bytes;
+  uint32_t blocks;
+  uint32_t writeUs;       // Time spent inside block writes
+  uint32_t worstBlockUs;
+  uint32_t deferred;      // Loop passes an SD operation waited for a frame gap
+  uint32_t elapsedMs;     // Start to close, waiting included
+};
+
+#if USE_SD_EXPORT
+
+// Mount the card on the LCD's SPI bus (after gfx->begin())
+bool initSdCard();
+
+// Queue an export: the session history, then profile.csv when profiling.
+// Runs in the background from serviceSdExport(); false if busy or no card.
+bool startSdExport(SdExportFormat format);
+bool sdExportBusy();
+const SdExportStats& lastSdExportStats();
+
+// Produce and write at most one 4 KB block, only in a gap between display
+// frames. Call from loop() after flushDisplay().
+void serviceSdExport();
+
+#else
+
+inline bool initSdCard() { return false; }
+inline bool startSdExport(SdExportFormat) { return false; }
+inline bool sdExportBusy() { return false; }
+inline void serviceSdExport() {}
+
+#endif // USE_SD_EXPORT
+
+#endif // SD_EXPORT_H
@@ -0,0 +1,293 @@
+// Session history implementation
+//
+// Records go to a raw data partition used as a ring of flash sectors. Each
+// slot is written once after its sector is erased, so the log survives
+// power loss at any point (a torn record fails its CRC). Boot recovery
+// reads one record per sector plus a binary search inside the newest
+// sector, and the day/week totals are rebuilt from at most
+// SESSION_STATS_SCAN_MAX records, so both are bounded whatever the log holds.
+//
+// A sector erase takes tens of ms, so records are written by a task at idle
+// priority rather than by the loop that ends the session. The totals are
+// counted when the session ends and are read from the Telegram and HTTP
+// tasks too, so they are kept under a mutex.
+
+#include "session_log.h"
+#include "pomodoro_config.h"
+#include "deferred_log.h"
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <time.h>
+
+#define SESSION_SECTOR_SIZE 4096
+#define SESSION_SLOTS_PER_SECTOR (SESSION_SECTOR_SIZE / sizeof(SessionRecord))
+#define SESSION_ERASED 0xFFFFFFFFUL
+#define SESSION_CLOCK_VALID 1700000000UL  // Earlier wall times mean NTP has not synced yet
+
+static const esp_partition_t* logPartition = nullptr;
+static uint32_t logSlots = 0;   // Usable slots, whole sectors
+static uint32_t headSlot = 0;   // Next slot to write, moved by the writer task only
+static uint32_t nextSeq = 1;
+static portMUX_TYPE headLock = portMUX_INITIALIZER_UNLOCKED;  // headSlot and nextSeq change together
+static QueueHandle_t writeQueue = nullptr;  // Loop -> writer task, records without seq and crc
+
+static unsigned long sessionStartMs = 0;
+
+// Day/week totals, valid for statsDay (-1 = clock unknown, counts this boot only)
+static SemaphoreHandle_t statsMutex = nullptr;
+static int32_t statsDay = -2;   // -2 = not built yet
+static uint32_t todayFocusSec = 0;
+static uint32_t weekFocusSec = 0;
+static uint32_t todayWorkSessions = 0;
+
+// --- Helper: CRC-8 (poly 0x07) over a record minus its crc byte ---
+static uint8_t sessionCrc8(const SessionRecord& rec) {
+  const uint8_t* p = (const uint8_t*)&rec;
+  uint8_t crc = 0;
+  for (size_t i = 0; i < offsetof(SessionRecord, crc); i++) {
+    crc ^= p[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static bool readSlot(uint32_t slot, SessionRecord& rec) {
+  return esp_partition_read(logPartition, slot * sizeof(SessionRecord), &rec, sizeof(rec)) == ESP_OK;
+}
+
+static bool slotErased(uint32_t slot) {
+  SessionRecord rec;
+  return readSlot(slot, rec) && rec.seq == SESSION_ERASED;
+}
+
+// --- Helper: head slot and next seq as one consistent pair ---
+static void logHead(uint32_t& slot, uint32_t& seq) {
+  portENTER_CRITICAL(&headLock);
+  slot = headSlot;
+  seq = nextSeq;
+  portEXIT_CRITICAL(&headLock);
+}
+
+// --- Helper: local calendar day number (days since 1970-01-01), -1 if no clock ---
+static int32_t dayNumber(time_t t) {
+  if ((uint32_t)t < SESSION_CLOCK_VALID) return -1;
+  struct tm lt;
+  localtime_r(&t, &lt);
+  // Days from civil date (H. Hinnant), March-based year
+  int32_t y = lt.tm_year + 1900 - (lt.tm_mon < 2 ? 1 : 0);
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  int32_t yoe = y - era * 400;
+  int32_t m = lt.tm_mon + 1;
+  int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + lt.tm_mday - 1;
+  int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// --- Helper: first day (Monday) of the week containing day ---
+static int32_t weekStart(int32_t day) {
+  return day - ((day + 3) % 7);  // 1970-01-01 was a Thursday
+}
+
+// --- Helper: add one finished session to the totals for statsDay ---
+static void countSession(const SessionRecord& rec) {
+  if (rec.flags & SESSION_FLAG_REST) return;
+  int32_t day = (rec.flags & SESSION_FLAG_NO_CLOCK) ? -1 : dayNumber(rec.end);
+  if (statsDay >= 0 && (day < 0 || day < weekStart(statsDay) || day > statsDay)) return;
+  if (statsDay < 0 && day >= 0) return;
+  weekFocusSec += rec.activeSec;
+  if (day == statsDay) {
+    todayFocusSec += rec.activeSec;
+    todayWorkSessions++;
+  }
+}
+
+// --- Helper: recompute the totals for a new day from the newest records ---
+// Called with statsMutex held, as are countSession() and refreshStats()
+static void rebuildStats(int32_t day) {
+  statsDay = day;
+  todayFocusSec = 0;
+  weekFocusSec = 0;
+  todayWorkSessions = 0;
+  if (day < 0) return;  // Without a clock only this boot's sessions count
+
+  int32_t firstDay = weekStart(day);
+  uint32_t slot, seq;
+  logHead(slot, seq);
+  SessionRecord rec;
+  for (uint32_t i = 0; i < SESSION_STATS_SCAN_MAX && i + 1 < seq; i++) {
+    if (!readSession(i, rec)) continue;  // Torn by a power loss, or overwritten
+    if (!(rec.flags & SESSION_FLAG_NO_CLOCK) && dayNumber(rec.end) < firstDay) break;
+    countSession(rec);
+  }
+}
+
+// --- Helper: keep the totals on the current day (rolls over at midnight) ---
+static void refreshStats() {
+  int32_t day = dayNumber(time(nullptr));
+  if (day != statsDay) rebuildStats(day);
+}
+
+// --- Helper: one record into the next slot (writer task) ---
+static void writeRecord(SessionRecord& rec) {
+  uint32_t slot = headSlot;  // Only this task moves the head
+  rec.seq = nextSeq;
+  rec.crc = sessionCrc8(rec);
+
+  // Entering a sector: drop its oldest records (skipped if already blank)
+  if (slot % SESSION_SLOTS_PER_SECTOR == 0 && !slotErased(slot)) {
+    esp_partition_erase_range(logPartition, slot * sizeof(SessionRecord), SESSION_SECTOR_SIZE);
+  }
+  if (esp_partition_write(logPartition, slot * sizeof(SessionRecord), &rec, sizeof(rec)) != ESP_OK) {
+    LOG(LOG_SESSION_WRITE_FAILED, slot);
+    return;
+  }
+  portENTER_CRITICAL(&headLock);
+  headSlot = (slot + 1) % logSlots;
+  nextSeq++;
+  portEXIT_CRITICAL(&headLock);
+  LOG(LOG_SESSION_LOGGED, rec.seq, (rec.flags & SESSION_FLAG_REST) ? "rest" : "work", rec.activeSec,
+      (rec.flags & SESSION_FLAG_INTERRUPTED) != 0);
+}
+
+// Session writer task - erases and writes stall flash access, so they run
+// here at idle priority instead of between the loop's frames
+static void sessionWriterTask(void* parameter) {
+  SessionRecord rec;
+  while (true) {
+    if (xQueueReceive(writeQueue, &rec, portMAX_DELAY) == pdTRUE) writeRecord(rec);
+  }
+}
+
+void initSessionLog() {
+  statsMutex = xSemaphoreCreateMutex();
+  logPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SESSION_LOG_PARTITION);
+  if (logPartition == nullptr) {
+    LOG(LOG_SESSION_NO_PARTITION, SESSION_LOG_PARTITION);
+    return;
+  }
+  uint32_t sectors = logPartition->size / SESSION_SECTOR_SIZE;
+  if (sectors > SESSION_LOG_MAX_SECTORS) sectors = SESSION_LOG_MAX_SECTORS;
+  if (sectors < 2) {
+    logPartition = nullptr;
+    return;
+  }
+  logSlots = sectors * SESSION_SLOTS_PER_SECTOR;
+
+  // The newest sector is the one whose first record has the highest seq
+  uint32_t newestSeq = 0, newestSector = 0;
+  for (uint32_t s = 0; s < sectors; s++) {
+    SessionRecord rec;
+    if (!readSlot(s * SESSION_SLOTS_PER_SECTOR, rec)) continue;
+    if (rec.seq == SESSION_ERASED || rec.crc != sessionCrc8(rec)) continue;
+    if (rec.seq > newestSeq) {
+      newestSeq = rec.seq;
+      newestSector = s;
+    }
+  }
+
+  if (newestSeq == 0) {
+    headSlot = 0;
+    nextSeq = 1;
+  } else {
+    // Slots fill in order, so the first erased one splits the sector
+    uint32_t base = newestSector * SESSION_SLOTS_PER_SECTOR;
+    uint32_t lo = 1, hi = SESSION_SLOTS_PER_SECTOR;
+    while (lo < hi) {
+      uint32_t mid = (lo + hi) / 2;
+      if (slotErased(base + mid)) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    headSlot = (base + lo) % logSlots;
+    nextSeq = newestSeq + lo;
+  }
+  LOG(LOG_SESSION_LOG_READY, nextSeq - 1, headSlot);
+
+  writeQueue = xQueueCreate(SESSION_WRITE_QUEUE, sizeof(SessionRecord));
+  xTaskCreate(sessionWriterTask, "SessionLog", 3072, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+void sessionStarted() {
+  sessionStartMs = millis();
+}
+
+void sessionEnded(bool workSession, PomodoroMode mode, unsigned long activeMs, bool interrupted) {
+  SessionRecord rec;
+  time_t now = time(nullptr);
+  uint32_t wallSec = (millis() - sessionStartMs) / 1000;
+  rec.flags = (workSession ? 0 : SESSION_FLAG_REST) | (((uint8_t)mode << 1) & SESSION_FLAG_MODE_MASK);
+  if (interrupted) rec.flags |= SESSION_FLAG_INTERRUPTED;
+  if ((uint32_t)now >= SESSION_CLOCK_VALID) {
+    rec.end = (uint32_t)now;
+  } else {
+    rec.end = millis() / 1000;
+    rec.flags |= SESSION_FLAG_NO_CLOCK;
+  }
+  rec.start = rec.end - wallSec;
+  rec.activeSec = (activeMs / 1000 > 0xFFFF) ? 0xFFFF : (uint16_t)(activeMs / 1000);
+
+  // Counted now; readers see the record once the writer task has it in flash
+  xSemaphoreTake(statsMutex, portMAX_DELAY);
+  refreshStats();
+  countSession(rec);
+  xSemaphoreGive(statsMutex);
+
+  if (writeQueue == nullptr) return;
+  if (xQueueSend(writeQueue, &rec, 0) != pdTRUE) LOG(LOG_SESSION_QUEUE_FULL, (uint32_t)SESSION_WRITE_QUEUE);
+}
+
+bool readSession(uint32_t newest, SessionRecord& out) {
+  uint32_t head, seq;
+  logHead(head, seq);
+  if (logPartition == nullptr || newest + 1 >= seq || newest >= logSlots) return false;
+  uint32_t slot = (head + logSlots - 1 - newest) % logSlots;
+  if (!readSlot(slot, out)) return false;
+  // A different seq means the slot was erased or overwritten by the ring
+  return out.seq == seq - 1 - newest && out.crc == sessionCrc8(out);
+}
+
+uint32_t sessionLogSize() {
+  if (logPartition == nullptr) return 0;
+  uint32_t last = lastSessionSeq();
+  return (last < logSlots) ? last : logSlots;
+}
+
+uint32_t lastSessionSeq() {
+  uint32_t slot, seq;
+  logHead(slot, seq);
+  return seq - 1;
+}
+
+bool readSessionSeq(uint32_t seq, SessionRecord& out) {
+  uint32_t last = lastSessionSeq();
+  if (seq == 0 || seq > last) return false;
+  return readSession(last - seq, out);
+}
+
+// --- Helper: one total, on the current day, read under the mutex ---
+static uint32_t readStat(const uint32_t& total) {
+  xSemaphoreTake(statsMutex, portMAX_DELAY);
+  refreshStats();
+  uint32_t value = total;
+  xSemaphoreGive(statsMutex);
+  return value;
+}
+
+uint32_t focusSecondsToday() {
+  return readStat(todayFocusSec);
+}
+
+uint32_t focusSecondsThisWeek() {
+  return readStat(weekFocusSec);
+}
+
+uint16_t workSessionsToday() {
+  return (uint16_t)readStat(todayWorkSessions);
+}
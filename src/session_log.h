@@ -0,0 +1,50 @@
+// Session history: append-only log of finished work/rest sessions in flash
+
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <Arduino.h>
+#include "pomodoro_types.h"
+
+// Record flags
+#define SESSION_FLAG_REST        0x01  // Rest session (clear = work)
+#define SESSION_FLAG_MODE_MASK   0x06  // PomodoroMode << 1
+#define SESSION_FLAG_INTERRUPTED 0x08  // Stopped before the timer ran out
+#define SESSION_FLAG_NO_CLOCK    0x10  // Wall clock not set, start/end are uptime seconds
+
+// 16 bytes, 256 per flash sector. Erased flash reads as seq 0xFFFFFFFF.
+struct SessionRecord {
+  uint32_t seq;       // Increases by one per record across the whole log
+  uint32_t start;     // Unix time (s)
+  uint32_t end;       // Unix time (s)
+  uint16_t activeSec; // Running time, pauses excluded
+  uint8_t flags;
+  uint8_t crc;        // CRC-8 of the bytes above
+};
+
+// Find the log head and rebuild the day/week totals (bounded reads)
+void initSessionLog();
+
+// A work or rest session began (timer start, resume of a new phase)
+void sessionStarted();
+
+// The running session ended: completed, or stopped early when interrupted
+void sessionEnded(bool workSession, PomodoroMode mode, unsigned long activeMs, bool interrupted);
+
+// Aggregates, O(1) apart from the rebuild on the first call of a new day
+uint32_t focusSecondsToday();
+uint32_t focusSecondsThisWeek();
+uint16_t workSessionsToday();
+
+// Read the n-th newest record (0 = last appended); false past the log start
+bool readSession(uint32_t newest, SessionRecord& out);
+
+// Records that may still be readable (upper bound, oldest sector included)
+uint32_t sessionLogSize();
+
+// Seq of the last appended record (0 = none), and lookup by seq, which stays
+// valid while new records are appended
+uint32_t lastSessionSeq();
+bool readSessionSeq(uint32_t seq, SessionRecord& out);
+
+#endif // SESSION_LOG_H
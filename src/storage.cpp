@@ -2,35 +2,218 @@
 
 #include "storage.h"
 #include "pomodoro_globals.h"
+#include "deferred_log.h"
+#include "wifi_telegram.h"
+#include "telegram_status.h"
+#include "telegram_fanout.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
 
-// Save selected color to NVS (persistent storage)
-void saveSelectedColor() {
-  preferences.begin("pomodoro", false);  // Open namespace in RW mode
-  preferences.putUShort("workColor", selectedWorkColor);
-  preferences.putUShort("restColor", selectedRestColor);  // Save rest color (0 = use inverted)
-  preferences.end();
-  Serial.print("Saved work color to NVS: 0x");
-  Serial.println(selectedWorkColor, HEX);
-  if (selectedRestColor != 0) {
-    Serial.print("Saved rest color to NVS: 0x");
-    Serial.println(selectedRestColor, HEX);
-  } else {
-    Serial.println("Rest color: using inverted work color");
+static const char* SETTINGS_NAMESPACE = "pomodoro";
+static const char* SETTINGS_KEY = "settings";
+
+// Marked from the loop and the Telegram task; read and cleared together
+static volatile bool settingsDirty = false;
+static volatile unsigned long settingsChangedAt = 0;
+static portMUX_TYPE settingsLock = portMUX_INITIALIZER_UNLOCKED;
+static QueueHandle_t settingsQueue = nullptr;  // Loop -> settings task, newest blob only
+static volatile uint32_t settingsQueuedCrc = 0;  // Last blob handed over (or written at boot)
+
+// --- Helper: CRC-32 (IEEE, reflected), bitwise - the blob is a few bytes ---
+static uint32_t settingsCrc32(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+// --- Helper: factory defaults ---
+static void defaultSettings(SettingsData& s) {
+  s.workColor = COLOR_GOLD;
+  s.restColor = 0;
+  s.mode = MODE_25_5;
+  s.showMinutesOnly = 0;
+  s.rotation = ROTATION;
+  s.reserved = 0;
+  s.telegramOffset = 0;
+  s.telegramStatusId = 0;
+  s.subscriberCount = 0;
+}
+
+// --- Helper: copy the live globals into a settings blob ---
+static void captureSettings(SettingsBlob& blob) {
+  memset(&blob, 0, sizeof(blob));
+  blob.version = SETTINGS_VERSION;
+  blob.size = sizeof(SettingsData);
+  blob.data.workColor = selectedWorkColor;
+  blob.data.restColor = selectedRestColor;
+  blob.data.mode = currentMode;
+  blob.data.showMinutesOnly = showMinutesOnly;
+  blob.data.rotation = currentRotation;
+  blob.data.telegramOffset = telegramLastUpdateId;
+  blob.data.telegramStatusId = telegramStatusMessageId;
+  int64_t chats[TG_MAX_SUBSCRIBERS];
+  blob.data.subscriberCount = getTelegramSubscribers(chats);
+  for (uint8_t i = 0; i < blob.data.subscriberCount; i++) {
+    blob.data.subscribers[i][0] = (uint32_t)chats[i];
+    blob.data.subscribers[i][1] = (uint32_t)((uint64_t)chats[i] >> 32);
+  }
+  blob.crc = settingsCrc32((const uint8_t*)&blob, offsetof(SettingsBlob, crc));
+}
+
+// --- Helper: apply settings to the globals, range-checking enum fields ---
+static void applySettings(const SettingsData& s) {
+  selectedWorkColor = s.workColor;
+  selectedRestColor = s.restColor;
+  currentMode = (s.mode <= MODE_50_10) ? (PomodoroMode)s.mode : MODE_25_5;
+  lastDisplayedMode = currentMode;
+  showMinutesOnly = s.showMinutesOnly != 0;
+  lastShowMinutesOnly = showMinutesOnly;
+  currentRotation = (s.rotation <= 3) ? s.rotation : ROTATION;
+  telegramLastUpdateId = s.telegramOffset;
+  telegramStatusMessageId = s.telegramStatusId;
+  int64_t chats[TG_MAX_SUBSCRIBERS];
+  uint8_t count = (s.subscriberCount <= TG_MAX_SUBSCRIBERS) ? s.subscriberCount : 0;
+  for (uint8_t i = 0; i < count; i++) {
+    chats[i] = (int64_t)(((uint64_t)s.subscribers[i][1] << 32) | s.subscribers[i][0]);
   }
+  setTelegramSubscribers(chats, count);
 }
 
-// Load selected color from NVS (persistent storage)
-void loadSelectedColor() {
-  preferences.begin("pomodoro", true);  // Open namespace in read-only mode
-  selectedWorkColor = preferences.getUShort("workColor", COLOR_GOLD);  // Default to gold
-  selectedRestColor = preferences.getUShort("restColor", 0);  // Default to 0 (use inverted work color)
-  preferences.end();
-  Serial.print("Loaded work color from NVS: 0x");
-  Serial.println(selectedWorkColor, HEX);
+// --- Helper: validate a raw blob read from NVS, upgrading older layouts ---
+static bool decodeSettings(const uint8_t* raw, size_t len, SettingsData& out) {
+  const size_t header = offsetof(SettingsBlob, data);
+  if (len < header + sizeof(uint32_t)) return false;
+  uint8_t version = raw[0];
+  uint8_t size = raw[1];
+  if (version < 2 || version > SETTINGS_VERSION || len != header + size + sizeof(uint32_t)) return false;
+
+  uint32_t crc;
+  memcpy(&crc, raw + header + size, sizeof(crc));
+  if (crc != settingsCrc32(raw, header + size)) return false;
+
+  // Fields a shorter (older) blob lacks keep their defaults
+  defaultSettings(out);
+  memcpy(&out, raw + header, (size < sizeof(SettingsData)) ? size : sizeof(SettingsData));
+
+  switch (version) {
+    // case 5: future versions convert changed fields here, falling through
+    default:
+      break;
+  }
+  return true;
+}
+
+// --- Helper: version 1 stored each color under its own key ---
+static bool loadLegacySettings(SettingsData& out) {
+  if (!preferences.isKey("workColor")) return false;
+  defaultSettings(out);
+  out.workColor = preferences.getUShort("workColor", COLOR_GOLD);
+  out.restColor = preferences.getUShort("restColor", 0);
+  return true;
+}
+
+// --- Helper: one putBytes() of the whole blob ---
+static bool writeSettings(const SettingsBlob& blob) {
+  if (preferences.putBytes(SETTINGS_KEY, &blob, sizeof(blob)) != sizeof(blob)) {
+    LOG(LOG_SETTINGS_WRITE_FAILED);
+    return false;
+  }
+  LOG(LOG_SETTINGS_COMMITTED, (uint32_t)sizeof(blob));
+  return true;
+}
+
+// Settings task - NVS writes stall the flash cache, so they run here at idle
+// priority instead of between the loop's frames
+static void settingsTask(void* parameter) {
+  SettingsBlob blob;
+  while (true) {
+    if (xQueueReceive(settingsQueue, &blob, portMAX_DELAY) != pdTRUE) continue;
+    if (!writeSettings(blob)) {
+      settingsQueuedCrc = 0;  // Matches no blob, so the retry is handed over again
+      saveSettings();
+    }
+  }
+}
+
+// --- Helper: capture the settings and hand them to the settings task ---
+// The flag is cleared before the capture: a change made meanwhile marks the
+// settings dirty again and is written by the next commit.
+static void commitSettings() {
+  if (settingsQueue == nullptr) return;
+  portENTER_CRITICAL(&settingsLock);
+  settingsDirty = false;
+  portEXIT_CRITICAL(&settingsLock);
+  SettingsBlob blob;
+  captureSettings(blob);
+  if (blob.crc == settingsQueuedCrc) return;  // Changed and changed back
+
+  settingsQueuedCrc = blob.crc;
+  xQueueOverwrite(settingsQueue, &blob);
+}
+
+void loadSettings() {
+  // The namespace stays open, commits are single putBytes() calls
+  preferences.begin(SETTINGS_NAMESPACE, false);
+
+  SettingsData settings;
+  uint8_t raw[sizeof(SettingsBlob) + 32];  // Room for blobs from newer firmware to be rejected
+  size_t len = preferences.getBytes(SETTINGS_KEY, raw, sizeof(raw));
+  bool rewrite = false;  // Store in the current layout right away
+
+  if (len > 0 && decodeSettings(raw, len, settings)) {
+    LOG(LOG_SETTINGS_LOADED, raw[0]);
+    rewrite = raw[0] != SETTINGS_VERSION;
+  } else if (loadLegacySettings(settings)) {
+    LOG(LOG_SETTINGS_MIGRATED, 1);
+    rewrite = true;
+  } else {
+    if (len > 0) LOG(LOG_SETTINGS_INVALID, (uint32_t)len);
+    defaultSettings(settings);
+    rewrite = len > 0;  // Replace a corrupt blob
+  }
+
+  applySettings(settings);
+  LOG(LOG_NVS_LOADED_WORK, selectedWorkColor);
   if (selectedRestColor != 0) {
-    Serial.print("Loaded rest color from NVS: 0x");
-    Serial.println(selectedRestColor, HEX);
+    LOG(LOG_NVS_LOADED_REST, selectedRestColor);
   } else {
-    Serial.println("Rest color: using inverted work color");
+    LOG(LOG_NVS_REST_INVERT);
+  }
+
+  // Before the settings task exists: the rewrite is done here, in setup
+  SettingsBlob blob;
+  captureSettings(blob);
+  settingsQueuedCrc = blob.crc;
+  if (rewrite) {
+    if (!writeSettings(blob)) settingsQueuedCrc = 0;
+    preferences.remove("workColor");
+    preferences.remove("restColor");
   }
+
+  settingsQueue = xQueueCreate(1, sizeof(SettingsBlob));
+  xTaskCreate(settingsTask, "SettingsTask", 3072, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+void saveSettings() {
+  portENTER_CRITICAL(&settingsLock);
+  settingsDirty = true;
+  settingsChangedAt = millis();
+  portEXIT_CRITICAL(&settingsLock);
+}
+
+void serviceSettings() {
+  portENTER_CRITICAL(&settingsLock);
+  bool due = settingsDirty && millis() - settingsChangedAt >= SETTINGS_COMMIT_DELAY_MS;
+  portEXIT_CRITICAL(&settingsLock);
+  if (due) commitSettings();
+}
+
+void flushSettings() {
+  if (settingsDirty) commitSettings();
 }
@@ -6,10 +6,46 @@
 #include <Arduino.h>
 #include "pomodoro_config.h"
 
-// Save selected color to NVS (persistent storage)
-void saveSelectedColor();
+// Settings persisted as one versioned, CRC-checked blob. Append new fields
+// at the end and bump SETTINGS_VERSION; older blobs are upgraded on load.
+#define SETTINGS_VERSION 5  // 1 = separate workColor/restColor keys, 2 = no Telegram offset, 3 = no status message,
+                            // 4 = no subscribers
 
-// Load selected color from NVS (persistent storage)
-void loadSelectedColor();
+struct SettingsData {
+  uint16_t workColor;
+  uint16_t restColor;       // 0 = use inverted work color
+  uint8_t mode;             // PomodoroMode
+  uint8_t showMinutesOnly;
+  uint8_t rotation;
+  uint8_t reserved;
+  int32_t telegramOffset;   // Last Telegram update_id handled
+  int32_t telegramStatusId; // Pinned live status message, 0 = none
+  uint8_t subscriberCount;
+  uint8_t reserved2[3];
+  uint32_t subscribers[TG_MAX_SUBSCRIBERS][2];  // Chat ids as low, high words (keeps the blob 4-byte aligned)
+};
+
+struct SettingsBlob {
+  uint8_t version;
+  uint8_t size;             // sizeof(SettingsData) when written
+  uint16_t reserved;
+  SettingsData data;
+  uint32_t crc;             // CRC-32 of version..data
+};
+
+// Read the settings blob (one NVS read) into the globals, migrating old
+// layouts, and start the idle-priority task that writes it back
+void loadSettings();
+
+// Mark the settings changed; serviceSettings() writes them once they settle.
+// Safe from any task.
+void saveSettings();
+
+// After SETTINGS_COMMIT_DELAY_MS without changes, capture the settings and
+// hand them to the settings task for the NVS write (call from loop)
+void serviceSettings();
+
+// Hand pending settings to the settings task now
+void flushSettings();
 
 #endif // STORAGE_H
@@ -0,0 +1,216 @@
+// Notification fan-out implementation
+
+#include "telegram_fanout.h"
+#include "telegram_updates.h"
+#include "message_format.h"
+#include "storage.h"
+#include "deferred_log.h"
+#include <freertos/FreeRTOS.h>
+
+// Subscriber list (loop: settings, task: commands and fan-out)
+static int64_t subscribers[TG_MAX_SUBSCRIBERS];
+static uint8_t subscriberCount = 0;
+static portMUX_TYPE subscriberLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Earliest next send per chat, kept across notifications
+struct ChatPacing {
+  int64_t chat;
+  uint32_t notBefore;
+};
+static ChatPacing pacing[TG_MAX_SUBSCRIBERS + 1];
+static uint8_t pacingCount = 0;
+
+// The notification being delivered
+struct FanOutRecipient {
+  int64_t chat;
+  uint8_t tries;
+  bool pending;
+};
+static FanOutRecipient recipients[TG_MAX_SUBSCRIBERS + 1];
+static uint8_t recipientCount = 0;
+static uint8_t pendingCount = 0;
+static uint8_t deliveredCount = 0;
+static uint32_t fanQueuedAt = 0;
+static uint32_t fanBatches = 0;
+static uint32_t nextBatchAt = 0;
+static char fanText[TG_NOTIFY_TEXT_MAX * 2];  // JSON-escaped
+static char fanBodies[TG_PIPELINE_DEPTH][sizeof(fanText) + 96];
+
+// Latency of the last recipient, indexed by the number of recipients
+struct FanOutLatency {
+  uint32_t count;
+  uint32_t totalMs;
+  uint32_t maxMs;
+};
+static FanOutLatency latencyByRecipients[TG_MAX_SUBSCRIBERS + 2];
+
+uint8_t getTelegramSubscribers(int64_t* chats) {
+  portENTER_CRITICAL(&subscriberLock);
+  uint8_t n = subscriberCount;
+  memcpy(chats, subscribers, n * sizeof(int64_t));
+  portEXIT_CRITICAL(&subscriberLock);
+  return n;
+}
+
+void setTelegramSubscribers(const int64_t* chats, uint8_t count) {
+  if (count > TG_MAX_SUBSCRIBERS) count = TG_MAX_SUBSCRIBERS;
+  portENTER_CRITICAL(&subscriberLock);
+  memcpy(subscribers, chats, count * sizeof(int64_t));
+  subscriberCount = count;
+  portEXIT_CRITICAL(&subscriberLock);
+}
+
+uint8_t telegramSubscriberCount() {
+  return subscriberCount;
+}
+
+bool isTelegramSubscriber(int64_t chat) {
+  bool found = false;
+  portENTER_CRITICAL(&subscriberLock);
+  for (uint8_t i = 0; i < subscriberCount && !found; i++) found = subscribers[i] == chat;
+  portEXIT_CRITICAL(&subscriberLock);
+  return found;
+}
+
+bool addTelegramSubscriber(int64_t chat) {
+  if (isTelegramSubscriber(chat)) return true;
+  bool added = false;
+  portENTER_CRITICAL(&subscriberLock);
+  if (subscriberCount < TG_MAX_SUBSCRIBERS) {
+    subscribers[subscriberCount++] = chat;
+    added = true;
+  }
+  portEXIT_CRITICAL(&subscriberLock);
+  if (added) saveSettings();
+  return added;
+}
+
+bool removeTelegramSubscriber(int64_t chat) {
+  bool removed = false;
+  portENTER_CRITICAL(&subscriberLock);
+  for (uint8_t i = 0; i < subscriberCount; i++) {
+    if (subscribers[i] != chat) continue;
+    subscribers[i] = subscribers[--subscriberCount];
+    removed = true;
+    break;
+  }
+  portEXIT_CRITICAL(&subscriberLock);
+  if (removed) saveSettings();
+  return removed;
+}
+
+// --- Helper: pacing entry of a chat, reusing the stalest one when full ---
+static uint32_t& chatNotBefore(int64_t chat) {
+  for (uint8_t i = 0; i < pacingCount; i++) {
+    if (pacing[i].chat == chat) return pacing[i].notBefore;
+  }
+  uint32_t now = millis();
+  uint8_t slot = pacingCount;
+  if (pacingCount < TG_MAX_SUBSCRIBERS + 1) {
+    pacingCount++;
+  } else {
+    slot = 0;
+    for (uint8_t i = 1; i < pacingCount; i++) {
+      if ((int32_t)(pacing[i].notBefore - pacing[slot].notBefore) < 0) slot = i;
+    }
+  }
+  pacing[slot].chat = chat;
+  pacing[slot].notBefore = now;
+  return pacing[slot].notBefore;
+}
+
+bool fanOutBusy() {
+  return pendingCount > 0;
+}
+
+void startFanOut(const char* text, int64_t owner, bool toOwner, uint32_t queuedAt) {
+  telegramJsonEscape(fanText, sizeof(fanText), text);
+  recipientCount = 0;
+  if (toOwner && owner != 0) recipients[recipientCount++] = { owner, 0, true };
+
+  int64_t chats[TG_MAX_SUBSCRIBERS];
+  uint8_t n = getTelegramSubscribers(chats);
+  for (uint8_t i = 0; i < n; i++) {
+    if (chats[i] != owner) recipients[recipientCount++] = { chats[i], 0, true };
+  }
+  pendingCount = recipientCount;
+  deliveredCount = 0;
+  fanQueuedAt = queuedAt;
+  fanBatches = 0;
+}
+
+// --- Helper: a recipient is done, delivered or given up on ---
+static void finishRecipient(FanOutRecipient& r, bool delivered) {
+  r.pending = false;
+  pendingCount--;
+  if (delivered) deliveredCount++;
+  if (pendingCount > 0) return;
+
+  uint32_t latency = millis() - fanQueuedAt;
+  FanOutLatency& stats = latencyByRecipients[recipientCount];
+  stats.count++;
+  stats.totalMs += latency;
+  if (latency > stats.maxMs) stats.maxMs = latency;
+  LOG(LOG_TG_FANOUT_DONE, deliveredCount, recipientCount, fanBatches, latency);
+}
+
+void serviceFanOut(Client& client, const char* token) {
+  if (pendingCount == 0 || (int32_t)(millis() - nextBatchAt) < 0) return;
+
+  // Recipients that are due, up to one pipeline's worth
+  const char* jsons[TG_PIPELINE_DEPTH];
+  uint8_t slots[TG_PIPELINE_DEPTH];
+  uint8_t n = 0;
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < recipientCount && n < TG_PIPELINE_DEPTH; i++) {
+    if (!recipients[i].pending || (int32_t)(now - chatNotBefore(recipients[i].chat)) < 0) continue;
+    snprintf(fanBodies[n], sizeof(fanBodies[n]), "{\"chat_id\":%lld,\"text\":\"%s\",\"parse_mode\":\"HTML\"}",
+             (long long)recipients[i].chat, fanText);
+    jsons[n] = fanBodies[n];
+    slots[n++] = i;
+  }
+  if (n == 0) return;
+
+  TelegramPostResult results[TG_PIPELINE_DEPTH];
+  uint8_t answered = telegramPostPipelined(client, token, "sendMessage", jsons, n, TG_FANOUT_TIMEOUT_MS, results);
+  fanBatches++;
+  now = millis();
+  nextBatchAt = now + n * 1000UL / TG_FANOUT_MAX_PER_S;
+
+  for (uint8_t k = 0; k < n; k++) {
+    FanOutRecipient& r = recipients[slots[k]];
+    uint32_t& notBefore = chatNotBefore(r.chat);
+    int status = (k < answered) ? results[k].status : -1;
+    if (status == 200 && results[k].ok) {
+      notBefore = now + TG_CHAT_MIN_GAP_MS;
+      finishRecipient(r, true);
+      continue;
+    }
+    if (status == 400 || status == 403) {
+      // Not deliverable; if the chat is gone or blocked the bot, unsubscribe it
+      LOG(LOG_TG_FANOUT_DROPPED, (uint32_t)status, results[k].description);
+      if (status == 403 || strstr(results[k].description, "chat not found")) removeTelegramSubscriber(r.chat);
+      finishRecipient(r, false);
+      continue;
+    }
+    // Timeout, cut-off pipeline or 429: try again once the chat is due
+    notBefore = now + ((status == 429 && results[k].retryAfter > 0) ? results[k].retryAfter * 1000UL : TG_CHAT_MIN_GAP_MS);
+    if (++r.tries >= TG_FANOUT_MAX_TRIES) finishRecipient(r, false);
+  }
+}
+
+size_t fanOutReport(char* out, size_t size) {
+  int64_t chats[TG_MAX_SUBSCRIBERS];
+  size_t len = formatMessage(out, size, MSG_FANOUT_HEAD, { msgUint(getTelegramSubscribers(chats)), msgUint(TG_MAX_SUBSCRIBERS) });
+  bool any = false;
+  for (uint8_t i = 1; i < TG_MAX_SUBSCRIBERS + 2; i++) {
+    const FanOutLatency& stats = latencyByRecipients[i];
+    if (stats.count == 0) continue;
+    any = true;
+    len = appendMessage(out, size, len, MSG_FANOUT_LINE,
+                        { msgUint(i), msgMarkup(i == 1 ? "chat" : "chats"), msgUint(stats.totalMs / stats.count),
+                          msgUint(stats.maxMs), msgUint(stats.count) });
+  }
+  if (!any) len = appendMessage(out, size, len, MSG_FANOUT_NONE);
+  return len;
+}
@@ -0,0 +1,35 @@
+// Notification fan-out to subscriber chats
+//
+// Besides the owner chat (TELEGRAM_CHAT_ID), chats that sent /subscribe get
+// every notification. One notification becomes one sendMessage per chat,
+// written TG_PIPELINE_DEPTH at a time on the kept-alive TLS connection
+// before the responses are read. A chat is sent to at most once per
+// TG_CHAT_MIN_GAP_MS, and after a 429 not before its retry_after; chats not
+// due yet wait for a later batch while the others go out. How long the last
+// recipient waited is recorded per list size and shown by /subscribers.
+
+#ifndef TELEGRAM_FANOUT_H
+#define TELEGRAM_FANOUT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "pomodoro_config.h"
+
+#define TG_NOTIFY_TEXT_MAX 128
+
+// Subscriber list, persisted with the settings. Safe from the loop and the
+// Telegram task.
+uint8_t getTelegramSubscribers(int64_t* chats);  // Copies up to TG_MAX_SUBSCRIBERS
+void setTelegramSubscribers(const int64_t* chats, uint8_t count);
+uint8_t telegramSubscriberCount();
+bool isTelegramSubscriber(int64_t chat);
+bool addTelegramSubscriber(int64_t chat);        // false if the list is full
+bool removeTelegramSubscriber(int64_t chat);     // false if it was not subscribed
+
+// Telegram task side: one notification in flight at a time
+bool fanOutBusy();
+void startFanOut(const char* text, int64_t owner, bool toOwner, uint32_t queuedAt);
+void serviceFanOut(Client& client, const char* token);
+size_t fanOutReport(char* out, size_t size);  // /subscribers, as formatMessage
+
+#endif // TELEGRAM_FANOUT_H
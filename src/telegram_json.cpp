@@ -0,0 +1,371 @@
+// Telegram bot API JSON implementation
+
+#include "telegram_json.h"
+#include <string.h>
+
+// Keys the parser tells apart; everything else is K_OTHER
+enum TelegramKey : uint8_t {
+  K_OTHER,
+  K_OK,
+  K_RESULT,
+  K_UPDATE_ID,
+  K_MESSAGE,
+  K_CHAT,
+  K_ID,
+  K_TEXT,
+  K_DATE,
+  K_MESSAGE_ID,
+  K_DESCRIPTION,
+  K_PARAMETERS,
+  K_RETRY_AFTER
+};
+
+static const struct {
+  const char* name;
+  TelegramKey key;
+} telegramKeys[] = {
+  { "ok", K_OK },
+  { "result", K_RESULT },
+  { "update_id", K_UPDATE_ID },
+  { "message", K_MESSAGE },
+  { "edited_message", K_MESSAGE },
+  { "channel_post", K_MESSAGE },
+  { "edited_channel_post", K_MESSAGE },
+  { "chat", K_CHAT },
+  { "id", K_ID },
+  { "text", K_TEXT },
+  { "date", K_DATE },
+  { "message_id", K_MESSAGE_ID },
+  { "description", K_DESCRIPTION },
+  { "parameters", K_PARAMETERS },
+  { "retry_after", K_RETRY_AFTER }
+};
+
+static bool isJsonSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void TelegramUpdateParser::begin(TelegramUpdate* updates, uint8_t capacity) {
+  this->updates = updates;
+  this->capacity = capacity;
+  stored = 0;
+  okTrue = false;
+  resultMessageId = 0;
+  retryAfterS = 0;
+  description[0] = '\0';
+  capture = nullptr;
+  state = P_VALUE;
+  field = F_NONE;
+  depth = 0;
+  first = false;
+  memset(&current, 0, sizeof(current));
+}
+
+bool TelegramUpdateParser::feed(const char* data, size_t len) {
+  for (size_t i = 0; i < len && state != P_ERROR; i++) {
+    if (!feedChar(data[i])) state = P_ERROR;
+  }
+  return state != P_ERROR;
+}
+
+// Path of the value about to start: ok, description, result.message_id,
+// parameters.retry_after, or
+// result[].update_id, result[].message.text, .date or .chat.id (any
+// message-like member of the update)
+TelegramUpdateParser::Field TelegramUpdateParser::fieldForValue() const {
+  if (depth == 1 && !isArray[0] && keys[0] == K_OK) return F_OK;
+  if (depth == 1 && !isArray[0] && keys[0] == K_DESCRIPTION) return F_DESCRIPTION;
+  if (depth == 2 && !isArray[0] && keys[0] == K_RESULT && !isArray[1] && keys[1] == K_MESSAGE_ID) return F_MESSAGE_ID;
+  if (depth == 2 && !isArray[0] && keys[0] == K_PARAMETERS && !isArray[1] && keys[1] == K_RETRY_AFTER) return F_RETRY_AFTER;
+  bool inUpdate = depth >= 3 && !isArray[0] && keys[0] == K_RESULT && isArray[1] && !isArray[2];
+  if (!inUpdate) return F_NONE;
+  if (depth == 3) return (keys[2] == K_UPDATE_ID) ? F_UPDATE_ID : F_NONE;
+  if (keys[2] != K_MESSAGE || isArray[3]) return F_NONE;
+  if (depth == 4) return (keys[3] == K_TEXT) ? F_TEXT : (keys[3] == K_DATE) ? F_DATE : F_NONE;
+  if (depth == 5 && keys[3] == K_CHAT && !isArray[4] && keys[4] == K_ID) return F_CHAT_ID;
+  return F_NONE;
+}
+
+bool TelegramUpdateParser::push(bool array) {
+  if (depth >= TG_JSON_MAX_DEPTH) return false;
+  if (!array && depth == 2 && !isArray[0] && keys[0] == K_RESULT && isArray[1]) {
+    memset(&current, 0, sizeof(current));  // A new update
+  }
+  isArray[depth] = array;
+  keys[depth] = K_OTHER;
+  depth++;
+  first = true;
+  state = array ? P_VALUE : P_KEY_OR_END;
+  return true;
+}
+
+bool TelegramUpdateParser::pop(bool array) {
+  if (depth == 0 || isArray[depth - 1] != array) return false;
+  depth--;
+  if (!array && depth == 2 && !isArray[0] && keys[0] == K_RESULT && isArray[1] && stored < capacity) {
+    updates[stored++] = current;
+  }
+  return endValue();
+}
+
+bool TelegramUpdateParser::endValue() {
+  field = F_NONE;
+  first = false;
+  state = (depth == 0) ? P_DONE : P_NEXT;
+  return true;
+}
+
+void TelegramUpdateParser::endKey() {
+  keys[depth - 1] = K_OTHER;
+  if (keyLen >= TG_JSON_KEY_MAX) return;
+  keyBuf[keyLen] = '\0';
+  for (uint8_t i = 0; i < sizeof(telegramKeys) / sizeof(telegramKeys[0]); i++) {
+    if (strcmp(keyBuf, telegramKeys[i].name) == 0) {
+      keys[depth - 1] = telegramKeys[i].key;
+      return;
+    }
+  }
+}
+
+// Whole UTF-8 sequences only; a cut never leaves half a character behind
+void TelegramUpdateParser::appendText(const char* bytes, uint8_t len) {
+  if (capture == nullptr || captureCut) return;
+  if (captureLen + len < captureMax) {
+    memcpy(capture + captureLen, bytes, len);
+    captureLen += len;
+    capture[captureLen] = '\0';
+    return;
+  }
+  captureCut = true;
+  // Raw UTF-8 arrives a byte at a time: drop an unfinished trailing sequence
+  int16_t lead = captureLen - 1;
+  while (lead >= 0 && ((uint8_t)capture[lead] & 0xC0) == 0x80) lead--;
+  if (lead >= 0) {
+    uint8_t b = (uint8_t)capture[lead];
+    uint8_t expected = (b >= 0xF0) ? 4 : (b >= 0xE0) ? 3 : (b >= 0xC0) ? 2 : 1;
+    if (captureLen - lead < expected) captureLen = lead;
+  }
+  capture[captureLen] = '\0';
+}
+
+void TelegramUpdateParser::appendCodepoint(uint32_t cp) {
+  char utf8[4];
+  if (cp < 0x80) {
+    utf8[0] = (char)cp;
+    appendText(utf8, 1);
+  } else if (cp < 0x800) {
+    utf8[0] = (char)(0xC0 | (cp >> 6));
+    utf8[1] = (char)(0x80 | (cp & 0x3F));
+    appendText(utf8, 2);
+  } else if (cp < 0x10000) {
+    utf8[0] = (char)(0xE0 | (cp >> 12));
+    utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    utf8[2] = (char)(0x80 | (cp & 0x3F));
+    appendText(utf8, 3);
+  } else {
+    utf8[0] = (char)(0xF0 | (cp >> 18));
+    utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    utf8[3] = (char)(0x80 | (cp & 0x3F));
+    appendText(utf8, 4);
+  }
+}
+
+bool TelegramUpdateParser::beginValue(char c) {
+  field = fieldForValue();
+  if (c == '{') return push(false);
+  if (c == '[') return push(true);
+  if (c == '"') {
+    state = P_STRING;
+    escape = false;
+    hexLeft = 0;
+    highSurrogate = 0;
+    capture = nullptr;
+    if (field == F_TEXT) {
+      capture = current.text;
+      captureMax = TG_TEXT_MAX;
+    } else if (field == F_DESCRIPTION) {
+      capture = description;
+      captureMax = TG_DESCRIPTION_MAX;
+    }
+    if (capture) capture[0] = '\0';
+    captureLen = 0;
+    captureCut = false;
+    return true;
+  }
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    state = P_NUMBER;
+    negative = (c == '-');
+    number = negative ? 0 : c - '0';
+    if (field == F_CHAT_ID) {
+      current.chatId[0] = c;
+      current.chatId[1] = '\0';
+      chatLen = 1;
+    }
+    return true;
+  }
+  if (c == 't' || c == 'f' || c == 'n') {
+    state = P_LITERAL;
+    literalTrue = (c == 't');
+    return true;
+  }
+  return false;
+}
+
+bool TelegramUpdateParser::feedChar(char c) {
+  switch (state) {
+    case P_VALUE:
+      if (isJsonSpace(c)) return true;
+      if (c == ']' && first && depth > 0 && isArray[depth - 1]) return pop(true);
+      first = false;
+      return beginValue(c);
+
+    case P_KEY_OR_END:
+      if (isJsonSpace(c)) return true;
+      if (c == '}' && first) return pop(false);
+      if (c != '"') return false;
+      first = false;
+      keyLen = 0;
+      escape = false;
+      state = P_KEY;
+      return true;
+
+    case P_KEY:
+      if (escape) {
+        escape = false;
+      } else if (c == '\\') {
+        escape = true;
+        keyLen = TG_JSON_KEY_MAX;  // Escaped keys are never ours
+        return true;
+      } else if (c == '"') {
+        endKey();
+        state = P_COLON;
+        return true;
+      }
+      if (keyLen < TG_JSON_KEY_MAX) keyBuf[keyLen++] = c;
+      return true;
+
+    case P_COLON:
+      if (isJsonSpace(c)) return true;
+      if (c != ':') return false;
+      state = P_VALUE;
+      return true;
+
+    case P_NEXT:
+      if (isJsonSpace(c)) return true;
+      if (c == ',') {
+        state = isArray[depth - 1] ? P_VALUE : P_KEY_OR_END;
+        return true;
+      }
+      if (c == '}') return pop(false);
+      if (c == ']') return pop(true);
+      return false;
+
+    case P_STRING:
+      if (hexLeft > 0) {
+        uint8_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return false;
+        hexValue = (hexValue << 4) | digit;
+        if (--hexLeft > 0 || capture == nullptr) return true;
+        if (hexValue >= 0xD800 && hexValue <= 0xDBFF) {
+          highSurrogate = hexValue;  // Completed by the \u escape that follows
+        } else if (hexValue >= 0xDC00 && hexValue <= 0xDFFF) {
+          appendCodepoint(highSurrogate ? 0x10000 + ((highSurrogate - 0xD800) << 10) + (hexValue - 0xDC00) : 0xFFFD);
+          highSurrogate = 0;
+        } else {
+          appendCodepoint(hexValue);
+          highSurrogate = 0;
+        }
+        return true;
+      }
+      if (escape) {
+        escape = false;
+        char decoded;
+        switch (c) {
+          case '"': case '\\': case '/': decoded = c; break;
+          case 'b': decoded = '\b'; break;
+          case 'f': decoded = '\f'; break;
+          case 'n': decoded = '\n'; break;
+          case 'r': decoded = '\r'; break;
+          case 't': decoded = '\t'; break;
+          case 'u':
+            hexLeft = 4;
+            hexValue = 0;
+            return true;
+          default: return false;
+        }
+        appendText(&decoded, 1);
+        return true;
+      }
+      if (c == '\\') {
+        escape = true;
+        return true;
+      }
+      if (c == '"') {
+        if (field == F_TEXT) current.truncated = captureCut;
+        capture = nullptr;
+        return endValue();
+      }
+      if ((uint8_t)c < 0x20) return false;
+      appendText(&c, 1);
+      return true;
+
+    case P_NUMBER:
+      if (c >= '0' && c <= '9') {
+        if (field == F_UPDATE_ID || field == F_DATE || field == F_MESSAGE_ID || field == F_RETRY_AFTER) {
+          number = number * 10 + (c - '0');
+        }
+        if (field == F_CHAT_ID && chatLen < TG_CHAT_ID_MAX - 1) {
+          current.chatId[chatLen++] = c;
+          current.chatId[chatLen] = '\0';
+        }
+        return true;
+      }
+      if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') return true;
+      if (field == F_UPDATE_ID) current.updateId = negative ? -(int32_t)number : (int32_t)number;
+      if (field == F_DATE && !negative) current.date = number;
+      if (field == F_MESSAGE_ID) resultMessageId = (int32_t)number;
+      if (field == F_RETRY_AFTER && !negative) retryAfterS = number;
+      endValue();
+      return feedChar(c);  // The character after a number belongs to the structure
+
+    case P_LITERAL:
+      if (c >= 'a' && c <= 'z') return true;
+      if (field == F_OK && literalTrue) okTrue = true;
+      endValue();
+      return feedChar(c);
+
+    case P_DONE:
+      return true;  // Trailing whitespace
+
+    case P_ERROR:
+      return false;
+  }
+  return false;
+}
+
+size_t telegramJsonEscape(char* out, size_t size, const char* text) {
+  size_t n = 0;
+  for (const char* p = text; *p; p++) {
+    char c = *p;
+    const char* esc = nullptr;
+    if (c == '"') esc = "\\\"";
+    else if (c == '\\') esc = "\\\\";
+    else if (c == '\n') esc = "\\n";
+    else if ((uint8_t)c < 0x20) continue;  // Other control characters are dropped
+    uint8_t b = (uint8_t)c;
+    size_t need = esc ? 2 : (b >= 0xF0) ? 4 : (b >= 0xE0) ? 3 : (b >= 0xC0) ? 2 : 1;
+    if (n + need >= size) break;  // Never half a UTF-8 character
+    if (esc) {
+      out[n++] = esc[0];
+      out[n++] = esc[1];
+    } else {
+      out[n++] = c;
+    }
+  }
+  out[n] = '\0';
+  return n;
+}
@@ -0,0 +1,114 @@
+// Telegram bot API JSON, without I/O
+//
+// A byte-at-a-time tokenizer for bot API response bodies that keeps only
+// the fields the timer uses, in fixed buffers: update_id, message.chat.id,
+// .date and .text of each update, and for POST calls "ok",
+// result.message_id, the error description and parameters.retry_after.
+// Also the escaping for JSON request bodies. No Arduino or heap use, so
+// tools/telegram_parser_bench.py builds it on the host.
+
+#ifndef TELEGRAM_JSON_H
+#define TELEGRAM_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pomodoro_config.h"
+
+#define TG_CHAT_ID_MAX 24      // Chat ids are up to 52-bit signed integers
+#define TG_JSON_MAX_DEPTH 12   // Deeper nesting is rejected
+#define TG_JSON_KEY_MAX 16     // Longer keys are never ones we keep
+#define TG_DESCRIPTION_MAX 48  // Start of an error description
+
+struct TelegramUpdate {
+  int32_t updateId;
+  uint32_t date;                // Message time (Unix), 0 for updates that are not messages
+  char chatId[TG_CHAT_ID_MAX];  // Empty for updates that are not messages
+  char text[TG_TEXT_MAX];
+  bool truncated;               // Text was longer than TG_TEXT_MAX - 1 bytes
+};
+
+// Incremental parser for a getUpdates response body. Updates beyond the
+// capacity are dropped; they are fetched again from the next offset.
+class TelegramUpdateParser {
+ public:
+  void begin(TelegramUpdate* updates, uint8_t capacity);
+  bool feed(const char* data, size_t len);  // false once the input is not valid JSON
+  bool done() const { return state == P_DONE; }
+  bool failed() const { return state == P_ERROR; }
+  bool ok() const { return okTrue; }        // Response had "ok": true
+  uint8_t count() const { return stored; }
+  int32_t messageId() const { return resultMessageId; }      // result.message_id
+  uint32_t retryAfter() const { return retryAfterS; }        // parameters.retry_after (429)
+  const char* errorDescription() const { return description; }
+
+ private:
+  enum State : uint8_t {
+    P_VALUE,        // A value (or ']' right after '[')
+    P_KEY_OR_END,   // A key string (or '}' right after '{')
+    P_KEY,
+    P_COLON,
+    P_NEXT,         // ',' or the end of the container
+    P_STRING,
+    P_NUMBER,
+    P_LITERAL,
+    P_DONE,
+    P_ERROR
+  };
+  enum Field : uint8_t {
+    F_NONE,
+    F_UPDATE_ID,
+    F_CHAT_ID,
+    F_TEXT,
+    F_DATE,
+    F_MESSAGE_ID,
+    F_DESCRIPTION,
+    F_RETRY_AFTER,
+    F_OK
+  };
+
+  bool feedChar(char c);
+  bool beginValue(char c);
+  bool push(bool array);
+  bool pop(bool array);
+  bool endValue();
+  Field fieldForValue() const;
+  void appendText(const char* bytes, uint8_t len);
+  void appendCodepoint(uint32_t cp);
+  void endKey();
+
+  TelegramUpdate* updates;
+  uint8_t capacity;
+  uint8_t stored;
+  TelegramUpdate current;
+  bool okTrue;
+  int32_t resultMessageId;
+  uint32_t retryAfterS;
+  char description[TG_DESCRIPTION_MAX];
+
+  State state;
+  Field field;
+  uint8_t depth;
+  bool isArray[TG_JSON_MAX_DEPTH];
+  uint8_t keys[TG_JSON_MAX_DEPTH];  // Member being read in each object
+  bool first;                       // Container just opened
+
+  char keyBuf[TG_JSON_KEY_MAX];
+  uint8_t keyLen;
+  bool escape;
+  uint8_t hexLeft;                  // Digits still due in a \uXXXX escape
+  uint32_t hexValue;
+  uint32_t highSurrogate;
+  char* capture;                    // String value being kept, or nullptr
+  uint8_t captureMax;
+  uint8_t captureLen;
+  bool captureCut;
+  uint8_t chatLen;
+  bool negative;
+  uint32_t number;
+  bool literalTrue;
+};
+
+// Text as the inside of a JSON string, cut to fit size; returns its length
+size_t telegramJsonEscape(char* out, size_t size, const char* text);
+
+#endif // TELEGRAM_JSON_H
@@ -0,0 +1,61 @@
+// Telegram message table
+//
+// One line per message: X(id, "template"). The templates are const data, so
+// they stay in flash; message_format.h fills "{0}".."{9}" with typed
+// arguments into a caller's buffer. Text is Telegram HTML: literal '&', '<'
+// and '>' in a template must be written as entities.
+
+#ifndef TELEGRAM_MESSAGES_H
+#define TELEGRAM_MESSAGES_H
+
+#define TG_MESSAGES(X) \
+  X(MSG_CONNECTED,            "🍅 Pomodoro Timer connected!") \
+  X(MSG_HELP,                 "🍅 <b>Pomodoro Timer</b>\n\n" \
+                              "/status - Current status\n" \
+                              "/work - Start work\n" \
+                              "/pause - Pause\n" \
+                              "/resume - Resume\n" \
+                              "/stop - Stop\n" \
+                              "/mode - Change mode\n" \
+                              "/stats - Focus time today and this week\n" \
+                              "/export [bin] - Write history to SD\n" \
+                              "/live - Live status message stats\n" \
+                              "/subscribers - Notification fan-out stats\n" \
+                              "/perf - Heap, fragmentation and stack headroom\n" \
+                              "/subscribe, /unsubscribe - Notifications in another chat") \
+  X(MSG_STARTING,             "🍅 Starting...") \
+  X(MSG_PAUSING,              "⏸ Pausing...") \
+  X(MSG_RESUMING,             "▶️ Resuming...") \
+  X(MSG_STOPPING,             "⏹ Stopping...") \
+  X(MSG_MODE,                 "⏱ Mode: {0}") \
+  X(MSG_STATUS,               "🍅 {0} | {1}") \
+  X(MSG_STATUS_BATTERY,       " | 🔋 {0}%") \
+  X(MSG_STATS,                "📊 <b>Focus</b>\nToday: {0} min ({1} sessions)\nThis week: {2} min") \
+  X(MSG_PRE,                  "<pre>{0}</pre>") \
+  X(MSG_SUBSCRIBE_OWNER,      "🔔 This chat always gets notifications") \
+  X(MSG_SUBSCRIBED,           "🔔 Subscribed to timer notifications") \
+  X(MSG_SUBSCRIBERS_FULL,     "🔕 Subscriber list is full") \
+  X(MSG_UNSUBSCRIBED,         "🔕 Unsubscribed") \
+  X(MSG_NOT_SUBSCRIBED,       "🔕 Not subscribed") \
+  X(MSG_EXPORTING,            "💾 Exporting to SD...") \
+  X(MSG_EXPORT_BUSY,          "💾 Export already running") \
+  X(MSG_EXPORT_NO_SD,         "💾 No SD card") \
+  X(MSG_EXPORT_FAILED,        "💾 SD export failed") \
+  X(MSG_EXPORTED,             "💾 Exported {0} bytes to SD ({1} KB/s, worst block {2} ms)") \
+  X(MSG_WORK_STARTED,         "🍅 <b>Work started!</b>") \
+  X(MSG_TIMER_PAUSED,         "⏸ <b>Timer paused</b>") \
+  X(MSG_TIMER_RESUMED,        "▶️ <b>Timer resumed</b>") \
+  X(MSG_TIMER_STOPPED,        "⏹ <b>Timer stopped</b>") \
+  X(MSG_REST_TIME,            "☕ <b>Rest time!</b> Take a break.") \
+  X(MSG_WORK_TIME,            "🍅 <b>Work time!</b> Focus on your task.") \
+  X(MSG_LIVE_HEAD,            "📌 <b>Live status</b> ({0} min since boot)\nAPI calls: {1}") \
+  X(MSG_LIVE_PER_HOUR,        " ({0}/h)") \
+  X(MSG_LIVE_EVENTS,          "\nPer-event messages replaced: {0}") \
+  X(MSG_LIVE_SAVED,           "\nSaved: {0}/h") \
+  X(MSG_LIVE_SKIPPED,         "\nUnchanged renders skipped: {0}") \
+  X(MSG_LIVE_OFF,             "\n(live status is off, events are sent as messages)") \
+  X(MSG_FANOUT_HEAD,          "🔔 <b>Subscribers</b>: {0}/{1}\nLast recipient reached after:") \
+  X(MSG_FANOUT_LINE,          "\n{0} {1}: {2} ms avg, {3} ms max ({4}x)") \
+  X(MSG_FANOUT_NONE,          "\n(nothing sent yet)")
+
+#endif // TELEGRAM_MESSAGES_H
@@ -0,0 +1,165 @@
+// Live Telegram status message implementation
+
+#include "telegram_status.h"
+#include "pomodoro_globals.h"
+#include "timer_logic.h"
+#include "session_log.h"
+#include "storage.h"
+#include "wifi_telegram.h"
+#include "telegram_updates.h"
+#include "telegram_fanout.h"
+#include "app_clock.h"
+#include "deferred_log.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+volatile int32_t telegramStatusMessageId = 0;
+
+struct TelegramStatusText {
+  char text[TG_STATUS_TEXT_MAX];
+};
+
+// Latest rendered status (loop -> telegram task), overwritten, never queued up
+static QueueHandle_t statusQueue = nullptr;
+
+// Loop side
+static bool statusEventPending = true;  // Render once after boot
+static unsigned long lastStatusCheck = 0;
+static char lastStatusText[TG_STATUS_TEXT_MAX] = "";
+
+// Savings report
+static volatile uint32_t statusEvents = 0;       // Per-event messages of the old behaviour
+static volatile uint32_t statusApiCalls = 0;     // sendMessage/editMessageText/pinChatMessage made
+static volatile uint32_t statusSkipped = 0;      // Renders identical to the last one
+
+void sendTelegramEvent(MessageId id) {
+  statusEvents++;
+  const char* message = messageTemplate(id);
+#if TG_LIVE_STATUS
+  statusEventPending = true;
+  if (telegramSubscriberCount() > 0) sendTelegramMessage(message, false);  // Subscribers still get the event
+#else
+  sendTelegramMessage(message);
+#endif
+}
+
+// --- Helper: minutes left as shown, coarse until the last few minutes ---
+static uint32_t statusMinutesLeft() {
+  unsigned long duration = getCurrentDuration();
+  unsigned long elapsed = (currentState == RUNNING) ? (unsigned long)(appMillis64() - startTime) : elapsedBeforePause;
+  uint32_t minutes = (elapsed < duration) ? (duration - elapsed + 59999) / 60000 : 0;
+  if (minutes > TG_STATUS_FINE_MIN) {
+    minutes = (minutes + TG_STATUS_COARSE_MIN - 1) / TG_STATUS_COARSE_MIN * TG_STATUS_COARSE_MIN;
+  }
+  return minutes;
+}
+
+// --- Helper: the status message text ---
+static void renderTelegramStatus(char* out, size_t size) {
+  static const char* const modeNames[] = { "1/1", "25/5", "50/10" };
+  const char* mode = modeNames[currentMode];
+  int len;
+  if (currentState == STOPPED) {
+    len = snprintf(out, size, "⏹ <b>Stopped</b> · %s\n", mode);
+  } else {
+    const char* icon = (currentState == PAUSED) ? "⏸" : isWorkSession ? "🍅" : "☕";
+    const char* label = (currentState == PAUSED) ? "Paused" : isWorkSession ? "Working" : "Resting";
+    uint32_t minutes = statusMinutesLeft();
+    len = snprintf(out, size, "%s <b>%s</b> · %s\n⏱ %s%lu min left\n", icon, label, mode,
+                   (minutes > TG_STATUS_FINE_MIN) ? "~" : "", (unsigned long)minutes);
+  }
+  if (len > 0 && (size_t)len < size) {
+    snprintf(out + len, size - len, "📊 Today: %lu min, %u sessions",
+             (unsigned long)(focusSecondsToday() / 60), workSessionsToday());
+  }
+}
+
+void serviceTelegramStatus() {
+#if TG_LIVE_STATUS
+  if (statusQueue == nullptr) return;
+  bool due = (currentState == RUNNING) && (millis() - lastStatusCheck >= TG_STATUS_CHECK_MS);
+  if (!statusEventPending && !due) return;
+  statusEventPending = false;
+  lastStatusCheck = millis();
+
+  TelegramStatusText status;
+  renderTelegramStatus(status.text, sizeof(status.text));
+  if (strcmp(status.text, lastStatusText) == 0) {
+    statusSkipped++;
+    return;
+  }
+  strcpy(lastStatusText, status.text);
+  xQueueOverwrite(statusQueue, &status);
+#endif
+}
+
+void initTelegramStatus() {
+#if TG_LIVE_STATUS
+  statusQueue = xQueueCreate(1, sizeof(TelegramStatusText));
+#endif
+}
+
+// --- Helper: one bot API call, counted for the report ---
+static bool statusPost(Client& client, const char* token, const char* method, const char* json,
+                       TelegramPostResult& result) {
+  statusApiCalls++;
+  return telegramPost(client, token, method, json, TG_STATUS_TIMEOUT_MS, result);
+}
+
+void pushTelegramStatus(Client& client, const char* token, const char* chatId) {
+  static TelegramStatusText pending;
+  static bool hasPending = false;
+  static unsigned long lastPush = 0;
+  if (statusQueue != nullptr && xQueueReceive(statusQueue, &pending, 0) == pdTRUE) hasPending = true;
+  if (!hasPending || millis() - lastPush < TG_STATUS_MIN_GAP_MS) return;
+  lastPush = millis();
+
+  char escaped[TG_STATUS_TEXT_MAX + 32];
+  telegramJsonEscape(escaped, sizeof(escaped), pending.text);
+  char body[sizeof(escaped) + 128];
+  TelegramPostResult result;
+
+  if (telegramStatusMessageId != 0) {
+    snprintf(body, sizeof(body), "{\"chat_id\":\"%s\",\"message_id\":%ld,\"text\":\"%s\",\"parse_mode\":\"HTML\"}",
+             chatId, (long)telegramStatusMessageId, escaped);
+    if (statusPost(client, token, "editMessageText", body, result) || strstr(result.description, "not modified")) {
+      hasPending = false;
+      return;
+    }
+    if (result.status != 400) return;  // Network or server trouble: retry after the gap
+    LOG(LOG_TG_STATUS_LOST, (uint32_t)telegramStatusMessageId);
+    telegramStatusMessageId = 0;       // Deleted or not editable any more: start a new one
+  }
+
+  snprintf(body, sizeof(body), "{\"chat_id\":\"%s\",\"text\":\"%s\",\"parse_mode\":\"HTML\",\"disable_notification\":true}",
+           chatId, escaped);
+  if (!statusPost(client, token, "sendMessage", body, result) || result.messageId == 0) return;
+  telegramStatusMessageId = result.messageId;
+  saveSettings();
+  hasPending = false;
+
+  snprintf(body, sizeof(body), "{\"chat_id\":\"%s\",\"message_id\":%ld,\"disable_notification\":true}",
+           chatId, (long)telegramStatusMessageId);
+  if (!statusPost(client, token, "pinChatMessage", body, result)) {
+    LOG(LOG_TG_STATUS_PIN_FAILED, (uint32_t)result.status);
+  }
+}
+
+size_t telegramStatusReport(char* out, size_t size) {
+  uint32_t minutes = millis() / 60000;
+  int32_t calls = statusApiCalls;
+  int32_t events = statusEvents;
+  size_t len = formatMessage(out, size, MSG_LIVE_HEAD, { msgUint(minutes), msgInt(calls) });
+  // Per hour over the minutes since boot, in tenths
+  if (minutes > 0) len = appendMessage(out, size, len, MSG_LIVE_PER_HOUR, { msgTenths(calls * 600 / (int32_t)minutes) });
+  len = appendMessage(out, size, len, MSG_LIVE_EVENTS, { msgInt(events) });
+  if (minutes > 0) {
+    len = appendMessage(out, size, len, MSG_LIVE_PER_HOUR, { msgTenths(events * 600 / (int32_t)minutes) });
+    len = appendMessage(out, size, len, MSG_LIVE_SAVED, { msgTenths((events - calls) * 600 / (int32_t)minutes) });
+  }
+  len = appendMessage(out, size, len, MSG_LIVE_SKIPPED, { msgUint(statusSkipped) });
+#if !TG_LIVE_STATUS
+  len = appendMessage(out, size, len, MSG_LIVE_OFF);
+#endif
+  return len;
+}
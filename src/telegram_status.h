@@ -0,0 +1,36 @@
+// Live Telegram status message
+//
+// Instead of a new chat message per timer event, the bot keeps one pinned
+// status message and edits it in place. The loop renders the status text
+// on events and every TG_STATUS_CHECK_MS while running, with the time left
+// in coarse steps until the last minutes, and only hands text that differs
+// from the last render to the Telegram task. The task edits the message
+// (editMessageText), never more often than TG_STATUS_MIN_GAP_MS, and sends
+// and pins a new one if the old one is gone. /live reports API calls per
+// hour against the per-event messages it replaced.
+
+#ifndef TELEGRAM_STATUS_H
+#define TELEGRAM_STATUS_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "pomodoro_config.h"
+#include "message_format.h"
+
+// Pinned status message, persisted with the settings (0 = none yet)
+extern volatile int32_t telegramStatusMessageId;
+
+// A timer event that used to be its own chat message. With TG_LIVE_STATUS
+// it refreshes the status message and goes to subscribers only; otherwise
+// the message is sent to every chat.
+void sendTelegramEvent(MessageId id);
+
+// Loop side: render the status and queue it when it changed
+void serviceTelegramStatus();
+
+// Telegram task side
+void initTelegramStatus();
+void pushTelegramStatus(Client& client, const char* token, const char* chatId);
+size_t telegramStatusReport(char* out, size_t size);  // /live, as formatMessage
+
+#endif // TELEGRAM_STATUS_H
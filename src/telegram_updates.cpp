@@ -0,0 +1,242 @@
+// Streaming getUpdates client implementation
+
+#include "telegram_updates.h"
+#include "deferred_log.h"
+
+#define TG_HOST "api.telegram.org"
+#define TG_READ_CHUNK 128   // TLS reads go through this stack buffer
+#define TG_LINE_MAX 96      // Longer header lines are cut, only their start matters
+
+// --- Helper: buffered reads from the TLS client, with a deadline ---
+struct TelegramReader {
+  Client& client;
+  uint32_t timeoutMs;
+  uint32_t lastData;
+  uint8_t buf[TG_READ_CHUNK];
+  uint8_t pos;
+  uint8_t len;
+
+  TelegramReader(Client& client, uint32_t timeoutMs)
+      : client(client), timeoutMs(timeoutMs), lastData(millis()), pos(0), len(0) {}
+
+  int read() {
+    if (pos < len) return buf[pos++];
+    while (millis() - lastData < timeoutMs) {
+      int avail = client.available();
+      if (avail > 0) {
+        int n = client.read(buf, (avail < TG_READ_CHUNK) ? avail : TG_READ_CHUNK);
+        if (n > 0) {
+          len = n;
+          pos = 0;
+          lastData = millis();
+          return buf[pos++];
+        }
+      } else if (!client.connected()) {
+        return -1;
+      }
+      delay(1);
+    }
+    return -1;
+  }
+
+  // Line without CR/LF, lowercased, cut at max - 1 characters
+  bool readLine(char* line, size_t max) {
+    size_t n = 0;
+    while (true) {
+      int c = read();
+      if (c < 0) return false;
+      if (c == '\n') break;
+      if (c != '\r' && n < max - 1) line[n++] = tolower(c);
+    }
+    line[n] = '\0';
+    return true;
+  }
+};
+
+// --- Helper: Unix time of an HTTP date ("date: sun, 19 oct 2026 10:00:00 gmt", lowercased) ---
+static uint32_t telegramHttpDate(const char* value) {
+  static const char months[] = "janfebmaraprmayjunjulaugsepoctnovdec";
+  const char* p = strchr(value, ',');
+  char month[4];
+  int day, year, hour, minute, second;
+  if (p == nullptr || sscanf(p + 1, " %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6) return 0;
+  const char* m = strstr(months, month);
+  if (m == nullptr || (m - months) % 3 != 0 || year < 1970) return 0;
+  int mon = (m - months) / 3 + 1;
+
+  // Days since 1970-01-01 in the proleptic Gregorian calendar
+  int y = year - (mon <= 2);
+  int era = y / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int32_t days = era * 146097 + doe - 719468;
+  return (uint32_t)days * 86400UL + hour * 3600UL + minute * 60UL + second;
+}
+
+// --- Helper: give up on the response; the connection is in an unknown state ---
+static int telegramFetchFailed(Client& client, const char* reason, uint32_t detail) {
+  client.stop();
+  LOG(LOG_TG_POLL_FAILED, reason, detail);
+  return -1;
+}
+
+// --- Helper: connect if needed and write one request ---
+static bool telegramSend(Client& client, const char* head, size_t headLen, const char* body, size_t bodyLen) {
+  if (!client.connected() && !client.connect(TG_HOST, 443)) {
+    telegramFetchFailed(client, "connect", 0);
+    return false;
+  }
+  client.write((const uint8_t*)head, headLen);
+  if (bodyLen > 0) client.write((const uint8_t*)body, bodyLen);
+  return true;
+}
+
+// --- Helper: read one response and run its body through the parser ---
+// Returns the HTTP status with the body consumed (the connection stays
+// usable unless the server asked to close it), or -1 after closing the
+// connection. The reader may hold the start of a pipelined next response.
+static int telegramReceive(Client& client, TelegramReader& reader, TelegramUpdateParser& parser,
+                           uint32_t* serverTime) {
+  if (serverTime) *serverTime = 0;
+  char line[TG_LINE_MAX];
+  if (!reader.readLine(line, sizeof(line))) return telegramFetchFailed(client, "timeout", 0);
+  int status = (strncmp(line, "http/", 5) == 0 && strlen(line) > 9) ? atoi(line + 9) : 0;
+
+  int32_t contentLength = -1;
+  bool chunked = false;
+  bool closeAfter = false;
+  while (true) {
+    if (!reader.readLine(line, sizeof(line))) return telegramFetchFailed(client, "timeout", 0);
+    if (line[0] == '\0') break;
+    if (strncmp(line, "content-length:", 15) == 0) contentLength = atol(line + 15);
+    if (strncmp(line, "transfer-encoding:", 18) == 0 && strstr(line, "chunked")) chunked = true;
+    if (strncmp(line, "connection:", 11) == 0 && strstr(line, "close")) closeAfter = true;
+    if (strncmp(line, "date:", 5) == 0 && serverTime) *serverTime = telegramHttpDate(line + 5);
+  }
+
+  if (chunked) {
+    while (true) {
+      if (!reader.readLine(line, sizeof(line))) return telegramFetchFailed(client, "timeout", 0);
+      uint32_t chunk = strtoul(line, nullptr, 16);
+      if (chunk == 0) {
+        reader.readLine(line, sizeof(line));  // Blank line after the last chunk
+        break;
+      }
+      while (chunk-- > 0) {
+        int c = reader.read();
+        if (c < 0) return telegramFetchFailed(client, "timeout", 0);
+        char ch = c;
+        if (!parser.feed(&ch, 1)) return telegramFetchFailed(client, "json", status);
+      }
+      if (!reader.readLine(line, sizeof(line))) return telegramFetchFailed(client, "timeout", 0);
+    }
+  } else {
+    // Without a length the body ends when the server closes the connection
+    for (int32_t left = contentLength; left != 0; left--) {
+      int c = reader.read();
+      if (c < 0) {
+        if (contentLength < 0) break;
+        return telegramFetchFailed(client, "timeout", 0);
+      }
+      char ch = c;
+      if (!parser.feed(&ch, 1)) return telegramFetchFailed(client, "json", status);
+    }
+    if (contentLength < 0) closeAfter = true;
+  }
+
+  if (!parser.done()) return telegramFetchFailed(client, "json", status);
+  if (closeAfter) client.stop();
+  return status;
+}
+
+// --- Helper: one request, one response ---
+static int telegramExchange(Client& client, const char* head, size_t headLen, const char* body, size_t bodyLen,
+                            TelegramUpdateParser& parser, uint32_t timeoutMs, uint32_t* serverTime) {
+  if (!telegramSend(client, head, headLen, body, bodyLen)) return -1;
+  TelegramReader reader(client, timeoutMs);
+  return telegramReceive(client, reader, parser, serverTime);
+}
+
+int fetchTelegramUpdates(Client& client, const char* token, int32_t offset,
+                         TelegramUpdate* updates, uint8_t capacity, uint32_t timeoutMs,
+                         uint32_t* serverTime) {
+  char head[TG_LINE_MAX + 64];
+  int len = snprintf(head, sizeof(head), "GET /bot%s/getUpdates?offset=%ld&limit=%u HTTP/1.1\r\nHost: " TG_HOST "\r\n\r\n",
+                     token, (long)offset, capacity);
+  if (len <= 0 || len >= (int)sizeof(head)) return telegramFetchFailed(client, "request", len);
+
+  TelegramUpdateParser parser;
+  parser.begin(updates, capacity);
+  int status = telegramExchange(client, head, len, nullptr, 0, parser, timeoutMs, serverTime);
+  if (status < 0) return -1;
+  if (status != 200 || !parser.ok()) {
+    LOG(LOG_TG_POLL_FAILED, "http", (uint32_t)status);
+    return -1;
+  }
+  return parser.count();
+}
+
+// --- Helper: request line and headers of a JSON POST ---
+static int telegramPostHead(char* head, size_t size, const char* token, const char* method, size_t bodyLen) {
+  return snprintf(head, size,
+                  "POST /bot%s/%s HTTP/1.1\r\nHost: " TG_HOST "\r\nContent-Type: application/json\r\n"
+                  "Content-Length: %u\r\n\r\n",
+                  token, method, (unsigned)bodyLen);
+}
+
+// --- Helper: what a POST response said ---
+static bool telegramPostResult(int status, const TelegramUpdateParser& parser, TelegramPostResult& result) {
+  result.status = status;
+  if (status < 0) return false;
+  result.ok = parser.ok();
+  result.messageId = parser.messageId();
+  result.retryAfter = parser.retryAfter();
+  strncpy(result.description, parser.errorDescription(), sizeof(result.description) - 1);
+  return status == 200 && result.ok;
+}
+
+bool telegramPost(Client& client, const char* token, const char* method, const char* json,
+                  uint32_t timeoutMs, TelegramPostResult& result) {
+  memset(&result, 0, sizeof(result));
+  size_t bodyLen = strlen(json);
+  char head[TG_LINE_MAX + 128];
+  int len = telegramPostHead(head, sizeof(head), token, method, bodyLen);
+  if (len <= 0 || len >= (int)sizeof(head)) {
+    result.status = telegramFetchFailed(client, "request", len);
+    return false;
+  }
+
+  TelegramUpdateParser parser;
+  parser.begin(nullptr, 0);
+  int status = telegramExchange(client, head, len, json, bodyLen, parser, timeoutMs, nullptr);
+  return telegramPostResult(status, parser, result);
+}
+
+uint8_t telegramPostPipelined(Client& client, const char* token, const char* method,
+                              const char* const* jsons, uint8_t count, uint32_t timeoutMs,
+                              TelegramPostResult* results) {
+  char head[TG_LINE_MAX + 128];
+  uint8_t written = 0;
+  for (; written < count; written++) {
+    memset(&results[written], 0, sizeof(results[written]));
+    results[written].status = -1;
+    size_t bodyLen = strlen(jsons[written]);
+    int len = telegramPostHead(head, sizeof(head), token, method, bodyLen);
+    if (len <= 0 || len >= (int)sizeof(head)) break;
+    if (!telegramSend(client, head, len, jsons[written], bodyLen)) break;
+  }
+
+  // Responses come back in request order, possibly several per TLS read
+  TelegramReader reader(client, timeoutMs);
+  uint8_t answered = 0;
+  while (answered < written && client.connected()) {
+    TelegramUpdateParser parser;
+    parser.begin(nullptr, 0);
+    int status = telegramReceive(client, reader, parser, nullptr);
+    if (status < 0) break;
+    telegramPostResult(status, parser, results[answered++]);
+  }
+  if (answered < written) client.stop();  // Requests in flight would answer into the next call
+  return answered;
+}
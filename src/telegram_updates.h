@@ -0,0 +1,52 @@
+// Streaming client for the Telegram bot API
+//
+// UniversalTelegramBot::getUpdates() reads the whole response into a heap
+// String and deserializes it into a JSON document before copying each
+// message into more Strings, so a burst of updates or one long message
+// spikes and fragments the heap. Here the HTTPS response is read through a
+// small stack buffer and fed to a byte-at-a-time JSON tokenizer
+// (telegram_json.h) that keeps
+// only update_id, message.chat.id and message.text, in fixed buffers. Heap
+// use does not depend on the response size. POST calls (sendMessage,
+// editMessageText, ...) go through the same reader and keep only
+// result.message_id, the error description and parameters.retry_after;
+// several can be pipelined on the one connection.
+
+#ifndef TELEGRAM_UPDATES_H
+#define TELEGRAM_UPDATES_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "pomodoro_config.h"
+#include "telegram_json.h"
+
+// GET /getUpdates from offset on the bot's TLS client, at most capacity
+// updates. Returns the number stored, or -1 on a connection, HTTP or
+// parse failure (the connection is closed then). serverTime, if given,
+// receives the response's Date header as Unix time (0 if missing), a
+// clock to age messages by before NTP has synced.
+int fetchTelegramUpdates(Client& client, const char* token, int32_t offset,
+                         TelegramUpdate* updates, uint8_t capacity, uint32_t timeoutMs,
+                         uint32_t* serverTime = nullptr);
+
+struct TelegramPostResult {
+  int status;                   // HTTP status, -1 if the request failed
+  bool ok;
+  int32_t messageId;            // result.message_id, 0 if none
+  uint32_t retryAfter;          // Seconds to wait after a 429, 0 if not given
+  char description[TG_DESCRIPTION_MAX];
+};
+
+// POST a JSON body to a bot API method. True on HTTP 200 with "ok": true.
+bool telegramPost(Client& client, const char* token, const char* method, const char* json,
+                  uint32_t timeoutMs, TelegramPostResult& result);
+
+// POST count JSON bodies to one method, pipelined: all requests are
+// written before the first response is read. Returns how many were
+// answered, in order; the rest (status -1) were cut off by a failure or the
+// server closing the connection and can be sent again.
+uint8_t telegramPostPipelined(Client& client, const char* token, const char* method,
+                              const char* const* jsons, uint8_t count, uint32_t timeoutMs,
+                              TelegramPostResult* results);
+
+#endif // TELEGRAM_UPDATES_H
@@ -6,6 +6,11 @@
 #include "wifi_telegram.h"
 #include "display_updates.h"
 #include "color_utils.h"
+#include "deferred_log.h"
+#include "session_log.h"
+#include "app_clock.h"
+#include "input_trace.h"
+#include "telegram_status.h"
 
 // Last telegram send time to prevent duplicates
 static unsigned long lastTgSendTime = 0;
@@ -13,55 +18,62 @@ const unsigned long TG_SEND_DEBOUNCE = 3000;  // 3 seconds
 
 void startTimer() {
   if (currentState == RUNNING) return;
-  Serial.println("[TIMER] startTimer called");
+  LOG(LOG_TIMER_START);
+  traceAction(ACT_START);
   currentState = RUNNING;
   isWorkSession = true;
-  startTime = millis();
-  timerStartTime = millis();
+  startTime = appMillis64();
+  timerStartTime = startTime;
   elapsedBeforePause = 0;
+  sessionStarted();
   displayInitialized = false;
   forceCircleRedraw = true;
-  if (millis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
-    lastTgSendTime = millis();
-    sendTelegramMessage("🍅 <b>Work started!</b>");
+  if (appMillis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
+    lastTgSendTime = appMillis();
+    sendTelegramEvent(MSG_WORK_STARTED);
   }
 }
 
 void pauseTimer() {
   if (currentState != RUNNING) return;
-  Serial.println("[TIMER] pauseTimer called");
+  LOG(LOG_TIMER_PAUSE);
+  traceAction(ACT_PAUSE);
   currentState = PAUSED;
-  pausedTime = millis();
-  elapsedBeforePause = millis() - startTime;
+  pausedTime = appMillis64();
+  elapsedBeforePause = (unsigned long)(pausedTime - startTime);
   displayInitialized = false;
   forceCircleRedraw = true;
-  if (millis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
-    lastTgSendTime = millis();
-    sendTelegramMessage("⏸ <b>Timer paused</b>");
+  if (appMillis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
+    lastTgSendTime = appMillis();
+    sendTelegramEvent(MSG_TIMER_PAUSED);
   }
 }
 
 void resumeTimer() {
   if (currentState != PAUSED) return;
-  Serial.println("[TIMER] resumeTimer called");
+  LOG(LOG_TIMER_RESUME);
+  traceAction(ACT_RESUME);
   currentState = RUNNING;
-  startTime = millis() - elapsedBeforePause;
+  startTime = appMillis64() - elapsedBeforePause;
   displayInitialized = false;
   forceCircleRedraw = true;
-  if (millis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
-    lastTgSendTime = millis();
-    sendTelegramMessage("▶️ <b>Timer resumed</b>");
+  if (appMillis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
+    lastTgSendTime = appMillis();
+    sendTelegramEvent(MSG_TIMER_RESUMED);
   }
 }
 
 void stopTimer() {
   if (currentState == STOPPED) return;
-  Serial.println("[TIMER] stopTimer called");
+  LOG(LOG_TIMER_STOP);
+  traceAction(ACT_STOP);
+  unsigned long active = (currentState == RUNNING) ? (unsigned long)(appMillis64() - startTime) : elapsedBeforePause;
+  sessionEnded(isWorkSession, currentMode, active, true);
   currentState = STOPPED;
   displayInitialized = false;
-  if (millis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
-    lastTgSendTime = millis();
-    sendTelegramMessage("⏹ <b>Timer stopped</b>");
+  if (appMillis() - lastTgSendTime > TG_SEND_DEBOUNCE) {
+    lastTgSendTime = appMillis();
+    sendTelegramEvent(MSG_TIMER_STOPPED);
   }
   displayStoppedState();
 }
@@ -88,21 +100,28 @@ unsigned long getCurrentDuration() {
 void updateTimer() {
   // Only update timer if it's actually running and we're not on home/preview screens
   if (currentState == RUNNING && currentViewMode == 0) {
-    unsigned long elapsed = millis() - startTime;
+    uint64_t now = appMillis64();
+    unsigned long elapsed = (unsigned long)(now - startTime);
     unsigned long duration = getCurrentDuration();
     if (elapsed >= duration) {
+      sessionEnded(isWorkSession, currentMode, duration, false);
+      sessionStarted();
       if (isWorkSession) {
         isWorkSession = false;
-        startTime = millis();
+        startTime = now;
+#if !USE_INDEXED_CANVAS
         displayInitialized = false;  // Force redraw to update colors
+#endif
         // Send Telegram notification
-        sendTelegramMessage("☕ <b>Rest time!</b> Take a break.");
+        sendTelegramEvent(MSG_REST_TIME);
       } else {
         isWorkSession = true;
-        startTime = millis();
+        startTime = now;
+#if !USE_INDEXED_CANVAS
         displayInitialized = false;  // Force redraw to update colors
+#endif
         // Send Telegram notification
-        sendTelegramMessage("🍅 <b>Work time!</b> Focus on your task.");
+        sendTelegramEvent(MSG_WORK_TIME);
       }
     }
   }
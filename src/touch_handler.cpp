@@ -8,6 +8,11 @@
 #include "timer_logic.h"
 #include "storage.h"
 #include "color_utils.h"
+#include "deferred_log.h"
+#include "app_clock.h"
+#include "input_trace.h"
+#include "profiler.h"
+#include "backlight.h"
 #include <Wire.h>
 #include <string.h>
 
@@ -21,9 +26,17 @@ bool longPressDetected = false;
 static bool lastIntState = HIGH;
 static unsigned long lastTpIntLowTime = 0;
 
+// --- Helper: TP_INT level, recorded into the input trace ---
+static int readTpInt() {
+  int level = digitalRead(TP_INT);
+  traceRecordTouchInt(level);
+  return level;
+}
+
 // Read touch data directly from I2C (working method from test)
-void readTouchData() {
-  bool currentIntState = digitalRead(TP_INT);
+void HOT_IRAM_ATTR readTouchData() {
+  PROFILE_SCOPE(PROF_READ_TOUCH);
+  bool currentIntState = readTpInt();
   
   if (currentIntState == LOW && lastIntState == HIGH) {
     // Touch just started - read immediately
@@ -126,21 +139,22 @@ void readTouchData() {
   }
   
   lastIntState = currentIntState;
+  traceRecordTouchPoints(touch_points);
 }
 
 void handleTouchInput() {
   // Read TP_INT with debouncing to filter out noise
-  bool tpIntLow = (digitalRead(TP_INT) == LOW);
+  bool tpIntLow = (readTpInt() == LOW);
   static unsigned long lastTpIntHighTime = 0;
   
   if (tpIntLow) {
-    lastTpIntLowTime = millis();
+    lastTpIntLowTime = appMillis();
     // Reset HIGH time when we see LOW again
     lastTpIntHighTime = 0;
   } else {
     // TP_INT is HIGH - track when it went HIGH
     if (lastTpIntHighTime == 0) {
-      lastTpIntHighTime = millis();
+      lastTpIntHighTime = appMillis();
     }
   }
   
@@ -149,8 +163,8 @@ void handleTouchInput() {
   // 2. TP_INT was LOW recently (within debounce window), OR  
   // 3. TP_INT has been HIGH for less than debounce time (might be noise)
   bool currentlyTouched = tpIntLow || 
-                          (millis() - lastTpIntLowTime < TP_INT_DEBOUNCE_MS) ||
-                          (lastTpIntHighTime > 0 && (millis() - lastTpIntHighTime < TP_INT_DEBOUNCE_MS));
+                          (appMillis() - lastTpIntLowTime < TP_INT_DEBOUNCE_MS) ||
+                          (lastTpIntHighTime > 0 && (appMillis() - lastTpIntHighTime < TP_INT_DEBOUNCE_MS));
   
   // Read touch data for coordinates (but don't use it for state detection)
   readTouchData();
@@ -163,21 +177,20 @@ void handleTouchInput() {
   }
 
   if (currentlyTouched && !touchPressed) {
-    Serial.println(">>> TOUCH PRESSED <<<");
+    LOG(LOG_TOUCH_PRESSED);
+    backlightActivity();  // Full brightness before the tap is handled
     touchPressed = true;
-    touchStartTime = millis();
+    touchStartTime = appMillis();
     longPressDetected = false;
     // (optional) could capture initial touch position here if needed later
   } else if (!currentlyTouched && touchPressed) {
-    unsigned long touchDuration = millis() - touchStartTime;
-    Serial.print(">>> TOUCH RELEASED after ");
-    Serial.print(touchDuration);
-    Serial.println(" ms <<<");
+    unsigned long touchDuration = appMillis() - touchStartTime;
+    LOG(LOG_TOUCH_RELEASED, touchDuration);
 
     // Only process short tap if long press wasn't already handled
     // Reduced threshold from 50ms to 10ms for faster response
     // Also block short taps for a short period after timer start to prevent accidental pause
-    unsigned long timeSinceStart = (timerStartTime > 0) ? (millis() - timerStartTime) : SHORT_TAP_BLOCK_MS + 1;
+    unsigned long timeSinceStart = (timerStartTime > 0) ? (unsigned long)(appMillis64() - timerStartTime) : SHORT_TAP_BLOCK_MS + 1;
     bool blockShortTap = (timeSinceStart < SHORT_TAP_BLOCK_MS);
     
     if (!longPressDetected && touchDuration > 10 && !blockShortTap) {
@@ -190,10 +203,11 @@ void handleTouchInput() {
         tapIndicatorX = tx;
         tapIndicatorY = ty;
         tapIndicatorActive = true;
-        tapIndicatorStart = millis();
+        tapIndicatorStart = appMillis();
       }
 
       // Check for grid view buttons (X and ✓) when grid is active
+      bool tapHandled = true;  // False for taps outside every button
       bool inGridCancelButton = false;
       bool inGridConfirmButton = false;
       int8_t tappedColorIndex = -1;  // Color cell tapped in grid (-1 = none)
@@ -322,22 +336,19 @@ void handleTouchInput() {
 
       if (inGridCancelButton) {
         // X button clicked in grid view - return to home screen without saving
-        Serial.println("*** GRID CANCEL (X) BUTTON CLICKED ***");
+        LOG(LOG_GRID_CANCEL);
         tempSelectedColorIndex = -1;  // Clear temporary selection
         gridViewActive = false;
         currentViewMode = 0;  // Return to home
         displayStoppedState();  // Return to home screen
       } else if (inGridConfirmButton) {
         // ✓ button clicked in grid view - go to color preview or save rest color
-        Serial.println("*** GRID CONFIRM (✓) BUTTON CLICKED ***");
+        LOG(LOG_GRID_CONFIRM);
         if (tempSelectedColorIndex >= 0 && tempSelectedColorIndex < paletteSize) {
           if (selectingRestColor) {
             // Saving rest color selection
             tempPreviewRestColor = paletteColors[tempSelectedColorIndex];
-            Serial.print("-> Selected rest color index: ");
-            Serial.print(tempSelectedColorIndex);
-            Serial.print(", color: 0x");
-            Serial.println(tempPreviewRestColor, HEX);
+            LOG(LOG_GRID_REST_SELECTED, tempSelectedColorIndex, tempPreviewRestColor);
             selectingRestColor = false;
             gridViewActive = false;
             currentViewMode = 2;  // Switch to color preview
@@ -345,10 +356,7 @@ void handleTouchInput() {
           } else {
             // Saving work color selection
             tempPreviewColor = paletteColors[tempSelectedColorIndex];
-            Serial.print("-> Preview color index: ");
-            Serial.print(tempSelectedColorIndex);
-            Serial.print(", color: 0x");
-            Serial.println(tempPreviewColor, HEX);
+            LOG(LOG_GRID_WORK_PREVIEW, tempSelectedColorIndex, tempPreviewColor);
             tempSelectedColorIndex = -1;  // Clear temporary selection
             gridViewActive = false;
             currentViewMode = 2;  // Switch to color preview
@@ -357,11 +365,7 @@ void handleTouchInput() {
         }
       } else if (tappedColorIndex >= 0) {
         // Color cell tapped - select it
-        Serial.print("*** COLOR CELL TAPPED: ");
-        Serial.print(tappedColorIndex);
-        Serial.print(" (0x");
-        Serial.print(paletteColors[tappedColorIndex], HEX);
-        Serial.println(") ***");
+        LOG(LOG_GRID_CELL_TAPPED, tappedColorIndex, paletteColors[tappedColorIndex]);
         
         // Calculate row and col from color index
         bool isLandscape = (currentRotation == 1 || currentRotation == 3);
@@ -386,14 +390,14 @@ void handleTouchInput() {
         }
       } else if (inPreviewCancelButton) {
         // X button clicked on color preview - return to home without saving
-        Serial.println("*** PREVIEW CANCEL (X) BUTTON CLICKED ***");
+        LOG(LOG_PREVIEW_CANCEL);
         selectingRestColor = false;
         tempPreviewRestColor = 0;
         currentViewMode = 0;
         displayStoppedState();
       } else if (inPreviewWorkSwatch) {
         // Work color swatch clicked - open color picker for work color
-        Serial.println("*** WORK COLOR SWATCH CLICKED ***");
+        LOG(LOG_PREVIEW_WORK_SWATCH);
         selectingRestColor = false;  // Selecting work color
         tempSelectedColorIndex = -1;  // Reset temporary selection
         gridViewActive = true;
@@ -401,7 +405,7 @@ void handleTouchInput() {
         drawGrid();
       } else if (inPreviewRestSwatch) {
         // Rest color swatch clicked - open color picker for rest color
-        Serial.println("*** REST COLOR SWATCH CLICKED ***");
+        LOG(LOG_PREVIEW_REST_SWATCH);
         selectingRestColor = true;
         tempSelectedColorIndex = -1;  // Reset temporary selection
         tempPreviewRestColor = 0;     // Reset to use inverted work color by default
@@ -410,28 +414,26 @@ void handleTouchInput() {
         drawGrid();
       } else if (inPreviewConfirmButton) {
         // V button clicked on color preview - save colors and return to home
-        Serial.println("*** PREVIEW CONFIRM (V) BUTTON CLICKED ***");
+        LOG(LOG_PREVIEW_CONFIRM);
         selectedWorkColor = tempPreviewColor;
         if (tempPreviewRestColor != 0) {
           selectedRestColor = tempPreviewRestColor;
         } else {
           selectedRestColor = 0;  // Use inverted work color
         }
-        saveSelectedColor();  // Save to NVS for persistence
-        Serial.print("-> Saved work color: 0x");
-        Serial.println(selectedWorkColor, HEX);
+        saveSettings();  // Persisted to NVS once the settings settle
+        LOG(LOG_PREVIEW_SAVED_WORK, selectedWorkColor);
         if (selectedRestColor != 0) {
-          Serial.print("-> Saved rest color: 0x");
-          Serial.println(selectedRestColor, HEX);
+          LOG(LOG_PREVIEW_SAVED_REST, selectedRestColor);
         } else {
-          Serial.println("-> Rest color: inverted work color");
+          LOG(LOG_PREVIEW_REST_INVERT);
         }
         selectingRestColor = false;
         currentViewMode = 0;
         displayStoppedState();
       } else if (inGearButton) {
         // Gear button clicked on home screen - show theme color demo screen (color preview)
-        Serial.println("*** GEAR BUTTON CLICKED ***");
+        LOG(LOG_GEAR_CLICKED);
         selectingRestColor = false;  // Start with work color selection
         tempSelectedColorIndex = -1;  // Reset temporary selection
         tempPreviewColor = selectedWorkColor;  // Initialize preview with current work color
@@ -440,37 +442,38 @@ void handleTouchInput() {
         drawColorPreview();
       } else if (inModeButton) {
         // Cycle through modes: 1/1 -> 25/5 -> 50/10 -> 1/1
-        Serial.println("*** MODE BUTTON CLICKED ***");
+        LOG(LOG_MODE_CLICKED);
         PomodoroMode oldMode = currentMode;
         switch (currentMode) {
           case MODE_1_1:
             currentMode = MODE_25_5;
-            Serial.println("-> Switched to 25/5 mode");
+            LOG(LOG_MODE_SWITCHED, "25/5");
             break;
           case MODE_25_5:
             currentMode = MODE_50_10;
-            Serial.println("-> Switched to 50/10 mode");
+            LOG(LOG_MODE_SWITCHED, "50/10");
             break;
           case MODE_50_10:
             currentMode = MODE_1_1;
-            Serial.println("-> Switched to 1/1 mode");
+            LOG(LOG_MODE_SWITCHED, "1/1");
             break;
         }
+        saveSettings();
         // Force immediate mode button update
         lastDisplayedMode = oldMode;
         updateDisplay();
       } else if (inCircle) {
         // Toggle time display mode (MM:SS <-> MM)
-        Serial.println("*** CIRCLE TAPPED - TOGGLE TIME DISPLAY MODE ***");
+        LOG(LOG_CIRCLE_TAPPED);
         showMinutesOnly = !showMinutesOnly;
-        Serial.print("-> Switched to ");
-        Serial.println(showMinutesOnly ? "MM only" : "MM:SS");
+        LOG(LOG_TIME_FORMAT, showMinutesOnly ? "MM only" : "MM:SS");
+        saveSettings();
         // Force immediate time display update
         lastShowMinutesOnly = !showMinutesOnly;  // Force redraw
         strcpy(lastTimeStr, "");  // Clear last time string to force redraw
         updateDisplay();
       } else if (inStatusButton && (currentState == RUNNING || currentState == PAUSED)) {
-        Serial.println("*** STATUS BUTTON CLICKED ***");
+        LOG(LOG_STATUS_CLICKED);
         // Save old state before changing
         TimerState oldState = currentState;
         if (currentState == RUNNING) {
@@ -485,41 +488,39 @@ void handleTouchInput() {
         updateDisplay();
       } else {
         // Tap outside button area — только индикатор
-        Serial.println("*** SHORT TAP ignored (outside button) ***");
+        LOG(LOG_TOUCH_TAP_OUTSIDE);
+        tapHandled = false;
       }
+      if (tapHandled) traceAction(ACT_TAP);  // No-op if the tap already started/paused the timer
     } else if (longPressDetected) {
-      Serial.println("*** LONG PRESS was already handled ***");
+      LOG(LOG_TOUCH_LONG_HANDLED);
     } else if (blockShortTap) {
-      Serial.println("*** SHORT TAP blocked (too soon after timer start) ***");
+      LOG(LOG_TOUCH_TAP_BLOCKED);
     }
     touchPressed = false;
     longPressDetected = false;
 
   } else if (touchPressed) {
-    unsigned long elapsed = millis() - touchStartTime;
+    unsigned long elapsed = appMillis() - touchStartTime;
     
     // Check for long press (only once per touch)
     if (elapsed > LONG_PRESS_MS && !longPressDetected) {
       longPressDetected = true;
-      Serial.print("*** LONG PRESS detected! (");
-      Serial.print(elapsed);
-      Serial.println(" ms) ***");
+      LOG(LOG_TOUCH_LONG_PRESS, elapsed);
       // Execute long press action immediately
       if (currentState == STOPPED) {
-        Serial.println("-> Starting timer");
+        LOG(LOG_TOUCH_LONG_START);
         startTimer();
       } else {
-        Serial.println("-> Stopping timer");
+        LOG(LOG_TOUCH_LONG_STOP);
         stopTimer();
       }
       // Don't reset - only one long press per touch
     }
   }
   static unsigned long lastDebug = 0;
-  if (millis() - lastDebug > 2000) {
-    Serial.print(digitalRead(TP_INT));
-    Serial.print(touch_points.touch_num);
-    Serial.println(touchPressed);
-    lastDebug = millis();
+  if (appMillis() - lastDebug > 2000) {
+    LOG(LOG_TOUCH_STATE, digitalRead(TP_INT), touch_points.touch_num, touchPressed);
+    lastDebug = appMillis();
   }
 }
@@ -1,13 +1,20 @@
 // WiFi and Telegram bot implementation
 
 #include "wifi_telegram.h"
+#include "remote_commands.h"
 #include "pomodoro_globals.h"
-#include "display_updates.h"
-#include "timer_logic.h"
+#include "storage.h"
+#include "session_log.h"
+#include "deferred_log.h"
+#include "profiler.h"
+#include "telegram_updates.h"
+#include "telegram_status.h"
+#include "telegram_fanout.h"
+#include "battery.h"
+#include "mem_telemetry.h"
+#include "message_format.h"
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
-#include <UniversalTelegramBot.h>
-#include <ArduinoJson.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
@@ -23,22 +30,23 @@ const char* chatId = TELEGRAM_CHAT_ID;
 
 // WiFi client for Telegram
 WiFiClientSecure telegramClient;
-UniversalTelegramBot* bot = nullptr;
+static bool telegramReady = false;  // Client set up, the task may poll
 
 // FreeRTOS task handle for Telegram
 TaskHandle_t telegramTaskHandle = nullptr;
 
-// Thread-safe command queue from Telegram to main loop
-volatile bool telegramCmdStart = false;
-volatile bool telegramCmdPause = false;
-volatile bool telegramCmdResume = false;
-volatile bool telegramCmdStop = false;
-volatile bool telegramCmdMode = false;
+// Last update_id handled, persisted with the settings
+volatile int32_t telegramLastUpdateId = 0;
+
+// Updates of the current getUpdates call (boot drain and polling)
+static TelegramUpdate telegramUpdates[TG_UPDATES_PER_POLL];
 
 // Outgoing message queue (main loop -> telegram task)
 QueueHandle_t telegramMsgQueue = nullptr;
 struct TelegramMsg {
-  char text[128];
+  char text[TG_NOTIFY_TEXT_MAX];
+  uint32_t queuedAt;  // For the fan-out latency
+  bool toOwner;
 };
 
 // Last queued message to prevent duplicates
@@ -69,6 +77,7 @@ void connectWiFi() {
     Serial.println();
     Serial.print("WiFi connected! IP: ");
     Serial.println(WiFi.localIP());
+    configTzTime(TIMEZONE, "pool.ntp.org");  // Wall clock for the session history, syncs in background
   } else {
     wifiConnected = false;
     Serial.println();
@@ -76,6 +85,24 @@ void connectWiFi() {
   }
 }
 
+// --- Helper: post a reply to one chat on the task's connection ---
+// The JSON body lives in a static buffer: only setup and the Telegram task
+// send replies, never at the same time, and the task stack is kept for TLS.
+static void replyTelegram(const char* chat, const char* html) {
+  static char body[TG_REPLY_MAX * 2 + 96];
+  int len = snprintf(body, sizeof(body), "{\"chat_id\":\"%s\",\"parse_mode\":\"HTML\",\"text\":\"", chat);
+  if (len < 0 || (size_t)len >= sizeof(body) - 3) return;
+  len += telegramJsonEscape(body + len, sizeof(body) - len - 2, html);
+  body[len++] = '"';
+  body[len++] = '}';
+  body[len] = '\0';
+
+  TelegramPostResult result;
+  if (!telegramPost(telegramClient, botToken, "sendMessage", body, TG_REPLY_TIMEOUT_MS, result)) {
+    LOG(LOG_TG_REPLY_FAILED, (uint32_t)result.status, result.description);
+  }
+}
+
 // Initialize Telegram bot
 void initTelegramBot() {
   // Check if bot token is configured
@@ -86,115 +113,176 @@ void initTelegramBot() {
     return;
   }
   
-  if (bot != nullptr) {
-    delete bot;
-  }
-  
   telegramClient.setInsecure();  // Skip certificate verification
   telegramClient.setTimeout(10000);  // 10 second timeout to prevent retries
-  bot = new UniversalTelegramBot(botToken, telegramClient);
-  bot->waitForResponse = 5000;  // 5 second wait for response
+  telegramReady = true;
   Serial.println("Telegram bot initialized");
   
   // Send startup message
-  bot->sendMessage(chatId, "🍅 Pomodoro Timer connected!", "HTML");
+  char text[64];
+  formatMessage(text, sizeof(text), MSG_CONNECTED);
+  replyTelegram(chatId, text);
 }
 
 // Queue message to Telegram (non-blocking)
-void sendTelegramMessage(const String& message) {
+void sendTelegramMessage(const char* message, bool toOwner) {
   if (!wifiConnected || !telegramConfigured || telegramMsgQueue == nullptr) {
     return;
   }
   
   TelegramMsg msg;
-  message.toCharArray(msg.text, sizeof(msg.text));
+  formatMessage(msg.text, sizeof(msg.text), "{0}", { msgMarkup(message) });  // Cut on a whole character
+  msg.queuedAt = millis();
+  msg.toOwner = toOwner;
   
   if (xQueueSend(telegramMsgQueue, &msg, 0) == pdTRUE) {
-    Serial.print("[TG] Queued: ");
-    Serial.println(message);
+    LOG(LOG_TG_QUEUED, msg.text);
+  }
+}
+
+// --- Helper: confirm what queued up while the device was off ---
+// Updates older than TG_STALE_COMMAND_S are skipped without running them;
+// the first fresh one stops the drain and is handled by the normal poll.
+// At most TG_DRAIN_MAX_REQUESTS calls, after which a negative offset makes
+// Telegram drop everything but the newest update.
+static void drainTelegramBacklog() {
+  unsigned long drainStart = millis();
+  uint32_t skipped = 0;
+  uint8_t requests = 0;
+  bool fresh = false;
+  while (!fresh) {
+    bool jumpToTail = requests == TG_DRAIN_MAX_REQUESTS;
+    uint32_t serverTime = 0;
+    int n = fetchTelegramUpdates(telegramClient, botToken, jumpToTail ? -1 : telegramLastUpdateId + 1,
+                                 telegramUpdates, TG_UPDATES_PER_POLL, TG_DRAIN_TIMEOUT_MS, &serverTime);
+    requests++;
+    if (n <= 0) break;
+    for (int i = 0; i < n; i++) {
+      const TelegramUpdate& u = telegramUpdates[i];
+      // No server date means no age: treat as fresh rather than drop a command
+      if (u.date != 0 && (serverTime == 0 || serverTime - u.date < TG_STALE_COMMAND_S)) {
+        fresh = true;
+        break;
+      }
+      telegramLastUpdateId = u.updateId;
+      skipped++;
+    }
+    if (jumpToTail || n < TG_UPDATES_PER_POLL) break;
   }
+  if (skipped > 0) saveSettings();
+  LOG(LOG_TG_DRAINED, skipped, requests, millis() - drainStart);
 }
 
 // Telegram task - sends queued messages in background
 void telegramTask(void* parameter) {
   Serial.println("[TG TASK] Started");
+  drainTelegramBacklog();
+  const int64_t ownerChat = strtoll(chatId, nullptr, 10);
   
   while (true) {
-    // Send queued messages
+    // Send queued messages, one at a time to every recipient
     TelegramMsg outMsg;
-    if (telegramMsgQueue != nullptr && xQueueReceive(telegramMsgQueue, &outMsg, 0) == pdTRUE) {
-      if (bot != nullptr) {
-        Serial.print("[TG TASK] Sending: ");
-        Serial.println(outMsg.text);
-        bot->sendMessage(chatId, outMsg.text, "HTML");
-        Serial.println("[TG TASK] Done");
-      }
+    if (!fanOutBusy() && telegramMsgQueue != nullptr && xQueueReceive(telegramMsgQueue, &outMsg, 0) == pdTRUE) {
+      LOG(LOG_TG_SENDING, outMsg.text);
+      startFanOut(outMsg.text, ownerChat, outMsg.toOwner, outMsg.queuedAt);
     }
+    serviceFanOut(telegramClient, botToken);
+    pushTelegramStatus(telegramClient, botToken, chatId);
     
     // Check for incoming commands (less frequently)
     static unsigned long lastCheck = 0;
-    if (millis() - lastCheck > BOT_CHECK_INTERVAL && bot != nullptr) {
+    if (millis() - lastCheck > BOT_CHECK_INTERVAL && telegramReady) {
       lastCheck = millis();
-      int numNewMessages = bot->getUpdates(bot->last_message_received + 1);
+      TelegramUpdate* updates = telegramUpdates;
+      int numNewMessages = fetchTelegramUpdates(telegramClient, botToken, telegramLastUpdateId + 1,
+                                                updates, TG_UPDATES_PER_POLL, TG_POLL_TIMEOUT_MS);
+      if (numNewMessages > 0) {
+        telegramLastUpdateId = updates[numNewMessages - 1].updateId;
+        saveSettings();  // Written once the burst settles
+      }
       
       for (int i = 0; i < numNewMessages; i++) {
-        String text = bot->messages[i].text;
-        String from_id = bot->messages[i].chat_id;
+        char* text = updates[i].text;
+        for (char* p = text; *p; p++) *p = tolower(*p);
+        // Other chats may only (un)subscribe
+        const char* from = updates[i].chatId;
+        bool owner = strcmp(from, chatId) == 0;
+        if (!owner && strcmp(text, "/subscribe") != 0 && strcmp(text, "/unsubscribe") != 0) continue;
         
-        if (from_id != String(chatId)) continue;
-        text.toLowerCase();
+        LOG(LOG_TG_COMMAND, text);
         
-        Serial.print("[TG] Command: ");
-        Serial.println(text);
-        
-        if (text == "/start" || text == "/help") {
-          String msg = "🍅 <b>Pomodoro Timer</b>\n\n";
-          msg += "/status - Current status\n";
-          msg += "/work - Start work\n";
-          msg += "/pause - Pause\n";
-          msg += "/resume - Resume\n";
-          msg += "/stop - Stop\n";
-          msg += "/mode - Change mode";
-          bot->sendMessage(chatId, msg, "HTML");
+        char reply[TG_REPLY_MAX];
+        reply[0] = '\0';
+        if (strcmp(text, "/start") == 0 || strcmp(text, "/help") == 0) {
+          formatMessage(reply, sizeof(reply), MSG_HELP);
         }
-        else if (text == "/work") {
+        else if (strcmp(text, "/work") == 0) {
           telegramCmdStart = true;
-          bot->sendMessage(chatId, "🍅 Starting...", "HTML");
+          formatMessage(reply, sizeof(reply), MSG_STARTING);
         }
-        else if (text == "/pause") {
+        else if (strcmp(text, "/pause") == 0) {
           telegramCmdPause = true;
-          bot->sendMessage(chatId, "⏸ Pausing...", "HTML");
+          formatMessage(reply, sizeof(reply), MSG_PAUSING);
         }
-        else if (text == "/resume") {
+        else if (strcmp(text, "/resume") == 0) {
           telegramCmdResume = true;
-          bot->sendMessage(chatId, "▶️ Resuming...", "HTML");
+          formatMessage(reply, sizeof(reply), MSG_RESUMING);
         }
-        else if (text == "/stop") {
+        else if (strcmp(text, "/stop") == 0) {
           telegramCmdStop = true;
-          bot->sendMessage(chatId, "⏹ Stopping...", "HTML");
+          formatMessage(reply, sizeof(reply), MSG_STOPPING);
         }
-        else if (text == "/mode") {
+        else if (strcmp(text, "/mode") == 0) {
           telegramCmdMode = true;
-          String modeStr;
-          switch (currentMode) {
-            case MODE_1_1: modeStr = "25/5"; break;
-            case MODE_25_5: modeStr = "50/10"; break;
-            case MODE_50_10: modeStr = "1/1"; break;
-          }
-          bot->sendMessage(chatId, "⏱ Mode: " + modeStr, "HTML");
+          static const char* const nextModeNames[] = { "25/5", "50/10", "1/1" };  // The mode it switches to
+          formatMessage(reply, sizeof(reply), MSG_MODE, { msgMarkup(nextModeNames[currentMode]) });
         }
-        else if (text == "/status") {
-          String msg = "🍅 ";
-          msg += (currentState == STOPPED) ? "Stopped" : 
-                 (currentState == RUNNING) ? (isWorkSession ? "Working" : "Resting") : "Paused";
-          msg += " | ";
-          switch (currentMode) {
-            case MODE_1_1: msg += "1/1"; break;
-            case MODE_25_5: msg += "25/5"; break;
-            case MODE_50_10: msg += "50/10"; break;
+        else if (strcmp(text, "/status") == 0) {
+          static const char* const modeNames[] = { "1/1", "25/5", "50/10" };
+          const char* state = (currentState == STOPPED) ? "Stopped" :
+                              (currentState == RUNNING) ? (isWorkSession ? "Working" : "Resting") : "Paused";
+          size_t len = formatMessage(reply, sizeof(reply), MSG_STATUS, { msgMarkup(state), msgMarkup(modeNames[currentMode]) });
+          if (batteryPercent() != BATTERY_UNKNOWN) {
+            appendMessage(reply, sizeof(reply), len, MSG_STATUS_BATTERY, { msgUint(batteryPercent()) });
           }
-          bot->sendMessage(chatId, msg, "HTML");
         }
+        else if (strcmp(text, "/stats") == 0) {
+          formatMessage(reply, sizeof(reply), MSG_STATS, { msgUint(focusSecondsToday() / 60), msgUint(workSessionsToday()),
+                                                            msgUint(focusSecondsThisWeek() / 60) });
+        }
+        else if (strcmp(text, "/live") == 0) {
+          telegramStatusReport(reply, sizeof(reply));
+        }
+        else if (strcmp(text, "/subscribers") == 0) {
+          fanOutReport(reply, sizeof(reply));
+        }
+        else if (strcmp(text, "/subscribe") == 0) {
+          MessageId answer = owner ? MSG_SUBSCRIBE_OWNER
+                           : addTelegramSubscriber(strtoll(from, nullptr, 10)) ? MSG_SUBSCRIBED : MSG_SUBSCRIBERS_FULL;
+          formatMessage(reply, sizeof(reply), answer);
+        }
+        else if (strcmp(text, "/unsubscribe") == 0) {
+          bool removed = removeTelegramSubscriber(strtoll(from, nullptr, 10));
+          formatMessage(reply, sizeof(reply), removed ? MSG_UNSUBSCRIBED : MSG_NOT_SUBSCRIBED);
+        }
+        else if (strcmp(text, "/export") == 0 || strcmp(text, "/export bin") == 0) {
+          telegramCmdExport = (text[7] == ' ') ? 2 : 1;
+          formatMessage(reply, sizeof(reply), MSG_EXPORTING);
+        }
+#if USE_MEM_TELEMETRY
+        else if (strcmp(text, "/perf") == 0) {
+          static char report[512];  // Task only; kept off the stack the TLS handshake also needs
+          memReport(report, sizeof(report));
+          formatMessage(reply, sizeof(reply), MSG_PRE, { msgText(report) });
+        }
+#endif
+#if USE_PROFILER
+        else if (strcmp(text, "/profile") == 0) {
+          // Profiling builds only; the report itself is still a String
+          formatMessage(reply, sizeof(reply), MSG_PRE, { msgText(profileReport().c_str()) });
+        }
+#endif
+        if (reply[0] != '\0') replyTelegram(from, reply);
       }
     }
     
@@ -202,49 +290,6 @@ void telegramTask(void* parameter) {
   }
 }
 
-// Process Telegram commands in main loop (thread-safe)
-void processTelegramCommands() {
-  if (telegramCmdStart) {
-    telegramCmdStart = false;
-    if (currentState == STOPPED) {
-      Serial.println("[TG CMD] Starting timer");
-      startTimer();
-    }
-  }
-  if (telegramCmdPause) {
-    telegramCmdPause = false;
-    if (currentState == RUNNING) {
-      Serial.println("[TG CMD] Pausing timer");
-      pauseTimer();
-    }
-  }
-  if (telegramCmdResume) {
-    telegramCmdResume = false;
-    if (currentState == PAUSED) {
-      Serial.println("[TG CMD] Resuming timer");
-      resumeTimer();
-    }
-  }
-  if (telegramCmdStop) {
-    telegramCmdStop = false;
-    if (currentState != STOPPED) {
-      Serial.println("[TG CMD] Stopping timer");
-      stopTimer();
-    }
-  }
-  if (telegramCmdMode) {
-    telegramCmdMode = false;
-    Serial.println("[TG CMD] Changing mode");
-    switch (currentMode) {
-      case MODE_1_1: currentMode = MODE_25_5; break;
-      case MODE_25_5: currentMode = MODE_50_10; break;
-      case MODE_50_10: currentMode = MODE_1_1; break;
-    }
-    displayInitialized = false;
-    forceCircleRedraw = true;
-  }
-}
-
 // Start Telegram task on separate core
 void startTelegramTask() {
   if (!wifiConnected || !telegramConfigured) return;
@@ -254,6 +299,7 @@ void startTelegramTask() {
   
   // Create message queue for outgoing messages
   telegramMsgQueue = xQueueCreate(MSG_QUEUE_SIZE, sizeof(TelegramMsg));
+  initTelegramStatus();
   
   // Create task with low priority (but not lowest)
   xTaskCreatePinnedToCore(
@@ -25,18 +25,16 @@
 const unsigned long BOT_CHECK_INTERVAL = 5000;  // Check every 5 seconds
 const unsigned long SEND_COOLDOWN = 3000;  // 3 second cooldown between sends
 
-// Thread-safe command queue from Telegram to main loop
-extern volatile bool telegramCmdStart;
-extern volatile bool telegramCmdPause;
-extern volatile bool telegramCmdResume;
-extern volatile bool telegramCmdStop;
-extern volatile bool telegramCmdMode;
+// Last Telegram update_id handled, persisted with the settings so a reboot
+// does not replay old commands
+extern volatile int32_t telegramLastUpdateId;
 
 // Functions
 void connectWiFi();
 void initTelegramBot();
-void sendTelegramMessage(const String& message);
-void processTelegramCommands();
+// Queue HTML text for the owner and subscribers, cut to TG_NOTIFY_TEXT_MAX.
+// Build it with message_format.h; toOwner = false: subscribers only.
+void sendTelegramMessage(const char* message, bool toOwner = true);
 void startTelegramTask();
 
 #endif // WIFI_TELEGRAM_H
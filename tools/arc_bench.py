@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""Integer ring and arc rasterizer against the float arc helper it replaced.
+
+Builds the GFX library on the host (see host_build.py) and draws into an
+Arduino_Canvas the size of the panel. For comparison, the driver keeps a
+copy of the float fillArc()/writeFillArcHelper() from before fillRing()
+and fillArcQ16() were added. It uses cos/sin and a float slope test per
+pixel. The cases are the progress ring's geometry (70/66 at the panel
+center):
+
+  ring    full turn: float fillArc(0, 360) against fillRing()
+  arc     every sweep from 1 to 359 degrees starting at the top, float
+          fillArc(270, 270 + sweep) against fillArcQ16()
+
+For each it prints the time per call, how many pixels differ from the
+float result (at most and in total) and the pixels written twice. The run
+fails if the integer side overdraws, or differs by more than MAX_DIFF
+pixels in one call.
+
+    python3 tools/arc_bench.py
+    python3 tools/arc_bench.py --runs 20000
+    python3 tools/arc_bench.py --cxx "riscv32-unknown-linux-gnu-g++ -march=rv32imac -mabi=ilp32 -static" \\
+        --runner qemu-riscv32
+
+On the host FPU the float side is cheap. On the ESP32-C6 every float
+operation is a soft-float call, so treat the host ratio as a lower bound,
+or build for rv32imac and run under qemu-user as in fixed_math_bench.py.
+"""
+
+import argparse
+import shlex
+import subprocess
+import sys
+
+import host_build
+
+MAX_DIFF = 16
+
+DRIVER = r"""
+#include <Arduino_GFX_Library.h>
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define W 172
+#define H 320
+#define CX (W / 2)
+#define CY (H / 2)
+#define R_OUT 70
+#define R_IN 66
+
+static double nowUs() {
+  using namespace std::chrono;
+  return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+class BenchCanvas : public Arduino_Canvas {
+ public:
+  BenchCanvas() : Arduino_Canvas(W, H, nullptr) {}
+
+  uint32_t written = 0;
+
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    written += w;
+    Arduino_Canvas::writeFastHLine(x, y, w, color);
+  }
+
+  // fillArc() as it was before the integer helper, unchanged
+  void floatFillArc(int16_t x, int16_t y, int16_t r1, int16_t r2, float start, float end, uint16_t color) {
+    if (r1 < r2) _swap_int16_t(r1, r2);
+    if (r1 < 1) r1 = 1;
+    if (r2 < 1) r2 = 1;
+    bool equal = fabsf(start - end) < FLT_EPSILON;
+    start = fmodf(start, 360);
+    end = fmodf(end, 360);
+    if (start < 0) start += 360.0;
+    if (end < 0) end += 360.0;
+    if (!equal && (fabsf(start - end) <= 0.0001)) {
+      start = .0;
+      end = 360.0;
+    }
+    startWrite();
+    floatFillArcHelper(x, y, r1, r2, start, end, color);
+    endWrite();
+  }
+
+  // writeFillArcHelper() as it was, unchanged
+  void floatFillArcHelper(int16_t cx, int16_t cy, int16_t oradius, int16_t iradius, float start, float end,
+                          uint16_t color) {
+    if ((start == 90.0) || (start == 180.0) || (start == 270.0) || (start == 360.0)) start -= 0.1;
+    if ((end == 90.0) || (end == 180.0) || (end == 270.0) || (end == 360.0)) end -= 0.1;
+
+    float s_cos = (cos(start * DEGTORAD));
+    float e_cos = (cos(end * DEGTORAD));
+    float sslope = s_cos / (sin(start * DEGTORAD));
+    float eslope = e_cos / (sin(end * DEGTORAD));
+    float swidth = 0.5 / s_cos;
+    float ewidth = -0.5 / e_cos;
+    --iradius;
+    int32_t ir2 = iradius * iradius + iradius;
+    int32_t or2 = oradius * oradius + oradius;
+
+    bool start180 = !(start < 180.0);
+    bool end180 = end < 180.0;
+    bool reversed = start + 180.0 < end || (end < start && start < end + 180.0);
+
+    int32_t xs = -oradius;
+    int32_t y = -oradius;
+    int32_t ye = oradius;
+    int32_t xe = oradius + 1;
+    if (!reversed) {
+      if ((end >= 270 || end < 90) && (start >= 270 || start < 90)) xs = 0;
+      else if (end < 270 && end >= 90 && start < 270 && start >= 90) xe = 1;
+      if (end >= 180 && start >= 180) ye = 0;
+      else if (end < 180 && start < 180) y = 0;
+    }
+    do {
+      int32_t y2 = y * y;
+      int32_t x = xs;
+      if (x < 0) {
+        while (x * x + y2 >= or2) ++x;
+        if (xe != 1) xe = 1 - x;
+      }
+      float ysslope = (y + swidth) * sslope;
+      float yeslope = (y + ewidth) * eslope;
+      int32_t len = 0;
+      do {
+        bool flg1 = start180 != (x <= ysslope);
+        bool flg2 = end180 != (x <= yeslope);
+        int32_t distance = x * x + y2;
+        if (distance >= ir2 && ((flg1 && flg2) || (reversed && (flg1 || flg2))) && x != xe && distance < or2) {
+          ++len;
+        } else {
+          if (len) {
+            writeFastHLine(cx + x - len, cy + y, len, color);
+            len = 0;
+          }
+          if (distance >= or2) break;
+          if (x < 0 && distance < ir2) x = -x;
+        }
+      } while (++x <= xe);
+    } while (++y <= ye);
+  }
+};
+
+static BenchCanvas canvas;
+static uint16_t floatPixels[W * H];
+
+// Pixels the two results disagree on
+static uint32_t diffPixels() {
+  uint32_t n = 0;
+  const uint16_t* fb = canvas.getFramebuffer();
+  for (int i = 0; i < W * H; i++) n += (fb[i] != floatPixels[i]);
+  return n;
+}
+
+static uint32_t setPixels() {
+  uint32_t n = 0;
+  const uint16_t* fb = canvas.getFramebuffer();
+  for (int i = 0; i < W * H; i++) n += (fb[i] != 0);
+  return n;
+}
+
+struct Result {
+  double floatUs, intUs;
+  uint32_t maxDiff, totalDiff, floatOverdraw, intOverdraw;
+};
+
+static void drawFloat(float start, float end) {
+  canvas.floatFillArc(CX, CY, R_OUT, R_IN, start, end, 0xFFFF);
+}
+
+static void drawInt(bool ring, float start, float end) {
+  if (ring) canvas.fillRing(CX, CY, R_OUT, R_IN, 0xFFFF);
+  else canvas.fillArcQ16(CX, CY, R_OUT, R_IN, GFX_DEG_TO_ANGLE_Q16(start), GFX_DEG_TO_ANGLE_Q16(end), 0xFFFF);
+}
+
+// One case: compare the pixels once, then time each side over runs calls
+static void measure(Result& r, bool ring, float start, float end, int runs) {
+  canvas.fillScreen(0);
+  canvas.written = 0;
+  drawFloat(start, end);
+  memcpy(floatPixels, canvas.getFramebuffer(), sizeof(floatPixels));
+  r.floatOverdraw += canvas.written - setPixels();
+
+  canvas.fillScreen(0);
+  canvas.written = 0;
+  drawInt(ring, start, end);
+  r.intOverdraw += canvas.written - setPixels();
+  uint32_t d = diffPixels();
+  r.totalDiff += d;
+  if (d > r.maxDiff) r.maxDiff = d;
+
+  double t0 = nowUs();
+  for (int i = 0; i < runs; i++) drawFloat(start, end);
+  r.floatUs += nowUs() - t0;
+  t0 = nowUs();
+  for (int i = 0; i < runs; i++) drawInt(ring, start, end);
+  r.intUs += nowUs() - t0;
+}
+
+static void report(const char* name, const Result& r, double calls) {
+  printf("%-5s float %8.2f us  integer %8.2f us  x%-5.1f differ max %u total %u  overdraw float %u integer %u\n",
+         name, r.floatUs / calls, r.intUs / calls, r.floatUs / r.intUs, (unsigned)r.maxDiff, (unsigned)r.totalDiff,
+         (unsigned)r.floatOverdraw, (unsigned)r.intOverdraw);
+}
+
+int main(int argc, char** argv) {
+  int runs = (argc > 1) ? atoi(argv[1]) : 2000;
+  canvas.begin(GFX_SKIP_OUTPUT_BEGIN);
+
+  Result ring = {};
+  measure(ring, true, 0, 360, runs);
+  report("ring", ring, runs);
+
+  Result arc = {};
+  int arcRuns = runs / 20 + 1;
+  for (int sweep = 1; sweep < 360; sweep++) measure(arc, false, 270, 270 + sweep, arcRuns);
+  report("arc", arc, 359.0 * arcRuns);
+  return 0;
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    host_build.add_arguments(parser)
+    parser.add_argument("--runs", type=int, default=2000, help="calls timed for the ring, /20 per arc sweep")
+    parser.add_argument("--runner", default="", help="prefix to run the binary with, e.g. qemu-riscv32")
+    args = parser.parse_args()
+
+    binary = host_build.build(args, "arc_bench", DRIVER, gfx=True)
+    out = subprocess.run(shlex.split(args.runner) + [binary, str(args.runs)], capture_output=True, text=True)
+    sys.stdout.write(out.stdout)
+    if out.returncode != 0:
+        sys.stderr.write(out.stderr)
+        sys.exit("arc_bench failed")
+
+    failures = []
+    for line in out.stdout.splitlines():
+        f = line.split()
+        max_diff, int_overdraw = int(f[10]), int(f[17])
+        if max_diff > MAX_DIFF:
+            failures.append("%s: %d pixels differ from the float helper" % (f[0], max_diff))
+        if int_overdraw:
+            failures.append("%s: integer helper wrote %d pixels twice" % (f[0], int_overdraw))
+    for f in failures:
+        print("FAIL " + f)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""What one timer tick sends to the panel, on the host.
+
+Builds the app's display code (display_updates.cpp, display_graphics.cpp,
+icons.cpp) with the indexed canvas and the GFX library against the host
+panel bus from tools/host, which keeps a copy of the ST7789 RAM and logs
+every address window sent. A running 25/5 work session is drawn once,
+then the fake clock is stepped one second at a time through the first
+minute. main.cpp's loop order is used: updateTimer(), updateDisplay(),
+flushDisplay(). For the ticks in EXPECTED it checks:
+
+  the panel RAM equals the canvas after the flush
+  the pixel bytes sent are exactly the windows' area, 2 bytes a pixel
+  the windows are the merged dirty rectangles listed in EXPECTED, at most
+  GFX_DIRTY_RECT_MAX of them and not overlapping (row hash off)
+  the tick sends under an eighth of a full frame (110080 bytes)
+  with the row hash on (the firmware's setting) it sends no more than that
+
+    python3 tools/canvas_tick_test.py
+    python3 tools/canvas_tick_test.py --sanitize
+    python3 tools/canvas_tick_test.py -v            # print every tick's windows
+
+Rectangles are raw canvas coordinates, inclusive: x1, y1, x2, y2. When a
+drawing change moves them on purpose, check the new list against a
+screenshot and update EXPECTED.
+"""
+
+import argparse
+import subprocess
+import sys
+
+import host_build
+
+DRIVER = r"""
+#include "pomodoro_globals.h"
+#include "display_graphics.h"
+#include "display_updates.h"
+#include "timer_logic.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "input_trace.h"
+#include "session_log.h"
+#include "telegram_status.h"
+#include "host_clock.h"
+#include <string.h>
+
+#define PANEL_W 172
+#define PANEL_H 320
+#define PANEL_COL_OFFSET 34  // col_offset1 in pomodoro_globals.cpp
+
+// Neighbours of the display code that the tick does not exercise
+uint8_t batteryPercent() { return 80; }
+void sendTelegramEvent(MessageId) {}
+void sessionEnded(bool, PomodoroMode, unsigned long, bool) {}
+void sessionStarted() {}
+void traceAction(TraceAction) {}
+void traceFrameDone(bool) {}
+
+static int panelMismatches() {
+  const Arduino_HWSPI* panel = (const Arduino_HWSPI*)bus;
+  const uint8_t* fb = canvas->getFramebuffer();
+  const uint16_t* palette = canvas->getColorIndex();
+  int bad = 0;
+  for (int y = 0; y < PANEL_H; y++) {
+    for (int x = 0; x < PANEL_W; x++) {
+      if (panel->pixel(x + PANEL_COL_OFFSET, y) != palette[fb[y * PANEL_W + x]]) bad++;
+    }
+  }
+  return bad;
+}
+
+static void loopPass() {
+  updateTimer();
+  updateDisplay();
+  flushDisplay();
+}
+
+static void report(const char* label) {
+  Arduino_HWSPI* panel = (Arduino_HWSPI*)bus;
+  const HostBusStats& st = panel->stats();
+  printf("tick %s windows %u pixel_bytes %llu mismatches %d rects", label, (unsigned)st.windows,
+         (unsigned long long)st.pixelBytes, panelMismatches());
+  for (const HostWindow& w : panel->sentWindows()) {
+    printf(" %u,%u,%u,%u", w.x1 - PANEL_COL_OFFSET, w.y1, w.x2 - PANEL_COL_OFFSET, w.y2);
+  }
+  printf("\n");
+  panel->resetStats();
+}
+
+int main(int argc, char** argv) {
+  bool rowHash = argc > 1 && strcmp(argv[1], "rowhash") == 0;
+  hostClockSet(10000000ULL);
+  gfx->begin();
+  initUIColorSlots(selectedWorkColor);
+  canvas->setRowHashDiff(rowHash);
+  gfx->setRotation(currentRotation);
+
+  currentMode = MODE_25_5;
+  currentState = RUNNING;
+  isWorkSession = true;
+  displayInitialized = false;
+  startTime = appMillis64();
+  uint64_t start = hostClockUs();
+  ((Arduino_HWSPI*)bus)->resetStats();  // Not the panel init
+  loopPass();
+  report("start");
+
+  for (int s = 1; s <= 60; s++) {
+    hostClockSet(start + s * 1000000ULL);
+    loopPass();
+    char label[8];
+    unsigned long left = 25 * 60 - s;
+    snprintf(label, sizeof(label), "%02lu:%02lu", left / 60, left % 60);
+    report(label);
+  }
+  return 0;
+}
+"""
+
+FULL_FRAME_BYTES = 172 * 320 * 2
+GFX_DIRTY_RECT_MAX = 8
+
+# Merged dirty rectangles per tick, row hash off: the ring's leading edge
+# at the top right, if it moved a pixel, and the time text box
+EXPECTED = {
+    "24:59": [(86, 90, 86, 94), (36, 130, 135, 189)],
+    "24:58": [(36, 130, 135, 189)],
+    "24:50": [(36, 130, 135, 189)],
+    "24:12": [(99, 91, 100, 95), (36, 130, 135, 189)],
+    "24:00": [(103, 93, 103, 93), (36, 130, 135, 189)],
+}
+
+
+def run(binary, mode):
+    out = subprocess.run([binary, mode], capture_output=True, text=True, check=True).stdout
+    ticks = {}
+    for line in out.splitlines():
+        f = line.split()
+        if not f or f[0] != "tick":
+            continue
+        ticks[f[1]] = {
+            "windows": int(f[3]),
+            "bytes": int(f[5]),
+            "mismatches": int(f[7]),
+            "rects": [tuple(int(v) for v in r.split(",")) for r in f[9:]],
+        }
+    return ticks
+
+
+def area(r):
+    return (r[2] - r[0] + 1) * (r[3] - r[1] + 1)
+
+
+def overlap(a, b):
+    return a[0] <= b[2] and b[0] <= a[2] and a[1] <= b[3] and b[1] <= a[3]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    host_build.add_arguments(parser)
+    parser.add_argument("-v", "--verbose", action="store_true", help="print every tick's windows")
+    args = parser.parse_args()
+
+    sources = ["src/pomodoro_globals.cpp", "src/display_graphics.cpp", "src/display_updates.cpp",
+               "src/icons.cpp", "src/color_utils.cpp", "src/timer_logic.cpp"]
+    binary = host_build.build(args, "canvas_tick_test", DRIVER, sources=sources, gfx=True)
+    plain = run(binary, "plain")
+    hashed = run(binary, "rowhash")
+
+    failures = []
+    for label, tick in plain.items():
+        for name, t in (("plain", tick), ("rowhash", hashed[label])):
+            if t["mismatches"]:
+                failures.append("%s %s: %d panel pixels differ from the canvas" % (label, name, t["mismatches"]))
+            if t["bytes"] != 2 * sum(area(r) for r in t["rects"]):
+                failures.append("%s %s: %d pixel bytes for windows of %d pixels"
+                                % (label, name, t["bytes"], sum(area(r) for r in t["rects"])))
+        if label == "start":
+            continue
+        rects = tick["rects"]
+        if len(rects) > GFX_DIRTY_RECT_MAX:
+            failures.append("%s: %d windows, more than GFX_DIRTY_RECT_MAX" % (label, len(rects)))
+        for i, a in enumerate(rects):
+            for b in rects[i + 1:]:
+                if overlap(a, b):
+                    failures.append("%s: windows %s and %s overlap" % (label, a, b))
+        if tick["bytes"] * 8 > FULL_FRAME_BYTES:
+            failures.append("%s: %d bytes, over an eighth of a full frame" % (label, tick["bytes"]))
+        if hashed[label]["bytes"] > tick["bytes"]:
+            failures.append("%s: row hash sent %d bytes, more than the %d without it"
+                            % (label, hashed[label]["bytes"], tick["bytes"]))
+        if label in EXPECTED and rects != EXPECTED[label]:
+            failures.append("%s: windows %s, expected %s" % (label, rects, EXPECTED[label]))
+
+    print("%-6s %8s %8s %12s" % ("tick", "windows", "bytes", "row hash"))
+    for label, tick in plain.items():
+        if args.verbose or label == "start" or label in EXPECTED:
+            print("%-6s %8d %8d %12d" % (label, tick["windows"], tick["bytes"], hashed[label]["bytes"]))
+            if args.verbose:
+                print("       " + " ".join("%d,%d,%d,%d" % r for r in tick["rects"]))
+    missing = [label for label in EXPECTED if label not in plain]
+    if missing:
+        failures.append("no tick drawn at " + ", ".join(missing))
+    for f in failures:
+        print("FAIL " + f)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
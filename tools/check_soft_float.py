@@ -0,0 +1,60 @@
+# Optional PlatformIO post-build check: flag soft-float calls in the render path.
+#
+# The ESP32-C6 has no FPU, every float/double operation becomes a libgcc
+# call (__mulsf3, __adddf3, ...) or a newlib libm call (cosf, sqrt, ...).
+# Enable in platformio.ini:
+#   extra_scripts = post:tools/check_soft_float.py
+# Set SOFT_FLOAT_STRICT=1 in the environment to fail the build instead of
+# only printing warnings.
+
+import os
+import re
+import subprocess
+
+Import("env")  # noqa: F821
+
+# Objects that make up the per-frame render path
+RENDER_OBJECTS = [
+    "src/display_graphics.cpp.o",
+    "src/display_updates.cpp.o",
+]
+
+SOFT_FLOAT_SYMBOL = re.compile(
+    r"^(__(add|sub|mul|div|neg|cmp|eq|ne|lt|le|gt|ge|unord)[sd]f[23]"
+    r"|__(fix|fixuns)[sd]f[sd]i|__float(un)?[sd]i[sd]f"
+    r"|__extendsfdf2|__truncdfsf2"
+    r"|(sin|cos|tan|atan2?|sqrt|pow|exp|log|fmod|floor|ceil|round)f?)$"
+)
+
+
+def _nm_tool():
+    cc = env.subst("$CC")  # noqa: F821
+    if cc.endswith("gcc"):
+        return cc[: -len("gcc")] + "nm"
+    return "nm"
+
+
+def check_soft_float(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    nm = _nm_tool()
+    findings = []
+    for rel in RENDER_OBJECTS:
+        obj = os.path.join(build_dir, rel)
+        if not os.path.isfile(obj):
+            continue
+        out = subprocess.run([nm, "-u", obj], capture_output=True, text=True).stdout
+        for line in out.splitlines():
+            sym = line.split()[-1] if line.split() else ""
+            if SOFT_FLOAT_SYMBOL.match(sym):
+                findings.append((rel, sym))
+
+    if not findings:
+        print("Soft-float check: render path is float free")
+        return
+    for rel, sym in findings:
+        print("Soft-float check: %s calls %s" % (rel, sym))
+    if os.environ.get("SOFT_FLOAT_STRICT") == "1":
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_soft_float)  # noqa: F821
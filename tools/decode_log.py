@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Decode the firmware's deferred log frames back into text.
+
+The drain task (src/deferred_log.cpp, LOG_BINARY_OUTPUT 1) writes frames
+
+    A5 5A <id> <len> <time ms, u32 LE> <payload, len bytes>
+
+interleaved with plain Serial text. Frames are expanded with the format
+strings from src/log_formats.h; everything else is passed through.
+
+    python3 tools/decode_log.py /dev/ttyACM0      # live, needs pyserial
+    python3 tools/decode_log.py capture.bin       # saved raw capture
+    cat capture.bin | python3 tools/decode_log.py
+"""
+
+import os
+import re
+import struct
+import sys
+
+FORMATS_PATH = os.path.join(os.path.dirname(__file__), "..", "src", "log_formats.h")
+SYNC = b"\xA5\x5A"
+HEADER_SIZE = 8
+ENTRY_RE = re.compile(r'X\(\s*(\w+),\s*(\w+),\s*LOG_TAG_(\w+),\s*"((?:[^"\\]|\\.)*)"\)')
+SPEC_RE = re.compile(r"%([udXs%])")
+
+
+def load_formats():
+    with open(FORMATS_PATH, encoding="utf-8") as f:
+        return [(tag, text) for _, _, tag, text in ENTRY_RE.findall(f.read())]
+
+
+def expand(text, payload):
+    pos = 0
+    out = []
+    last = 0
+    for m in SPEC_RE.finditer(text):
+        out.append(text[last:m.start()])
+        last = m.end()
+        spec = m.group(1)
+        if spec == "%":
+            out.append("%")
+        elif spec == "s":
+            end = payload.find(b"\0", pos)
+            end = len(payload) if end < 0 else end
+            out.append(payload[pos:end].decode("utf-8", "replace"))
+            pos = end + 1
+        else:
+            word = payload[pos:pos + 4].ljust(4, b"\0")
+            pos += 4
+            if spec == "d":
+                out.append(str(struct.unpack("<i", word)[0]))
+            elif spec == "X":
+                out.append("%X" % struct.unpack("<I", word)[0])
+            else:
+                out.append(str(struct.unpack("<I", word)[0]))
+    out.append(text[last:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, formats, write):
+        self.formats = formats
+        self.write = write
+        self.buf = b""
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            i = self.buf.find(SYNC)
+            if i < 0:
+                # Keep a trailing A5 in case the sync is split across reads
+                keep = 1 if self.buf.endswith(SYNC[:1]) else 0
+                self.passthrough(self.buf[:len(self.buf) - keep])
+                self.buf = self.buf[len(self.buf) - keep:]
+                return
+            self.passthrough(self.buf[:i])
+            self.buf = self.buf[i:]
+            if len(self.buf) < HEADER_SIZE:
+                return
+            fmt, length, ms = struct.unpack("<BBI", self.buf[2:HEADER_SIZE])
+            if len(self.buf) < HEADER_SIZE + length:
+                return
+            payload = self.buf[HEADER_SIZE:HEADER_SIZE + length]
+            self.buf = self.buf[HEADER_SIZE + length:]
+            if fmt < len(self.formats):
+                tag, text = self.formats[fmt]
+                line = expand(text, payload)
+            else:
+                tag, line = "?", "unknown log id %d (%s)" % (fmt, payload.hex())
+            self.write("[%9.3f] %-8s %s\n" % (ms / 1000.0, tag, line))
+
+    def passthrough(self, data):
+        if data:
+            self.write(data.decode("utf-8", "replace"))
+
+
+def main():
+    formats = load_formats()
+    out = sys.stdout
+    decoder = Decoder(formats, lambda s: (out.write(s), out.flush()))
+    src = sys.argv[1] if len(sys.argv) > 1 else None
+    if src and src.startswith("/dev/"):
+        import serial  # pyserial, only needed for live capture
+        port = serial.Serial(src, 115200, timeout=0.1)
+        while True:
+            decoder.feed(port.read(256))
+    stream = open(src, "rb") if src else sys.stdin.buffer
+    while True:
+        data = stream.read(4096)
+        if not data:
+            break
+        decoder.feed(data)
+
+
+if __name__ == "__main__":
+    main()
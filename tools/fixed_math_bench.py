@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Speed and accuracy of fixed_math against the libm float functions.
+
+Builds a small program from fixed_math.cpp (shipped in
+lib/GFX_Library_for_Arduino/src) and times each fixed-point function next
+to the float function it replaced:
+
+  fx_sin_q15 / fx_cos_q15   sinf / cosf      error in Q15 units, all 65536 angles
+  fx_atan2                  atan2f           error in Q16 angle units, over a grid of vectors
+  fx_isqrt                  sqrtf            exact floor(sqrt) expected, error in units
+
+It also runs fx_atan2 on the INT32_MIN/INT32_MAX corners and checks the
+quadrant of each result.
+
+    python3 tools/fixed_math_bench.py
+    python3 tools/fixed_math_bench.py --cxx "riscv32-unknown-linux-gnu-g++ -march=rv32imac -mabi=ilp32 -static" \\
+        --runner qemu-riscv32
+
+With the host compiler, the float side runs on the host's FPU. That
+understates the gain on the ESP32-C6, where every float operation is a
+newlib/libgcc soft-float call. For target-like numbers, build for an
+FPU-less RV32 (rv32imac, ilp32) and run it under qemu-user with --runner.
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+HARNESS = r"""
+#include "fixed_math.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static volatile int32_t sinkI;
+static volatile float sinkF;
+
+static double nowUs() {
+  using namespace std::chrono;
+  return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Inputs kept in arrays so neither side is folded at compile time
+static int32_t angles[4096];
+static float radians[4096];
+static int32_t vy[4096], vx[4096];
+static float fy[4096], fx[4096];
+static uint32_t squares[4096];
+static float fsquares[4096];
+
+static uint32_t rng = 12345;
+static uint32_t nextRandom() {
+  rng = rng * 1664525u + 1013904223u;
+  return rng;
+}
+
+static void report(const char* fixedName, double fixedUs, const char* floatName, double floatUs, int runs) {
+  double n = 4096.0 * runs;
+  printf("%-12s %8.1f ns   %-8s %8.1f ns   x%.1f\n", fixedName, fixedUs * 1000 / n, floatName,
+         floatUs * 1000 / n, floatUs / fixedUs);
+}
+
+int main(int argc, char** argv) {
+  int runs = (argc > 1) ? atoi(argv[1]) : 200;
+  const double turn = 6.283185307179586;
+
+  for (int i = 0; i < 4096; i++) {
+    angles[i] = nextRandom() & 0xFFFF;
+    radians[i] = (float)(angles[i] * turn / 65536);
+    vy[i] = (int32_t)(nextRandom() % 20001) - 10000;
+    vx[i] = (int32_t)(nextRandom() % 20001) - 10000;
+    fy[i] = (float)vy[i];
+    fx[i] = (float)vx[i];
+    squares[i] = nextRandom() % (320u * 320u * 2);
+    fsquares[i] = (float)squares[i];
+  }
+
+  // --- Accuracy ---
+  double sinErr = 0, cosErr = 0;
+  for (int32_t a = 0; a < 65536; a++) {
+    double r = a * turn / 65536;
+    double s = fabs(fx_sin_q15(a) - sin(r) * FX_Q15_ONE);
+    double c = fabs(fx_cos_q15(a) - cos(r) * FX_Q15_ONE);
+    if (s > sinErr) sinErr = s;
+    if (c > cosErr) cosErr = c;
+  }
+
+  double atanErr = 0;
+  for (int32_t y = -400; y <= 400; y += 3) {
+    for (int32_t x = -400; x <= 400; x += 3) {
+      if (x == 0 && y == 0) continue;
+      double want = atan2((double)y, (double)x) * 65536 / turn;
+      if (want < 0) want += 65536;
+      double d = fabs(fx_atan2(y, x) - want);
+      if (d > 32768) d = 65536 - d;  // Across the wrap at 0
+      if (d > atanErr) atanErr = d;
+    }
+  }
+
+  uint32_t sqrtErr = 0;
+  for (uint32_t v = 0; v < 1u << 20; v++) {
+    uint32_t want = (uint32_t)sqrt((double)v);
+    uint32_t got = fx_isqrt(v);
+    uint32_t d = (got > want) ? got - want : want - got;
+    if (d > sqrtErr) sqrtErr = d;
+  }
+  for (uint32_t v = 0xFFFF0000u; v != 0; v++) {  // Top of the range
+    uint32_t want = (uint32_t)sqrt((double)v);
+    uint32_t got = fx_isqrt(v);
+    uint32_t d = (got > want) ? got - want : want - got;
+    if (d > sqrtErr) sqrtErr = d;
+  }
+
+  printf("max error: sin %.1f Q15, cos %.1f Q15, atan2 %.1f/65536 turn, isqrt %u\n", sinErr, cosErr, atanErr,
+         sqrtErr);
+
+  // --- Extremes: the result must land in the vector's quadrant ---
+  static const int32_t corners[][2] = {
+    { 1, INT32_MIN }, { -1, INT32_MIN }, { INT32_MIN, INT32_MIN }, { INT32_MAX, INT32_MIN },
+    { INT32_MIN, 1 }, { INT32_MAX, INT32_MAX }, { INT32_MIN, INT32_MAX }, { 0, INT32_MIN },
+  };
+  int wrong = 0;
+  for (const auto& c : corners) {
+    double want = atan2((double)c[0], (double)c[1]) * 65536 / turn;
+    if (want < 0) want += 65536;
+    double d = fabs(fx_atan2(c[0], c[1]) - want);
+    if (d > 32768) d = 65536 - d;
+    if (d > 64) {
+      printf("fx_atan2(%ld, %ld) = %ld, expected ~%.0f\n", (long)c[0], (long)c[1], (long)fx_atan2(c[0], c[1]), want);
+      wrong++;
+    }
+  }
+  printf("atan2 extremes: %d of %d off\n", wrong, (int)(sizeof(corners) / sizeof(corners[0])));
+
+  // --- Speed ---
+  double t0, fixedUs, floatUs;
+
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkI = fx_sin_q15(angles[i]);
+  fixedUs = nowUs() - t0;
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkF = sinf(radians[i]);
+  floatUs = nowUs() - t0;
+  report("fx_sin_q15", fixedUs, "sinf", floatUs, runs);
+
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkI = fx_cos_q15(angles[i]);
+  fixedUs = nowUs() - t0;
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkF = cosf(radians[i]);
+  floatUs = nowUs() - t0;
+  report("fx_cos_q15", fixedUs, "cosf", floatUs, runs);
+
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkI = fx_atan2(vy[i], vx[i]);
+  fixedUs = nowUs() - t0;
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkF = atan2f(fy[i], fx[i]);
+  floatUs = nowUs() - t0;
+  report("fx_atan2", fixedUs, "atan2f", floatUs, runs);
+
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkI = fx_isqrt(squares[i]);
+  fixedUs = nowUs() - t0;
+  t0 = nowUs();
+  for (int r = 0; r < runs; r++) for (int i = 0; i < 4096; i++) sinkF = sqrtf(fsquares[i]);
+  floatUs = nowUs() - t0;
+  report("fx_isqrt", fixedUs, "sqrtf", floatUs, runs);
+
+  return wrong ? 1 : 0;
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--runs", type=int, default=200, help="passes over the 4096 inputs per function")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="compiler command, may include flags")
+    parser.add_argument("--runner", default="", help="prefix to run the binary with, e.g. qemu-riscv32")
+    parser.add_argument("--keep", metavar="DIR", help="write the harness to DIR and keep it")
+    args = parser.parse_args()
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="fixed_math_bench_")
+    os.makedirs(workdir, exist_ok=True)
+    source = os.path.join(workdir, "fixed_math_bench.cpp")
+    binary = os.path.join(workdir, "fixed_math_bench")
+    with open(source, "w") as f:
+        f.write(HARNESS)
+
+    lib = os.path.join(REPO, "lib", "GFX_Library_for_Arduino", "src")
+    # -O2 like the firmware; -fno-builtin keeps the float calls from being folded or inlined away
+    cmd = shlex.split(args.cxx) + ["-std=c++17", "-O2", "-fno-builtin", "-I" + lib, source,
+                                   os.path.join(lib, "fixed_math.cpp"), "-lm", "-o", binary]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    if build.returncode != 0:
+        sys.stderr.write(build.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+    run = subprocess.run(shlex.split(args.runner) + [binary, str(args.runs)])
+    sys.exit(run.returncode)
+
+
+if __name__ == "__main__":
+    main()
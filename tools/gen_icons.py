@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Rasterize the UI icon set into 2-bpp alpha masks.
+
+Writes src/icons_data.h. Each icon is sampled on a 4x4 grid per pixel and
+the coverage is quantized to 4 levels (0 = background, 3 = solid), so the
+firmware only has to colorize and blit. Re-run after changing a shape or
+adding a size:
+
+    python3 tools/gen_icons.py
+"""
+
+import math
+import os
+
+SUPERSAMPLE = 4
+OUT_PATH = os.path.join(os.path.dirname(__file__), "..", "src", "icons_data.h")
+
+# (enum name, shape function, sizes in pixels)
+ICONS = [
+    ("ICON_GEAR", "gear", [36]),
+    ("ICON_PLAY", "play", [24]),
+    ("ICON_PAUSE", "pause", [24]),
+    ("ICON_CHECK", "check", [24, 32]),
+    ("ICON_CROSS", "cross", [24, 32]),
+]
+
+
+def seg_dist(px, py, ax, ay, bx, by):
+    dx, dy = bx - ax, by - ay
+    t = ((px - ax) * dx + (py - ay) * dy) / (dx * dx + dy * dy)
+    t = max(0.0, min(1.0, t))
+    return math.hypot(px - (ax + t * dx), py - (ay + t * dy))
+
+
+def gear(x, y, s):
+    # 8-tooth cog with a center hole, teeth reach the mask edge
+    c = s / 2.0
+    dx, dy = x - c, y - c
+    r = math.hypot(dx, dy)
+    tip = s / 2.0 - 0.5
+    body = tip * 0.72
+    hole = tip * 0.34
+    if r < hole or r > tip:
+        return False
+    if r <= body:
+        return True
+    half_w = s / 12.0
+    for i in range(8):
+        a = i * math.pi / 4
+        # Distance from the tooth axis, measured perpendicular to it
+        along = dx * math.cos(a) + dy * math.sin(a)
+        across = -dx * math.sin(a) + dy * math.cos(a)
+        if along > 0 and abs(across) <= half_w:
+            return True
+    return False
+
+
+def play(x, y, s):
+    # Right-pointing triangle, 3/4 as wide as tall
+    c = s / 2.0
+    w = s * 3 / 4.0
+    left, right = c - w / 2, c + w / 2
+    if x < left or x > right:
+        return False
+    t = (x - left) / w
+    return abs(y - c) <= (s / 2.0) * (1.0 - t)
+
+
+def pause(x, y, s):
+    # Two bars, each a quarter of the size wide, a quarter apart from center
+    c = s / 2.0
+    bar, gap = s / 4.0, s / 4.0
+    in_left = c - gap - bar <= x <= c - gap
+    in_right = c + gap <= x <= c + gap + bar
+    return (in_left or in_right) and 0 <= y <= s
+
+
+def check(x, y, s):
+    half = s * 0.075
+    pts = [(0.14, 0.54), (0.40, 0.80), (0.88, 0.22)]
+    for (ax, ay), (bx, by) in zip(pts, pts[1:]):
+        if seg_dist(x, y, ax * s, ay * s, bx * s, by * s) <= half:
+            return True
+    return False
+
+
+def cross(x, y, s):
+    half = s * 0.075
+    a, b = 0.2 * s, 0.8 * s
+    return (seg_dist(x, y, a, a, b, b) <= half or
+            seg_dist(x, y, b, a, a, b) <= half)
+
+
+SHAPES = {"gear": gear, "play": play, "pause": pause, "check": check, "cross": cross}
+
+
+def rasterize(shape, s):
+    fn = SHAPES[shape]
+    levels = SUPERSAMPLE * SUPERSAMPLE
+    rows = []
+    for py in range(s):
+        row = []
+        for px in range(s):
+            hits = 0
+            for sy in range(SUPERSAMPLE):
+                for sx in range(SUPERSAMPLE):
+                    if fn(px + (sx + 0.5) / SUPERSAMPLE, py + (sy + 0.5) / SUPERSAMPLE, s):
+                        hits += 1
+            row.append((hits * 3 + levels // 2) // levels)
+        rows.append(row)
+    return rows
+
+
+def pack(rows):
+    out = []
+    for row in rows:
+        for i in range(0, len(row), 4):
+            b = 0
+            for j in range(4):
+                a = row[i + j] if i + j < len(row) else 0
+                b |= a << (6 - 2 * j)
+            out.append(b)
+    return out
+
+
+def main():
+    lines = [
+        "// Generated by tools/gen_icons.py - do not edit by hand",
+        "",
+        "#ifndef ICONS_DATA_H",
+        "#define ICONS_DATA_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+    table = []
+    max_dim = 0
+    for enum_name, shape, sizes in ICONS:
+        for s in sizes:
+            max_dim = max(max_dim, s)
+            name = "icon_%s_%d" % (shape, s)
+            data = pack(rasterize(shape, s))
+            lines.append("// %s %dx%d, 2 bpp, rows padded to whole bytes" % (shape, s, s))
+            lines.append("static const uint8_t %s[%d] PROGMEM = {" % (name, len(data)))
+            for i in range(0, len(data), 16):
+                lines.append("  " + ", ".join("0x%02X" % v for v in data[i:i + 16]) + ",")
+            lines.append("};")
+            lines.append("")
+            table.append((enum_name, s, name))
+
+    lines.append("#define ICON_MAX_DIM %d" % max_dim)
+    lines.append("")
+    lines.append("static const IconMask iconMasks[] PROGMEM = {")
+    for enum_name, s, name in table:
+        lines.append("  { %s, %d, %d, %s }," % (enum_name, s, s, name))
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif // ICONS_DATA_H")
+    lines.append("")
+
+    with open(OUT_PATH, "w") as f:
+        f.write("\n".join(lines))
+    print("Wrote %s (%d masks)" % (os.path.normpath(OUT_PATH), len(table)))
+
+
+if __name__ == "__main__":
+    main()
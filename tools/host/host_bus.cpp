@@ -0,0 +1,87 @@
+// Host panel bus implementation
+
+#include "host_bus.h"
+
+SPIClass SPI;
+
+Arduino_HWSPI::Arduino_HWSPI(int8_t, int8_t, int8_t, int8_t, int8_t, SPIClass*, bool) {}
+
+bool Arduino_HWSPI::begin(int32_t speed, int8_t dataMode) {
+  _speed = (speed == GFX_NOT_DEFINED) ? SPI_DEFAULT_FREQ : speed;
+  _dataMode = dataMode;
+  return true;
+}
+
+void Arduino_HWSPI::writeCommand(uint8_t c) {
+  busStats.commands++;
+  command = c;
+  paramCount = 0;
+  pixelHalf = false;
+  if (c == 0x2C) {  // RAMWR
+    busStats.windows++;
+    windowLog.push_back({x1, y1, x2, y2});
+    cx = x1;
+    cy = y1;
+  }
+}
+
+void Arduino_HWSPI::writeCommand16(uint16_t c) {
+  writeCommand(c >> 8);
+  writeCommand(c & 0xFF);
+}
+
+void Arduino_HWSPI::writeCommandBytes(uint8_t* data, uint32_t len) {
+  while (len--) writeCommand(*data++);
+}
+
+void Arduino_HWSPI::data(uint8_t d) {
+  busStats.dataBytes++;
+  if (command == 0x2A || command == 0x2B) {  // CASET, RASET: start and end, big-endian
+    if (paramCount < 4) params[paramCount++] = d;
+    if (paramCount == 4) {
+      uint16_t start = (params[0] << 8) | params[1];
+      uint16_t end = (params[2] << 8) | params[3];
+      if (command == 0x2A) {
+        x1 = start;
+        x2 = end;
+      } else {
+        y1 = start;
+        y2 = end;
+      }
+    }
+  } else if (command == 0x2C) {
+    busStats.pixelBytes++;
+    if (!pixelHalf) {
+      pixelMsb = d;
+      pixelHalf = true;
+      return;
+    }
+    pixelHalf = false;
+    if (cy <= y2 && cx < HOST_PANEL_RAM_W && cy < HOST_PANEL_RAM_H) ram[cy][cx] = (pixelMsb << 8) | d;
+    if (++cx > x2) {
+      cx = x1;
+      cy++;
+    }
+  }
+}
+
+void Arduino_HWSPI::write(uint8_t d) {
+  data(d);
+}
+
+void Arduino_HWSPI::write16(uint16_t d) {
+  data(d >> 8);
+  data(d & 0xFF);
+}
+
+void Arduino_HWSPI::writeRepeat(uint16_t p, uint32_t len) {
+  while (len--) write16(p);
+}
+
+void Arduino_HWSPI::writeBytes(uint8_t* data, uint32_t len) {
+  while (len--) write(*data++);
+}
+
+void Arduino_HWSPI::writePixels(uint16_t* data, uint32_t len) {
+  while (len--) write16(*data++);
+}
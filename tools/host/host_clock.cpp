@@ -0,0 +1,72 @@
+// Host clock and Serial behind the Arduino stand-ins
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <time.h>
+#include "host_clock.h"
+
+HardwareSerial Serial;
+
+static bool virtualClock = false;
+static uint64_t virtualUs = 0;
+
+static uint64_t realUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+uint64_t hostClockUs() {
+  return virtualClock ? virtualUs : realUs();
+}
+
+void hostClockSet(uint64_t us) {
+  virtualClock = true;
+  virtualUs = us;
+}
+
+void hostClockAdvance(uint64_t us) {
+  if (!virtualClock) hostClockSet(realUs());
+  virtualUs += us;
+}
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(hostClockUs() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)hostClockUs();
+}
+
+void delay(unsigned long ms) {
+  delayMicroseconds(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (virtualClock) {
+    virtualUs += us;
+    return;
+  }
+  timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000L };
+  nanosleep(&ts, nullptr);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  static const bool enabled = getenv("HOST_SERIAL") != nullptr;
+  if (enabled) fwrite(buf, 1, n, stderr);
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char text[256];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (n < 0) return 0;
+  return write((const uint8_t*)text, (size_t)n < sizeof(text) ? n : sizeof(text) - 1);
+}
@@ -0,0 +1,54 @@
+// Host pins, I2C and IMU behind the Arduino stand-ins
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <FastIMU.h>
+#include <map>
+#include <vector>
+#include "host_io.h"
+
+TwoWire Wire;
+
+static std::map<uint8_t, int> pinLevels;
+static std::map<uint8_t, std::vector<uint8_t>> i2cReplies;
+static AccelData imuAccel = { 0.0f, 0.0f, 1.0f };
+
+void hostPinSet(uint8_t pin, int level) {
+  pinLevels[pin] = level;
+}
+
+int digitalRead(uint8_t pin) {
+  auto it = pinLevels.find(pin);
+  return (it == pinLevels.end()) ? HIGH : it->second;
+}
+
+void hostI2cReply(uint8_t addr, const uint8_t* data, size_t len) {
+  i2cReplies[addr].assign(data, data + len);
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  return i2cReplies.count(_addr) ? 0 : 2;  // 2 = NACK on address
+}
+
+uint8_t TwoWire::requestFrom(int addr, int len) {
+  auto it = i2cReplies.find((uint8_t)addr);
+  _addr = (uint8_t)addr;
+  _pos = 0;
+  _len = (it == i2cReplies.end()) ? 0 : min((size_t)len, it->second.size());
+  return (uint8_t)_len;
+}
+
+size_t TwoWire::readBytes(uint8_t* buf, size_t len) {
+  size_t n = min(len, _len - _pos);
+  if (n > 0) memcpy(buf, i2cReplies[_addr].data() + _pos, n);
+  _pos += n;
+  return n;
+}
+
+void hostImuSet(float ax, float ay, float az) {
+  imuAccel = { ax, ay, az };
+}
+
+void QMI8658::getAccel(AccelData* out) {
+  *out = imuAccel;
+}
@@ -0,0 +1,63 @@
+// Host stand-in for the parts of the Arduino core the firmware modules use,
+// so they build and run in tools/ drivers (see tools/host_build.py). Time
+// comes from host_clock.cpp: real time, or a stepped virtual clock.
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "WString.h"
+#include "Print.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define PI 3.1415926535897932384626433832795
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define IRAM_ATTR
+#define F(s) (s)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+static inline void pinMode(uint8_t, uint8_t) {}
+static inline void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin);  // host_io.cpp: HIGH unless a driver set the pin
+static inline uint32_t getCpuFrequencyMhz() { return 160; }
+
+template <class T, class U>
+static inline auto min(T a, U b) { return (a < b) ? a : b; }  // By value: decltype(a < b ? a : b) is T& for T == U
+template <class T, class U>
+static inline auto max(T a, U b) { return (a > b) ? a : b; }
+
+// Serial output is dropped unless HOST_SERIAL is set in the environment
+class HardwareSerial : public Print {
+ public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  int available() { return 0; }
+  int read() { return -1; }
+  void flush() {}
+  operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,14 @@
+// Host build of the GFX library: the core, the canvases and the ST7789
+// driver from lib/GFX_Library_for_Arduino, on the host panel bus
+
+#ifndef _ARDUINO_GFX_LIBRARIES_H_
+#define _ARDUINO_GFX_LIBRARIES_H_
+
+#include "Arduino_DataBus.h"
+#include "host_bus.h"
+#include "Arduino_GFX.h"
+#include "canvas/Arduino_Canvas.h"
+#include "canvas/Arduino_Canvas_Indexed.h"
+#include "display/Arduino_ST7789.h"
+
+#endif // _ARDUINO_GFX_LIBRARIES_H_
@@ -0,0 +1,19 @@
+// Host stand-in for Arduino's Client.h
+
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include <Arduino.h>
+
+class Client : public Print {
+ public:
+  virtual int connect(const char* host, uint16_t port) = 0;
+  size_t write(uint8_t c) override = 0;
+  size_t write(const uint8_t* buf, size_t size) override = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+};
+
+#endif // HOST_CLIENT_H
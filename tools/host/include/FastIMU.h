@@ -0,0 +1,30 @@
+// Host stand-in for the FastIMU library: a QMI8658 that reads back the
+// acceleration a driver set with hostImuSet() (host_io.h)
+
+#ifndef HOST_FASTIMU_H
+#define HOST_FASTIMU_H
+
+#include <Arduino.h>
+
+struct calData {
+  bool valid;
+  float accelBias[3];
+  float gyroBias[3];
+  float magBias[3];
+  float magScale[3];
+};
+
+struct AccelData {
+  float accelX;
+  float accelY;
+  float accelZ;
+};
+
+class QMI8658 {
+ public:
+  int init(calData, uint8_t = 0) { return 0; }
+  void update() {}
+  void getAccel(AccelData* out);
+};
+
+#endif // HOST_FASTIMU_H
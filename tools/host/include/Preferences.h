@@ -0,0 +1,42 @@
+// Host stand-in for the ESP32 Preferences (NVS) library, kept in memory
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+ public:
+  bool begin(const char*, bool = false) { return true; }
+  void end() {}
+  bool isKey(const char* key) { return values.count(key) != 0; }
+  bool remove(const char* key) { return values.erase(key) != 0; }
+  bool clear() {
+    values.clear();
+    return true;
+  }
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    values[key].assign((const uint8_t*)value, (const uint8_t*)value + len);
+    return len;
+  }
+  size_t getBytes(const char* key, void* buf, size_t maxLen) {
+    auto it = values.find(key);
+    if (it == values.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+  size_t putUShort(const char* key, uint16_t value) { return putBytes(key, &value, sizeof(value)); }
+  uint16_t getUShort(const char* key, uint16_t defaultValue = 0) {
+    uint16_t value = defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+  }
+
+ private:
+  std::map<std::string, std::vector<uint8_t>> values;
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,45 @@
+// Host stand-in for Arduino's Print: text goes through write(), which is
+// what Arduino_GFX overrides to draw characters
+
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t done = 0;
+    while (n--) done += write(*buf++);
+    return done;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printNumber("%d", v); }
+  size_t print(unsigned v) { return printNumber("%u", v); }
+  size_t print(long v) { return printNumber("%ld", v); }
+  size_t print(unsigned long v) { return printNumber("%lu", v); }
+  size_t println(const char* s = "") { return print(s) + write("\r\n"); }
+  template <class T>
+  size_t println(T v) { return print(v) + write("\r\n"); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+ private:
+  template <class T>
+  size_t printNumber(const char* format, T v) {
+    char text[24];
+    snprintf(text, sizeof(text), format, v);
+    return write(text);
+  }
+};
+
+#endif // HOST_PRINT_H
@@ -0,0 +1,16 @@
+// Host stand-in for Arduino's SPI.h; the panel bus is host_bus.h
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+class SPIClass {};
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
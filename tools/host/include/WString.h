@@ -0,0 +1,20 @@
+// Host stand-in for Arduino's String, as much as the GFX library needs
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+ public:
+  String(const char* s = "") : text(s) {}
+  unsigned int length() const { return text.size(); }
+  const char* c_str() const { return text.c_str(); }
+
+ private:
+  std::string text;
+};
+
+#endif // HOST_WSTRING_H
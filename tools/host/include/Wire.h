@@ -0,0 +1,26 @@
+// Host stand-in for Arduino's Wire.h. Devices answer with what a driver set
+// through hostI2cReply() (host_io.h); writes are dropped.
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+ public:
+  bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t addr) { _addr = addr; }
+  size_t write(uint8_t) { return 1; }
+  uint8_t endTransmission(bool = true);   // 0 (ACK) if the device has a reply set
+  uint8_t requestFrom(int addr, int len);
+  size_t readBytes(uint8_t* buf, size_t len);
+
+ private:
+  uint8_t _addr = 0;
+  size_t _pos = 0;
+  size_t _len = 0;
+};
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
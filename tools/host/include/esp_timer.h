@@ -0,0 +1,12 @@
+// Host stand-in for esp_timer.h: microseconds on the host clock
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include "host_clock.h"
+
+static inline int64_t esp_timer_get_time() {
+  return (int64_t)hostClockUs();
+}
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,71 @@
+// Host panel bus: stands in for Arduino_HWSPI and keeps what an ST7789
+// would. Commands and data are counted the way they go over SPI, and the
+// column/row windows and RAMWR pixels are applied to a copy of the panel
+// RAM, so a driver can check what is on the glass after a flush.
+
+#ifndef HOST_BUS_H
+#define HOST_BUS_H
+
+#include <SPI.h>
+#include <vector>
+#include "Arduino_DataBus.h"
+
+#define HOST_PANEL_RAM_W 240  // ST7789 RAM, the 172 px wide panel sits at column 34
+#define HOST_PANEL_RAM_H 320
+
+struct HostBusStats {
+  uint32_t commands;     // Command bytes (D/C low)
+  uint32_t windows;      // RAMWR commands, one per address window sent
+  uint64_t dataBytes;    // Parameter and pixel bytes (D/C high)
+  uint64_t pixelBytes;   // Of which pixel data after RAMWR
+};
+
+// An address window as sent, panel RAM coordinates, inclusive
+struct HostWindow {
+  uint16_t x1, y1, x2, y2;
+};
+
+class Arduino_HWSPI : public Arduino_DataBus {
+ public:
+  Arduino_HWSPI(int8_t dc, int8_t cs = GFX_NOT_DEFINED, int8_t sck = GFX_NOT_DEFINED,
+                int8_t mosi = GFX_NOT_DEFINED, int8_t miso = GFX_NOT_DEFINED, SPIClass* spi = &SPI,
+                bool is_shared_interface = true);
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) override;
+  void beginWrite() override {}
+  void endWrite() override {}
+  void writeCommand(uint8_t c) override;
+  void writeCommand16(uint16_t c) override;
+  void writeCommandBytes(uint8_t* data, uint32_t len) override;
+  void write(uint8_t d) override;
+  void write16(uint16_t d) override;
+  void writeRepeat(uint16_t p, uint32_t len) override;
+  void writeBytes(uint8_t* data, uint32_t len) override;
+  void writePixels(uint16_t* data, uint32_t len) override;
+
+  const HostBusStats& stats() const { return busStats; }
+  // Windows written with RAMWR since resetStats(), in order
+  const std::vector<HostWindow>& sentWindows() const { return windowLog; }
+  void resetStats() {
+    memset(&busStats, 0, sizeof(busStats));
+    windowLog.clear();
+  }
+  // Panel RAM pixel, RGB565
+  uint16_t pixel(int16_t x, int16_t y) const { return ram[y][x]; }
+
+ private:
+  void data(uint8_t d);
+
+  HostBusStats busStats = {};
+  std::vector<HostWindow> windowLog;
+  uint8_t command = 0;
+  uint8_t params[4] = {};
+  uint8_t paramCount = 0;
+  uint16_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;  // Window
+  uint16_t cx = 0, cy = 0;                  // RAMWR cursor
+  uint8_t pixelMsb = 0;
+  bool pixelHalf = false;
+  uint16_t ram[HOST_PANEL_RAM_H][HOST_PANEL_RAM_W] = {};
+};
+
+#endif // HOST_BUS_H
@@ -0,0 +1,14 @@
+// Host clock behind millis(), micros(), delay() and esp_timer_get_time().
+// Real monotonic time until a driver sets it; from then on it is virtual,
+// only moves with hostClockAdvance() or delay(), and runs are reproducible.
+
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+uint64_t hostClockUs();
+void hostClockSet(uint64_t us);       // Switch to the virtual clock at this time
+void hostClockAdvance(uint64_t us);
+
+#endif // HOST_CLOCK_H
@@ -0,0 +1,15 @@
+// Inputs a driver feeds to the firmware: pin levels behind digitalRead(),
+// the bytes an I2C device answers with through Wire, and the IMU's
+// acceleration behind FastIMU.h.
+
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+void hostPinSet(uint8_t pin, int level);
+void hostI2cReply(uint8_t addr, const uint8_t* data, size_t len);  // Read by every requestFrom(addr)
+void hostImuSet(float ax, float ay, float az);                       // In g
+
+#endif // HOST_IO_H
@@ -0,0 +1,10 @@
+// Host deferred log: how often each LOG() id was written
+
+#ifndef HOST_LOG_H
+#define HOST_LOG_H
+
+#include "deferred_log.h"
+
+uint32_t hostLogCount(LogFormatId id);
+
+#endif // HOST_LOG_H
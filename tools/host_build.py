@@ -0,0 +1,76 @@
+"""Build firmware modules on the host for the tools/ drivers.
+
+tools/host/include stands in for the Arduino core, SPI and the panel bus
+(host_bus.h keeps a copy of the ST7789 RAM and counts what is sent), and
+for the inputs: pins, I2C devices and the IMU read what a driver set
+through host_io.h. tools/host/*.cpp implement them. With GFX=True the GFX library core, the
+canvases and the ST7789 driver from lib/GFX_Library_for_Arduino are built
+in, so pomodoro_globals.cpp and the display code compile unchanged.
+
+    import host_build
+    host_build.add_arguments(parser)
+    binary = host_build.build(args, "canvas_test", DRIVER, sources=["src/color_utils.cpp"], gfx=True)
+"""
+
+import glob
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HOST = os.path.join(REPO, "tools", "host")
+GFX = os.path.join(REPO, "lib", "GFX_Library_for_Arduino", "src")
+
+INCLUDES = [
+    os.path.join(HOST, "include"),
+    os.path.join(REPO, "src"),
+    GFX,
+    os.path.join(REPO, "lib"),
+    os.path.join(REPO, "lib", "esp_lcd_touch_axs5106l"),
+]
+
+GFX_SOURCES = [
+    "Arduino_DataBus.cpp",
+    "Arduino_G.cpp",
+    "Arduino_GFX.cpp",
+    "Arduino_TFT.cpp",
+    "fixed_math.cpp",
+    "display/Arduino_ST7789.cpp",
+    "canvas/Arduino_Canvas.cpp",
+    "canvas/Arduino_Canvas_Indexed.cpp",
+    "canvas/Arduino_DirtyRegion.cpp",
+    "canvas/Arduino_RowHash.cpp",
+]
+
+
+def add_arguments(parser):
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="compiler command, may include flags")
+    parser.add_argument("--sanitize", action="store_true", help="build with -fsanitize=address,undefined")
+    parser.add_argument("--keep", metavar="DIR", help="write the driver and binary to DIR and keep them")
+
+
+def build(args, name, driver, sources=(), gfx=False, defines=()):
+    """Compile driver (C++ source text) with the given repo-relative sources; returns the binary path."""
+    workdir = args.keep or tempfile.mkdtemp(prefix=name + "_")
+    os.makedirs(workdir, exist_ok=True)
+    source = os.path.join(workdir, name + ".cpp")
+    binary = os.path.join(workdir, name)
+    with open(source, "w") as f:
+        f.write(driver)
+
+    files = [source] + sorted(glob.glob(os.path.join(HOST, "*.cpp")))
+    files += [os.path.join(REPO, s) for s in sources]
+    if gfx:
+        files += [os.path.join(GFX, s) for s in GFX_SOURCES]
+    opt = ["-O2"]
+    if args.sanitize:
+        opt = ["-O1", "-g", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"]
+    cmd = shlex.split(args.cxx) + ["-std=gnu++17"] + opt + ["-w"] + ["-I" + d for d in INCLUDES]
+    cmd += ["-D" + d for d in defines] + files + ["-o", binary]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+    return binary
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Load test for the HTTP API (src/http_api.h).
+
+Measures requests per second on kept-alive connections (GET /state) and
+how long a state change takes to reach every /events stream: "mode" is
+POSTed to /cmd and the time until each stream sees the next "state" event
+is recorded. Three mode changes bring the timer back to the mode it had.
+Prints the device's /metrics at the end.
+
+    python3 tools/http_bench.py 192.168.1.42
+    python3 tools/http_bench.py 192.168.1.42:80 --requests 2000 --connections 2 --streams 3
+
+src/http_server.cpp only uses POSIX sockets, so the same run works against
+a host build of the server.
+"""
+
+import argparse
+import http.client
+import socket
+import statistics
+import threading
+import time
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def bench_requests(host, port, total, connections):
+    latencies = []
+    lock = threading.Lock()
+
+    def worker(count):
+        conn = http.client.HTTPConnection(host, port, timeout=5)
+        mine = []
+        for _ in range(count):
+            start = time.perf_counter()
+            conn.request("GET", "/state")
+            conn.getresponse().read()
+            mine.append(time.perf_counter() - start)
+        conn.close()
+        with lock:
+            latencies.extend(mine)
+
+    threads = [threading.Thread(target=worker, args=(total // connections,)) for _ in range(connections)]
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+    print("GET /state: %d requests on %d connections in %.2f s = %.0f req/s" %
+          (len(latencies), connections, elapsed, len(latencies) / elapsed))
+    print("  latency ms: p50 %.1f  p99 %.1f  max %.1f" %
+          (percentile(latencies, 50) * 1e3, percentile(latencies, 99) * 1e3, max(latencies) * 1e3))
+
+
+class Stream:
+    """One /events connection, recording when each event arrives."""
+
+    def __init__(self, host, port):
+        self.sock = socket.create_connection((host, port), timeout=5)
+        self.sock.sendall(b"GET /events HTTP/1.1\r\nHost: %s\r\n\r\n" % host.encode())
+        self.arrivals = []
+        self.thread = threading.Thread(target=self.read, daemon=True)
+        self.thread.start()
+
+    def read(self):
+        buf = b""
+        try:
+            while True:
+                data = self.sock.recv(1024)
+                if not data:
+                    return
+                buf += data
+                while b"\n\n" in buf:
+                    block, buf = buf.split(b"\n\n", 1)
+                    if b"event: state" in block:
+                        self.arrivals.append(time.perf_counter())
+        except OSError:
+            return
+
+    def close(self):
+        self.sock.close()
+
+
+def bench_events(host, port, streams, changes):
+    open_streams = [Stream(host, port) for _ in range(streams)]
+    time.sleep(0.5)  # Initial state event
+    conn = http.client.HTTPConnection(host, port, timeout=5)
+    last = []
+    for _ in range(changes):
+        seen = [len(s.arrivals) for s in open_streams]
+        sent = time.perf_counter()
+        conn.request("POST", "/cmd", body='{"cmd":"mode"}', headers={"Content-Type": "application/json"})
+        conn.getresponse().read()
+        deadline = sent + 2
+        while time.perf_counter() < deadline and any(len(s.arrivals) == n for s, n in zip(open_streams, seen)):
+            time.sleep(0.001)
+        got = [s.arrivals[n] - sent for s, n in zip(open_streams, seen) if len(s.arrivals) > n]
+        if len(got) < streams:
+            print("  %d of %d streams missed the event" % (streams - len(got), streams))
+        if got:
+            last.append(max(got))
+    conn.close()
+    for s in open_streams:
+        s.close()
+    if last:
+        print("POST /cmd -> last of %d streams: mean %.1f ms, max %.1f ms (%d changes)" %
+              (streams, statistics.mean(last) * 1e3, max(last) * 1e3, len(last)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("address", help="host or host:port")
+    parser.add_argument("--requests", type=int, default=1000)
+    parser.add_argument("--connections", type=int, default=2)
+    parser.add_argument("--streams", type=int, default=2, help="at most HTTP_MAX_CLIENTS - 1")
+    parser.add_argument("--changes", type=int, default=3, help="mode changes (3 = back to the start)")
+    args = parser.parse_args()
+    host, _, port = args.address.partition(":")
+    port = int(port or 80)
+
+    bench_requests(host, port, args.requests, args.connections)
+    time.sleep(0.2)  # Let the server see those connections close
+    bench_events(host, port, args.streams, args.changes)
+
+    conn = http.client.HTTPConnection(host, port, timeout=5)
+    conn.request("GET", "/metrics")
+    print("/metrics:\n" + conn.getresponse().read().decode())
+
+
+if __name__ == "__main__":
+    main()
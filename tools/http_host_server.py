@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Run src/http_server.cpp on the host, behind a stand-in for the timer API.
+
+Builds the server with a small main() whose handler answers like
+src/http_api.cpp: GET /state, POST /cmd, GET /events, GET /metrics. The
+timer behind it is faked. "mode" cycles the mode, the other commands
+change the state, and each change is published to the event streams. /cmd
+has the same rules as on the device: Content-Type application/json, a
+{"cmd":"..."} body, and no CORS header. The server itself, with its
+connection pool, keep-alive, pipelining and stream fan-out, is the
+firmware's code with the firmware's limits from pomodoro_config.h.
+
+    python3 tools/http_host_server.py                  # serve on 127.0.0.1:8080 until Ctrl-C
+    python3 tools/http_host_server.py --port 8081
+    python3 tools/http_host_server.py --bench --streams 3   # run tools/http_bench.py against it and stop
+    python3 tools/http_host_server.py --sanitize            # with AddressSanitizer and UBSan, for malformed input
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+DRIVER = r"""
+#include "http_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static HttpServer server;
+static const char* const stateNames[] = { "stopped", "running", "paused" };
+static const char* const modeNames[] = { "1/1", "25/5", "50/10" };
+static int state = 0;
+static int mode = 1;
+static bool changed = true;
+
+static int formatState(char* out, size_t size) {
+  return snprintf(out, size, "{\"state\":\"%s\",\"session\":\"work\",\"mode\":\"%s\"}", stateNames[state],
+                  modeNames[mode]);
+}
+
+static bool runCommand(const char* body, size_t len, char* word, size_t size) {
+  const char* end = body + len;
+  const char* key = (const char*)memmem(body, len, "\"cmd\"", 5);
+  if (key == nullptr) return false;
+  const char* p = (const char*)memchr(key + 5, '"', end - (key + 5));
+  if (p == nullptr) return false;
+  p++;
+  size_t n = 0;
+  while (p < end && n < size - 1 && *p >= 'a' && *p <= 'z') word[n++] = *p++;
+  word[n] = '\0';
+  if (strcmp(word, "start") == 0 || strcmp(word, "resume") == 0) state = 1;
+  else if (strcmp(word, "pause") == 0) state = 2;
+  else if (strcmp(word, "stop") == 0) state = 0;
+  else if (strcmp(word, "mode") == 0) mode = (mode + 1) % 3;
+  else return false;
+  changed = true;
+  return true;
+}
+
+static void handleRequest(const HttpRequest& req, HttpResponse& res) {
+  bool get = strcmp(req.method, "GET") == 0;
+  bool post = strcmp(req.method, "POST") == 0;
+  if (strcmp(req.path, "/state") == 0) {
+    res.status = get ? 200 : 405;
+    if (get) res.bodyLen = formatState(res.body, res.bodyMax);
+  } else if (strcmp(req.path, "/cmd") == 0) {
+    res.cors = false;
+    bool json = strncasecmp(req.contentType, "application/json", 16) == 0;
+    char cmd[16] = "";
+    bool ok = post && json && runCommand(req.body, req.bodyLen, cmd, sizeof(cmd));
+    res.status = !post ? 405 : !json ? 415 : ok ? 202 : 400;
+    res.bodyLen = snprintf(res.body, res.bodyMax, ok ? "{\"ok\":true,\"cmd\":\"%s\"}" : "{\"ok\":false}", cmd);
+  } else if (strcmp(req.path, "/events") == 0) {
+    res.status = get ? 200 : 405;
+    res.contentType = "text/event-stream";
+    res.stream = get;
+    if (get) res.bodyLen = snprintf(res.body, res.bodyMax, "retry: 2000\n\n");
+  } else if (strcmp(req.path, "/metrics") == 0) {
+    const HttpServerStats& st = server.stats();
+    res.status = get ? 200 : 405;
+    res.contentType = "text/plain";
+    if (get) {
+      res.bodyLen = snprintf(res.body, res.bodyMax,
+                             "requests %lu\nrejected %lu\nstreams %u\nevents %lu\ndeliveries %lu\nskipped %lu\n"
+                             "fanout_last_us %lu\nfanout_max_us %lu\n",
+                             (unsigned long)st.requests, (unsigned long)st.rejected, server.streams(),
+                             (unsigned long)st.events, (unsigned long)st.deliveries, (unsigned long)st.skipped,
+                             (unsigned long)st.lastFanOutUs, (unsigned long)st.maxFanOutUs);
+    }
+  } else {
+    res.bodyLen = snprintf(res.body, res.bodyMax, "{\"error\":\"not found\"}");
+  }
+  if (res.bodyLen > res.bodyMax) res.bodyLen = 0;
+}
+
+int main(int argc, char** argv) {
+  uint16_t port = (argc > 1) ? atoi(argv[1]) : 8080;
+  if (!server.begin(port, handleRequest)) {
+    fprintf(stderr, "cannot listen on port %u\n", port);
+    return 1;
+  }
+  printf("listening on 127.0.0.1:%u\n", port);
+  fflush(stdout);
+  while (true) {
+    if (changed) {
+      changed = false;
+      char event[HTTP_EVENT_MAX];
+      int len = snprintf(event, sizeof(event), "event: state\ndata: ");
+      len += formatState(event + len, sizeof(event) - len);
+      len += snprintf(event + len, sizeof(event) - len, "\n\n");
+      if (len < (int)sizeof(event)) server.publish(event, len);
+    }
+    server.poll(HTTP_POLL_MS);
+  }
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--bench", action="store_true", help="run tools/http_bench.py against it, then stop")
+    parser.add_argument("--sanitize", action="store_true", help="build with -fsanitize=address,undefined")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--keep", metavar="DIR", help="write the driver to DIR and keep it")
+    args, bench_args = parser.parse_known_args()
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="http_host_server_")
+    os.makedirs(workdir, exist_ok=True)
+    source = os.path.join(workdir, "http_host_server.cpp")
+    binary = os.path.join(workdir, "http_host_server")
+    with open(source, "w") as f:
+        f.write(DRIVER)
+    cmd = [args.cxx, "-std=c++17", "-O2", "-I" + os.path.join(REPO, "src"), source,
+           os.path.join(REPO, "src", "http_server.cpp"), "-o", binary]
+    if args.sanitize:
+        cmd[2:3] = ["-O1", "-g", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    if build.returncode != 0:
+        sys.stderr.write(build.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+
+    server = subprocess.Popen([binary, str(args.port)])
+    try:
+        if not args.bench:
+            server.wait()
+            return
+        time.sleep(0.3)
+        bench = [sys.executable, os.path.join(REPO, "tools", "http_bench.py"), "127.0.0.1:%d" % args.port]
+        sys.exit(subprocess.run(bench + bench_args).returncode)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.terminate()
+        server.wait()
+
+
+if __name__ == "__main__":
+    main()
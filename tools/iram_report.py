@@ -0,0 +1,90 @@
+# Optional PlatformIO post-build report: what the hot-path placement costs in IRAM.
+#
+# With -DGFX_IRAM_HOT the render and touch paths tagged HOT_IRAM_ATTR /
+# GFX_IRAM_ATTR are linked into IRAM, which on the ESP32-C6 is carved out of
+# the same SRAM as the heap. This lists each tagged function found in IRAM
+# with its size, the total against the budget, and the whole IRAM text
+# section. Measure the gain with the profiler's stall mode ('i') in builds
+# with and without the flag before growing the list.
+# Enable in platformio.ini:
+#   extra_scripts = post:tools/iram_report.py
+# IRAM_HOT_BUDGET sets the budget in bytes (default 8192); set
+# IRAM_BUDGET_STRICT=1 in the environment to fail the build when over it.
+
+import os
+import re
+import subprocess
+
+Import("env")  # noqa: F821
+
+# Functions tagged for IRAM, as nm -C prints them (without arguments)
+HOT_FUNCTIONS = [
+    "Arduino_GFX::drawChar",
+    "Arduino_HWSPI::writeRepeat",
+    "Arduino_HWSPI::writePixels",
+    "Arduino_Canvas_Indexed::writePixelPreclipped",
+    "Arduino_Canvas_Indexed::writeFastHLineCore",
+    "Arduino_Canvas_Indexed::writeFastVLineCore",
+    "Arduino_Canvas_Indexed::writeFillRectPreclipped",
+    "Arduino_Canvas_Indexed::get_color_index",
+    "drawProgressCircle",
+    "readTouchData",
+]
+
+DEFAULT_BUDGET = 8192
+
+SECTION_LINE = re.compile(r"^\s*\d+\s+(\S+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s")
+
+
+def _tool(name):
+    cc = env.subst("$CC")  # noqa: F821
+    if cc.endswith("gcc"):
+        return cc[: -len("gcc")] + name
+    return name
+
+
+def _iram_text_range(elf):
+    out = subprocess.run([_tool("objdump"), "-h", elf], capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        m = SECTION_LINE.match(line)
+        if m and m.group(1) == ".iram0.text":
+            size = int(m.group(2), 16)
+            start = int(m.group(3), 16)
+            return start, start + size
+    return None
+
+
+def iram_report(source, target, env):
+    elf = str(target[0])
+    iram = _iram_text_range(elf)
+    if iram is None:
+        print("IRAM report: no .iram0.text section")
+        return
+    start, end = iram
+
+    out = subprocess.run([_tool("nm"), "-C", "-S", elf], capture_output=True, text=True).stdout
+    found = {}
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4 or parts[2].lower() != "t":
+            continue
+        addr, size = int(parts[0], 16), int(parts[1], 16)
+        name = parts[3].split("(")[0]
+        if name in HOT_FUNCTIONS and start <= addr < end:
+            found[name] = found.get(name, 0) + size
+
+    budget = int(os.environ.get("IRAM_HOT_BUDGET", DEFAULT_BUDGET))
+    total = sum(found.values())
+    for name in HOT_FUNCTIONS:
+        if name in found:
+            print("IRAM report: %6d  %s" % (found[name], name))
+    if not found:
+        print("IRAM report: no hot paths in IRAM (build with -DGFX_IRAM_HOT)")
+    print("IRAM report: hot paths %d of %d bytes budget, .iram0.text %d bytes" % (total, budget, end - start))
+    if total > budget:
+        print("IRAM report: over budget by %d bytes" % (total - budget))
+        if os.environ.get("IRAM_BUDGET_STRICT") == "1":
+            env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", iram_report)  # noqa: F821
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""Heap allocations per Telegram message, String concatenation vs message_format.
+
+Builds a small host program against src/message_format.cpp with malloc,
+calloc and realloc wrapped by the linker, and counts the allocations each
+reply or notification takes on both paths:
+
+  old  the String code the handlers had: "+=" and "+" chains on a model of
+       arduino-esp32's WString (10 characters inline, heap buffers rounded
+       up to 16 bytes and grown with realloc), and a const String& parameter
+       where a literal or char buffer was passed
+  new  formatMessage()/appendMessage() into a fixed buffer
+
+    python3 tools/message_alloc_bench.py
+    python3 tools/message_alloc_bench.py --keep /tmp/bench   # leave the harness there
+
+What UniversalTelegramBot::sendMessage allocated inside the library (its
+JSON document and request Strings) is not modelled; the replies now go out
+through telegramPost() on static buffers instead. Needs a C++17 compiler and
+a GNU-compatible linker (--wrap).
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+HARNESS = r"""
+#include "message_format.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+static unsigned long allocations = 0;
+static bool counting = false;
+
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t m);
+void* __real_realloc(void* p, size_t n);
+void* __wrap_malloc(size_t n) { if (counting) allocations++; return __real_malloc(n); }
+void* __wrap_calloc(size_t n, size_t m) { if (counting) allocations++; return __real_calloc(n, m); }
+void* __wrap_realloc(void* p, size_t n) { if (counting) allocations++; return __real_realloc(p, n); }
+}
+
+// The parts of arduino-esp32's WString the handlers used
+class String {
+ public:
+  String(const char* s = "") { concat(s, strlen(s)); }
+  String(const String& o) { concat(o.c_str(), o.len); }
+  String(String&& o) : heap(o.heap), cap(o.cap), len(o.len) {
+    memcpy(sso, o.sso, sizeof(sso));
+    o.heap = nullptr;
+    o.len = 0;
+  }
+  explicit String(unsigned long v) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%lu", v);
+    concat(buf, strlen(buf));
+  }
+  ~String() { free(heap); }
+  String& operator=(const char* s) { len = 0; concat(s, strlen(s)); return *this; }
+  String& operator+=(const char* s) { concat(s, strlen(s)); return *this; }
+  String& operator+=(const String& s) { concat(s.c_str(), s.len); return *this; }
+  const char* c_str() const { return heap ? heap : sso; }
+  size_t length() const { return len; }
+  void concat(const char* s, size_t n) {
+    reserve(len + n);
+    memcpy(buffer() + len, s, n);
+    len += n;
+    buffer()[len] = '\0';
+  }
+
+ private:
+  static const size_t SSOSIZE = 11;
+  char* buffer() { return heap ? heap : sso; }
+  void reserve(size_t size) {
+    if (size < (heap ? cap : SSOSIZE)) return;
+    size_t newCap = (size + 16) & ~(size_t)15;
+    char* p = (char*)realloc(heap, newCap);
+    if (!heap) memcpy(p, sso, len + 1);
+    heap = p;
+    cap = newCap;
+  }
+  char* heap = nullptr;
+  size_t cap = 0;
+  size_t len = 0;
+  char sso[SSOSIZE] = "";
+};
+
+// "a" + b: a temporary holding a copy of the left side, as StringSumHelper does
+static String operator+(const char* a, const String& b) { String s(a); s += b; return s; }
+static String operator+(String&& a, const char* b) { a += b; return std::move(a); }
+static String operator+(String&& a, const String& b) { a += b; return std::move(a); }
+
+static volatile size_t sink;
+static void oldSend(const String& chat, const String& text, const String& mode) {
+  sink = chat.length() + text.length() + mode.length();
+}
+static void newSend(const char* chat, const char* text) { sink = strlen(chat) + strlen(text); }
+
+static const char* chat = "123456789";
+static volatile unsigned long bytes = 48213, kbps = 312, worstMs = 41, battery = 87;
+static volatile unsigned long focusToday = 75, sessions = 3, focusWeek = 410;
+
+static void oldHelp() {
+  String msg = "🍅 <b>Pomodoro Timer</b>\n\n";
+  msg += "/status - Current status\n";
+  msg += "/work - Start work\n";
+  msg += "/pause - Pause\n";
+  msg += "/resume - Resume\n";
+  msg += "/stop - Stop\n";
+  msg += "/mode - Change mode\n";
+  msg += "/stats - Focus time today and this week\n";
+  msg += "/export [bin] - Write history to SD\n";
+  msg += "/live - Live status message stats\n";
+  msg += "/subscribers - Notification fan-out stats\n";
+  msg += "/perf - Heap, fragmentation and stack headroom\n";
+  msg += "/subscribe, /unsubscribe - Notifications in another chat";
+  oldSend(chat, msg, "HTML");
+}
+
+static void oldStatus() {
+  String msg = "🍅 ";
+  msg += "Working";
+  msg += " | ";
+  msg += "25/5";
+  msg += " | 🔋 " + String(battery) + "%";
+  oldSend(chat, msg, "HTML");
+}
+
+static void oldMode() {
+  String modeStr;
+  modeStr = "50/10";
+  oldSend(chat, "⏱ Mode: " + modeStr, "HTML");
+}
+
+static void oldStats() {
+  String msg = "📊 <b>Focus</b>\n";
+  msg += "Today: " + String(focusToday) + " min (" + String(sessions) + " sessions)\n";
+  msg += "This week: " + String(focusWeek) + " min";
+  oldSend(chat, msg, "HTML");
+}
+
+static void oldQueue(const String& message) {  // sendTelegramMessage(const String&)
+  char text[256];
+  strncpy(text, message.c_str(), sizeof(text) - 1);
+  sink = strlen(text);
+}
+
+static void oldExport() {
+  oldQueue("💾 Exported " + String(bytes) + " bytes to SD (" + String(kbps) + " KB/s, worst block " +
+           String(worstMs) + " ms)");
+}
+
+static void oldEvent() { oldQueue("🍅 <b>Work time!</b> Focus on your task."); }
+
+static void newHelp() {
+  char reply[640];
+  formatMessage(reply, sizeof(reply), MSG_HELP);
+  newSend(chat, reply);
+}
+
+static void newStatus() {
+  char reply[640];
+  size_t len = formatMessage(reply, sizeof(reply), MSG_STATUS, { msgMarkup("Working"), msgMarkup("25/5") });
+  appendMessage(reply, sizeof(reply), len, MSG_STATUS_BATTERY, { msgUint(battery) });
+  newSend(chat, reply);
+}
+
+static void newMode() {
+  char reply[640];
+  formatMessage(reply, sizeof(reply), MSG_MODE, { msgMarkup("50/10") });
+  newSend(chat, reply);
+}
+
+static void newStats() {
+  char reply[640];
+  formatMessage(reply, sizeof(reply), MSG_STATS, { msgUint(focusToday), msgUint(sessions), msgUint(focusWeek) });
+  newSend(chat, reply);
+}
+
+static void newQueue(const char* message) {  // sendTelegramMessage(const char*)
+  char text[256];
+  formatMessage(text, sizeof(text), "{0}", { msgMarkup(message) });
+  sink = strlen(text);
+}
+
+static void newExport() {
+  char text[96];
+  formatMessage(text, sizeof(text), MSG_EXPORTED, { msgUint(bytes), msgUint(kbps), msgUint(worstMs) });
+  newQueue(text);
+}
+
+static void newEvent() { newQueue(messageTemplate(MSG_WORK_TIME)); }
+
+static unsigned long count(void (*fn)(), int runs) {
+  fn();  // Warm up anything lazily set up by the C++ runtime
+  allocations = 0;
+  counting = true;
+  for (int i = 0; i < runs; i++) fn();
+  counting = false;
+  return allocations;
+}
+
+int main(int argc, char** argv) {
+  int runs = (argc > 1) ? atoi(argv[1]) : 1000;
+  struct { const char* name; void (*oldFn)(); void (*newFn)(); } cases[] = {
+    { "/help", oldHelp, newHelp },
+    { "/status", oldStatus, newStatus },
+    { "/mode", oldMode, newMode },
+    { "/stats", oldStats, newStats },
+    { "SD export done", oldExport, newExport },
+    { "timer event", oldEvent, newEvent },
+  };
+  printf("%-16s %14s %14s\n", "message", "old allocs/msg", "new allocs/msg");
+  for (const auto& c : cases) {
+    printf("%-16s %14.1f %14.1f\n", c.name, (double)count(c.oldFn, runs) / runs,
+           (double)count(c.newFn, runs) / runs);
+  }
+  return 0;
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--runs", type=int, default=1000, help="messages per case")
+    parser.add_argument("--keep", metavar="DIR", help="write the harness to DIR and keep it")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    args = parser.parse_args()
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="message_alloc_bench_")
+    os.makedirs(workdir, exist_ok=True)
+    source = os.path.join(workdir, "message_alloc_bench.cpp")
+    binary = os.path.join(workdir, "message_alloc_bench")
+    with open(source, "w") as f:
+        f.write(HARNESS)
+
+    cmd = [args.cxx, "-std=c++17", "-O1", "-I" + os.path.join(REPO, "src"), source,
+           os.path.join(REPO, "src", "message_format.cpp"),
+           "-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc", "-o", binary]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    if build.returncode != 0:
+        sys.stderr.write(build.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+    subprocess.run([binary, str(args.runs)], check=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,438 @@
+#!/usr/bin/env python3
+"""Run src/mqtt_client.cpp on the host against a broker and check reconnects.
+
+Builds the client with a POSIX socket Client and a driver that takes its
+steps from stdin (connect, poll, drop the link, disconnect) and prints
+every message with its retain flag. The driver handles the cmd topic the
+way src/mqtt_state.cpp does: live commands are run, retained ones are
+ignored. The test then goes through what happens on the device:
+
+  1. A retained "start" is published while the client is subscribed: the
+     broker forwards it live, it runs once.
+  2. The link drops without a DISCONNECT and the client reconnects and
+     subscribes again: the broker replays the stored "start" with RETAIN
+     set, and it must not run a second time.
+  3. A plain "pause" after the reconnect runs.
+  4. A clean disconnect and another reconnect: still nothing re-runs.
+  5. Once the retained cmd is cleared, a reconnect gets nothing at all.
+
+Without --broker a minimal MQTT 3.1.1 broker in this script is used (QoS 0,
+exact topic match, retained messages as the spec has them). With --broker
+the same steps run against a real one, e.g. mosquitto; the retained test
+message is cleared afterwards.
+
+    python3 tools/mqtt_host_test.py
+    python3 tools/mqtt_host_test.py --broker 127.0.0.1:1883   # mosquitto -p 1883
+    python3 tools/mqtt_host_test.py --sanitize                # with AddressSanitizer and UBSan
+"""
+
+import argparse
+import os
+import socket
+import socketserver
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+ARDUINO_H = r"""
+// Host stand-in for the parts of Arduino.h the MQTT client uses
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+inline uint32_t millis() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+inline void delay(uint32_t ms) {
+  timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+  nanosleep(&ts, nullptr);
+}
+"""
+
+CLIENT_H = r"""
+// Host stand-in for Arduino's Client.h
+#pragma once
+#include <Arduino.h>
+
+class Client {
+ public:
+  virtual ~Client() {}
+  virtual int connect(const char* host, uint16_t port) = 0;
+  virtual size_t write(const uint8_t* buf, size_t size) = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+};
+"""
+
+DRIVER = r"""
+#include "mqtt_client.h"
+#include <errno.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+class SocketClient : public Client {
+ public:
+  int connect(const char* host, uint16_t port) override {
+    stop();
+    addrinfo hints = {}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &res) != 0) return 0;
+    fd = socket(res->ai_family, res->ai_socktype, 0);
+    bool ok = fd >= 0 && ::connect(fd, res->ai_addr, res->ai_addrlen) == 0;
+    freeaddrinfo(res);
+    if (!ok) stop();
+    open = ok;
+    return ok;
+  }
+  size_t write(const uint8_t* buf, size_t size) override {
+    if (fd < 0) return 0;
+    ssize_t n = send(fd, buf, size, MSG_NOSIGNAL);
+    if (n < 0) open = false;
+    return n < 0 ? 0 : n;
+  }
+  int available() override {
+    if (fd < 0) return 0;
+    int n = 0;
+    if (ioctl(fd, FIONREAD, &n) < 0) return 0;
+    if (n == 0) {
+      // Readable with nothing in it: the broker closed
+      char probe;
+      if (recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) == 0) open = false;
+    }
+    return n;
+  }
+  int read() override {
+    uint8_t b;
+    return (fd >= 0 && recv(fd, &b, 1, 0) == 1) ? b : -1;
+  }
+  void stop() override {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    open = false;
+  }
+  uint8_t connected() override {
+    if (fd >= 0 && open) available();
+    return fd >= 0 && open;
+  }
+
+ private:
+  int fd = -1;
+  bool open = false;
+};
+
+static SocketClient net;
+static MqttClient mqtt(net);
+static char cmdTopic[64];
+
+// As onCommand in src/mqtt_state.cpp
+static void onMessage(const char* topic, const char* payload, size_t len, bool retained) {
+  printf("message %s %.*s retained=%d\n", topic, (int)len, payload, retained ? 1 : 0);
+  if (strcmp(topic, cmdTopic) != 0) return;
+  printf("%s %.*s\n", retained ? "ignored" : "run", (int)len, payload);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4) return 2;
+  const char* host = argv[1];
+  uint16_t port = atoi(argv[2]);
+  const char* prefix = argv[3];
+  snprintf(cmdTopic, sizeof(cmdTopic), "%s/cmd", prefix);
+  char willTopic[64];
+  snprintf(willTopic, sizeof(willTopic), "%s/availability", prefix);
+  MqttWill will = { willTopic, "offline" };
+  mqtt.onMessage(onMessage);
+
+  char line[64];
+  while (fgets(line, sizeof(line), stdin)) {
+    line[strcspn(line, "\n")] = '\0';
+    if (strcmp(line, "connect") == 0) {
+      bool ok = mqtt.connect(host, port, "pomodoro-host-test", nullptr, nullptr, &will, 30) &&
+                mqtt.publish(willTopic, "online", true) && mqtt.subscribe(cmdTopic);
+      printf("connect %s rc=%u\n", ok ? "ok" : "failed", mqtt.returnCode());
+    } else if (strncmp(line, "poll ", 5) == 0) {
+      uint32_t until = millis() + atoi(line + 5);
+      bool ok = true;
+      while (ok && (int32_t)(millis() - until) < 0) {
+        ok = mqtt.poll();
+        delay(5);
+      }
+      printf("poll %s\n", ok ? "ok" : "lost");
+    } else if (strcmp(line, "drop") == 0) {
+      net.stop();  // Link gone, no DISCONNECT: the broker sends the will
+      printf("dropped\n");
+    } else if (strcmp(line, "disconnect") == 0) {
+      mqtt.disconnect();
+      printf("disconnected\n");
+    }
+    printf("done\n");
+    fflush(stdout);
+  }
+  return 0;
+}
+"""
+
+
+# --- Minimal broker: CONNECT, PUBLISH (QoS 0), SUBSCRIBE, PINGREQ, DISCONNECT ---
+def encode_length(n):
+    out = bytearray()
+    while True:
+        digit, n = n & 0x7F, n >> 7
+        out.append(digit | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def mqtt_string(s):
+    data = s.encode()
+    return struct.pack(">H", len(data)) + data
+
+
+def publish_packet(topic, payload, retain):
+    body = mqtt_string(topic) + payload
+    return bytes([0x30 | (1 if retain else 0)]) + encode_length(len(body)) + body
+
+
+def read_packet(sock):
+    first = sock.recv(1)
+    if not first:
+        return None, None
+    length, shift = 0, 0
+    while True:
+        b = sock.recv(1)
+        if not b:
+            return None, None
+        length |= (b[0] & 0x7F) << shift
+        shift += 7
+        if not b[0] & 0x80:
+            break
+    body = b""
+    while len(body) < length:
+        chunk = sock.recv(length - len(body))
+        if not chunk:
+            return None, None
+        body += chunk
+    return first[0], body
+
+
+class Broker(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+    def __init__(self):
+        super().__init__(("127.0.0.1", 0), BrokerSession)
+        self.lock = threading.Lock()
+        self.retained = {}       # topic -> payload
+        self.subscribers = {}    # topic -> set of sockets
+
+    def publish(self, topic, payload, retain):
+        with self.lock:
+            if retain:
+                if payload:
+                    self.retained[topic] = payload
+                else:
+                    self.retained.pop(topic, None)
+            targets = list(self.subscribers.get(topic, ()))
+        # Forwarded to established subscriptions with RETAIN cleared (3.3.1.3)
+        for sock in targets:
+            try:
+                sock.sendall(publish_packet(topic, payload, False))
+            except OSError:
+                pass
+
+
+class BrokerSession(socketserver.BaseRequestHandler):
+    def handle(self):
+        broker, sock = self.server, self.request
+        will = None
+        clean = False
+        try:
+            while True:
+                ptype, body = read_packet(sock)
+                if ptype is None:
+                    break
+                kind = ptype & 0xF0
+                if kind == 0x10:
+                    flags = body[7]
+                    at = 10
+                    n = struct.unpack(">H", body[at:at + 2])[0]
+                    at += 2 + n
+                    if flags & 0x04:
+                        n = struct.unpack(">H", body[at:at + 2])[0]
+                        will_topic = body[at + 2:at + 2 + n].decode()
+                        at += 2 + n
+                        n = struct.unpack(">H", body[at:at + 2])[0]
+                        will = (will_topic, body[at + 2:at + 2 + n], bool(flags & 0x20))
+                    sock.sendall(b"\x20\x02\x00\x00")
+                elif kind == 0x30:
+                    n = struct.unpack(">H", body[:2])[0]
+                    broker.publish(body[2:2 + n].decode(), body[2 + n:], bool(ptype & 0x01))
+                elif kind == 0x80:
+                    packet_id = body[:2]
+                    n = struct.unpack(">H", body[2:4])[0]
+                    topic = body[4:4 + n].decode()
+                    with broker.lock:
+                        broker.subscribers.setdefault(topic, set()).add(sock)
+                        stored = broker.retained.get(topic)
+                    sock.sendall(b"\x90\x03" + packet_id + b"\x00")
+                    # Replayed to the new subscription with RETAIN set
+                    if stored is not None:
+                        sock.sendall(publish_packet(topic, stored, True))
+                elif kind == 0xC0:
+                    sock.sendall(b"\xD0\x00")
+                elif kind == 0xE0:
+                    clean = True
+                    break
+        except OSError:
+            pass
+        finally:
+            with broker.lock:
+                for subs in broker.subscribers.values():
+                    subs.discard(sock)
+            if will and not clean:
+                broker.publish(*will)
+
+
+# --- Test side: a raw publisher and the driver ---
+def publish(host, port, topic, payload, retain):
+    with socket.create_connection((host, port), timeout=5) as sock:
+        body = mqtt_string("MQTT") + bytes([4, 0x02, 0, 30]) + mqtt_string("pomodoro-host-pub")
+        sock.sendall(b"\x10" + encode_length(len(body)) + body)
+        ptype, ack = read_packet(sock)
+        if ptype != 0x20 or ack[1] != 0:
+            sys.exit("publisher not accepted by the broker")
+        sock.sendall(publish_packet(topic, payload.encode(), retain))
+        sock.sendall(b"\xE0\x00")
+    time.sleep(0.05)
+
+
+class Driver:
+    def __init__(self, binary, host, port, prefix):
+        self.proc = subprocess.Popen([binary, host, str(port), prefix], stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, text=True)
+
+    def step(self, command):
+        self.proc.stdin.write(command + "\n")
+        self.proc.stdin.flush()
+        lines = []
+        while True:
+            line = self.proc.stdout.readline()
+            if not line:
+                sys.exit("driver exited during '%s'" % command)
+            line = line.rstrip("\n")
+            if line == "done":
+                return lines
+            lines.append(line)
+
+    def close(self):
+        self.proc.stdin.close()
+        return self.proc.wait()
+
+
+def build(args, workdir):
+    for name, text in (("Arduino.h", ARDUINO_H), ("Client.h", CLIENT_H), ("mqtt_host_test.cpp", DRIVER)):
+        with open(os.path.join(workdir, name), "w") as f:
+            f.write(text)
+    binary = os.path.join(workdir, "mqtt_host_test")
+    cmd = [args.cxx, "-std=c++17", "-O2", "-I" + workdir, "-I" + os.path.join(REPO, "src"),
+           os.path.join(workdir, "mqtt_host_test.cpp"), os.path.join(REPO, "src", "mqtt_client.cpp"), "-o", binary]
+    if args.sanitize:
+        cmd[2:3] = ["-O1", "-g", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+    return binary
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--broker", metavar="HOST:PORT", help="use this broker instead of the built-in one")
+    parser.add_argument("--sanitize", action="store_true", help="build with -fsanitize=address,undefined")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--keep", metavar="DIR", help="write the driver to DIR and keep it")
+    args = parser.parse_args()
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="mqtt_host_test_")
+    os.makedirs(workdir, exist_ok=True)
+    binary = build(args, workdir)
+
+    broker = None
+    if args.broker:
+        host, port = args.broker.rsplit(":", 1)
+        port = int(port)
+    else:
+        broker = Broker()
+        threading.Thread(target=broker.serve_forever, daemon=True).start()
+        host, port = broker.server_address
+
+    prefix = "pomodoro-test-%d" % os.getpid()
+    cmd_topic = prefix + "/cmd"
+    failures = []
+
+    def expect(label, lines, want_run, want_ignored):
+        run = [l.split(" ", 1)[1] for l in lines if l.startswith("run ")]
+        ignored = [l.split(" ", 1)[1] for l in lines if l.startswith("ignored ")]
+        ok = run == want_run and ignored == want_ignored
+        print("%-36s run=%-10s ignored=%-10s %s" % (label, ",".join(run) or "-", ",".join(ignored) or "-",
+                                                     "ok" if ok else "FAIL"))
+        if not ok:
+            failures.append(label)
+
+    driver = Driver(binary, host, port, prefix)
+    try:
+        lines = driver.step("connect")
+        if not lines or not lines[0].startswith("connect ok"):
+            sys.exit("cannot connect to %s:%d: %s" % (host, port, " ".join(lines)))
+        driver.step("poll 100")
+        publish(host, port, cmd_topic, "start", True)
+        expect("retained start while subscribed", driver.step("poll 200"), ["start"], [])
+
+        driver.step("drop")
+        expect("reconnect after a dropped link", driver.step("connect") + driver.step("poll 200"), [], ["start"])
+
+        publish(host, port, cmd_topic, "pause", False)
+        expect("plain pause after the reconnect", driver.step("poll 200"), ["pause"], [])
+
+        driver.step("disconnect")
+        expect("reconnect after a clean disconnect", driver.step("connect") + driver.step("poll 200"), [], ["start"])
+
+        # Cleared retained cmd: a reconnect gets nothing
+        publish(host, port, cmd_topic, "", True)
+        driver.step("poll 100")
+        driver.step("drop")
+        expect("reconnect after the retain is cleared", driver.step("connect") + driver.step("poll 200"), [], [])
+        driver.step("disconnect")
+    finally:
+        publish(host, port, cmd_topic, "", True)
+        publish(host, port, prefix + "/availability", "", True)
+        status = driver.close()
+        if broker:
+            broker.shutdown()
+
+    if status != 0:
+        failures.append("driver exit status %d" % status)
+    if failures:
+        sys.exit("FAILED: " + ", ".join(failures))
+    print("all passed")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Row hash flush: hashing time against the panel bytes it saves.
+
+Builds the app's display code with the indexed canvas on the host (see
+host_build.py and canvas_tick_test.py) and runs it through the screens
+in the order a user gets there. The same sequence runs twice, without
+and with setRowHashDiff(), and each step reports the pixel bytes and
+windows sent:
+
+  splash      boot screen          grid        palette grid
+  select      8 grid selections    preview     color preview
+  home        back to the splash   start       first timer frame
+  ticks       60 running seconds   paused      status button, 10 s paused
+  resumed     status button, 10 running seconds
+  stop        to the splash        splash2     splash drawn again, unchanged
+
+The hash cost is the rows a flush hashes (every row of its dirty
+rectangles, once) times the time to hash one 172 px row, measured here.
+The row it may save is 344 bytes, about 34 us on the 80 MHz SPI bus. For
+the hash time on the ESP32-C6 core, build for rv32imac as below.
+
+    python3 tools/row_hash_bench.py
+    python3 tools/row_hash_bench.py --cxx "riscv32-unknown-linux-gnu-g++ -march=rv32imac -mabi=ilp32 -static" \\
+        --runner qemu-riscv32
+"""
+
+import argparse
+import shlex
+import subprocess
+import sys
+
+import host_build
+
+DRIVER = r"""
+#include "pomodoro_globals.h"
+#include "display_graphics.h"
+#include "display_updates.h"
+#include "timer_logic.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "input_trace.h"
+#include "session_log.h"
+#include "telegram_status.h"
+#include "host_clock.h"
+#include <chrono>
+#include <set>
+#include <string.h>
+
+#define PANEL_W 172
+
+// Neighbours of the display code that the screens do not exercise
+uint8_t batteryPercent() { return 80; }
+void sendTelegramEvent(MessageId) {}
+void sessionEnded(bool, PomodoroMode, unsigned long, bool) {}
+void sessionStarted() {}
+void traceAction(TraceAction) {}
+void traceFrameDone(bool) {}
+
+static Arduino_HWSPI* panel;
+static uint32_t frames, rowsHashed;
+static size_t windowsSeen;
+
+// One main loop pass, counting the rows the row hash reads. Those are
+// the rows of the dirty rectangles, which are the windows sent without it.
+static void frame() {
+  updateTimer();
+  updateDisplay();
+  flushDisplay();
+  std::set<uint16_t> rows;
+  const std::vector<HostWindow>& w = panel->sentWindows();
+  for (; windowsSeen < w.size(); windowsSeen++) {
+    for (uint16_t y = w[windowsSeen].y1; y <= w[windowsSeen].y2; y++) rows.insert(y);
+  }
+  frames++;
+  rowsHashed += rows.size();
+}
+
+static void step(const char* name) {
+  const HostBusStats& st = panel->stats();
+  printf("step %s frames %u windows %u pixel_bytes %llu rows %u\n", name, (unsigned)frames, (unsigned)st.windows,
+         (unsigned long long)st.pixelBytes, (unsigned)rowsHashed);
+  panel->resetStats();
+  frames = rowsHashed = 0;
+  windowsSeen = 0;
+}
+
+static void seconds(int n) {
+  for (int i = 0; i < n; i++) {
+    hostClockAdvance(1000000ULL);
+    frame();
+  }
+}
+
+static double rowHashNs() {
+  using namespace std::chrono;
+  const uint8_t* fb = canvas->getFramebuffer();
+  const uint16_t* palette = canvas->getColorIndex();
+  volatile uint32_t sink = 0;
+  const int runs = 20000;
+  auto t0 = steady_clock::now();
+  for (int i = 0; i < runs; i++) sink = sink + Arduino_RowHash::hashIndexed(fb + (i % 320) * PANEL_W, palette, PANEL_W);
+  return duration<double, std::nano>(steady_clock::now() - t0).count() / runs;
+}
+
+int main(int argc, char** argv) {
+  bool rowHash = argc > 1 && strcmp(argv[1], "rowhash") == 0;
+  hostClockSet(10000000ULL);
+  gfx->begin();
+  initUIColorSlots(selectedWorkColor);
+  canvas->setRowHashDiff(rowHash);
+  gfx->setRotation(currentRotation);
+  panel = (Arduino_HWSPI*)bus;
+  panel->resetStats();
+
+  currentMode = MODE_25_5;
+  displayStoppedState();
+  frame();
+  step("splash");
+
+  currentViewMode = 1;
+  gridViewActive = true;
+  drawGrid();
+  frame();
+  step("grid");
+
+  int16_t row = 0, col = 0;
+  redrawGridCell(row, col, true);
+  frame();
+  for (int i = 0; i < 8; i++) {
+    int16_t nextCol = (col + 1) % gridNumCols;
+    int16_t nextRow = (nextCol == 0) ? row + 1 : row;
+    redrawGridCell(row, col, false);
+    redrawGridCell(nextRow, nextCol, true);
+    row = nextRow;
+    col = nextCol;
+    frame();
+  }
+  step("select");
+
+  currentViewMode = 2;
+  gridViewActive = false;
+  drawColorPreview();
+  frame();
+  step("preview");
+
+  currentViewMode = 0;
+  drawSplash();
+  frame();
+  step("home");
+
+  startTimer();
+  frame();
+  step("start");
+
+  seconds(60);
+  step("ticks");
+
+  hostClockAdvance(300000ULL);
+  pauseTimer();
+  lastDisplayedState = RUNNING;
+  updateDisplay();
+  frame();
+  seconds(10);
+  step("paused");
+
+  resumeTimer();
+  lastDisplayedState = PAUSED;
+  updateDisplay();
+  frame();
+  seconds(10);
+  step("resumed");
+
+  stopTimer();
+  frame();
+  step("stop");
+
+  displayStoppedState();
+  frame();
+  step("splash2");
+
+  printf("row_hash_ns %.1f\n", rowHashNs());
+  return 0;
+}
+"""
+
+
+def run(args, binary, mode):
+    out = subprocess.run(shlex.split(args.runner) + [binary, mode], capture_output=True, text=True)
+    if out.returncode != 0:
+        sys.stderr.write(out.stderr)
+        sys.exit("row_hash_bench failed")
+    steps, ns = [], 0.0
+    for line in out.stdout.splitlines():
+        f = line.split()
+        if f[0] == "step":
+            steps.append((f[1], int(f[3]), int(f[5]), int(f[7]), int(f[9])))
+        elif f[0] == "row_hash_ns":
+            ns = float(f[1])
+    return steps, ns
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    host_build.add_arguments(parser)
+    parser.add_argument("--runner", default="", help="prefix to run the binary with, e.g. qemu-riscv32")
+    args = parser.parse_args()
+
+    sources = ["src/pomodoro_globals.cpp", "src/display_graphics.cpp", "src/display_updates.cpp",
+               "src/icons.cpp", "src/color_utils.cpp", "src/timer_logic.cpp"]
+    binary = host_build.build(args, "row_hash_bench", DRIVER, sources=sources, gfx=True)
+    plain, _ = run(args, binary, "plain")
+    hashed, ns = run(args, binary, "rowhash")
+
+    print("row hash: %.1f ns per %d px row" % (ns, 172))
+    print("%-8s %6s %9s %8s %9s %8s %8s %9s %8s" % ("step", "frames", "bytes", "windows", "hashed", "windows",
+                                                     "saved", "rows", "hash us"))
+    total = [0, 0, 0]
+    for (name, frames, windows, pbytes, rows), (_, _, hwindows, hbytes, _) in zip(plain, hashed):
+        us = rows * ns / 1000
+        print("%-8s %6d %9d %8d %9d %8d %7.1f%% %9d %8.1f" % (name, frames, pbytes, windows, hbytes, hwindows,
+                                                             100.0 * (pbytes - hbytes) / pbytes if pbytes else 0,
+                                                             rows, us))
+        total[0] += pbytes
+        total[1] += hbytes
+        total[2] += us
+    print("%-8s %6s %9d %8s %9d %8s %7.1f%% %9s %8.1f" % ("total", "", total[0], "", total[1], "",
+                                                         100.0 * (total[0] - total[1]) / total[0], "", total[2]))
+    if total[1] > total[0]:
+        sys.exit("the row hash sent more than the plain flush")
+
+
+if __name__ == "__main__":
+    main()
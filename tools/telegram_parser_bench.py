@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""Host benchmark and check of the getUpdates parser (src/telegram_json.h).
+
+Builds src/telegram_json.cpp into a small host program with malloc, calloc
+and realloc wrapped by the linker. Each recorded response is fed to
+TelegramUpdateParser one byte at a time, as the firmware's TLS reader does.
+The program reports time per response and per byte, and the heap
+allocations made. The parsed updates are then checked against the same
+payload decoded by Python's json module:
+  - update_id
+  - chat id and date of the message-like member
+  - text, cut like the parser cuts it to TG_TEXT_MAX - 1 bytes
+
+The recorded payloads are in tools/telegram_payloads/. Others can be given
+on the command line, e.g. a response saved with
+curl "https://api.telegram.org/bot<token>/getUpdates".
+
+    python3 tools/telegram_parser_bench.py
+    python3 tools/telegram_parser_bench.py --arduinojson ~/src/ArduinoJson/src my_updates.json
+
+With --arduinojson (a directory holding ArduinoJson.h, version 6) the same
+payloads also go through what UniversalTelegramBot did: the response copied
+into a string, deserialized into a DynamicJsonDocument, and each text and
+chat id copied out. That path is timed and its allocations counted too.
+Needs a C++17 compiler and a GNU-compatible linker (--wrap).
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PAYLOADS = os.path.join(REPO, "tools", "telegram_payloads")
+MESSAGE_KEYS = ("message", "edited_message", "channel_post", "edited_channel_post")
+
+HARNESS = r"""
+#include "telegram_json.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef BENCH_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+static unsigned long allocations = 0;
+static bool counting = false;
+
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t m);
+void* __real_realloc(void* p, size_t n);
+void* __wrap_malloc(size_t n) { if (counting) allocations++; return __real_malloc(n); }
+void* __wrap_calloc(size_t n, size_t m) { if (counting) allocations++; return __real_calloc(n, m); }
+void* __wrap_realloc(void* p, size_t n) { if (counting) allocations++; return __real_realloc(p, n); }
+}
+
+static double nowUs() {
+  using namespace std::chrono;
+  return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void printJsonString(const char* s) {
+  putchar('"');
+  for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+    if (*p == '"' || *p == '\\') printf("\\%c", *p);
+    else if (*p < 0x20) printf("\\u%04x", *p);
+    else putchar(*p);
+  }
+  putchar('"');
+}
+
+int main(int argc, char** argv) {
+  int runs = atoi(argv[1]);
+  for (int a = 2; a < argc; a++) {
+    FILE* f = fopen(argv[a], "rb");
+    if (!f) return 2;
+    std::vector<char> body;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) body.insert(body.end(), chunk, chunk + n);
+    fclose(f);
+
+    TelegramUpdate updates[TG_UPDATES_PER_POLL];
+    TelegramUpdateParser parser;
+    allocations = 0;
+    counting = true;
+    double t0 = nowUs();
+    for (int r = 0; r < runs; r++) {
+      parser.begin(updates, TG_UPDATES_PER_POLL);
+      for (char c : body) parser.feed(&c, 1);
+    }
+    double streamUs = (nowUs() - t0) / runs;
+    counting = false;
+    unsigned long streamAllocs = allocations / runs;
+
+    // One JSON line per payload for the Python side
+    printf("{\"file\":");
+    printJsonString(argv[a]);
+    printf(",\"bytes\":%zu,\"stream_us\":%.3f,\"stream_allocs\":%lu,\"done\":%s,\"ok\":%s,\"updates\":[",
+           body.size(), streamUs, streamAllocs, parser.done() ? "true" : "false", parser.ok() ? "true" : "false");
+    for (uint8_t i = 0; i < parser.count(); i++) {
+      printf("%s{\"update_id\":%ld,\"date\":%lu,\"chat\":", i ? "," : "", (long)updates[i].updateId,
+             (unsigned long)updates[i].date);
+      printJsonString(updates[i].chatId);
+      printf(",\"text\":");
+      printJsonString(updates[i].text);
+      printf(",\"truncated\":%s}", updates[i].truncated ? "true" : "false");
+    }
+    printf("]");
+
+#ifdef BENCH_ARDUINOJSON
+    // What UniversalTelegramBot did: response in a string, whole document, string copies
+    size_t libCount = 0;
+    bool libOk = true;
+    allocations = 0;
+    counting = true;
+    t0 = nowUs();
+    for (int r = 0; r < runs; r++) {
+      std::string response(body.data(), body.size());
+      DynamicJsonDocument doc(1500);  // The library's default maxMessageLength
+      libOk = !deserializeJson(doc, response);
+      std::string texts[TG_UPDATES_PER_POLL];
+      std::string chats[TG_UPDATES_PER_POLL];
+      JsonArray result = doc["result"];
+      libCount = 0;
+      for (JsonObject update : result) {
+        if (libCount >= TG_UPDATES_PER_POLL) break;
+        texts[libCount] = update["message"]["text"].as<std::string>();
+        chats[libCount] = update["message"]["chat"]["id"].as<std::string>();
+        libCount++;
+      }
+    }
+    double libUs = (nowUs() - t0) / runs;
+    counting = false;
+    printf(",\"library_us\":%.3f,\"library_allocs\":%lu,\"library_ok\":%s,\"library_updates\":%zu", libUs,
+           allocations / runs, libOk ? "true" : "false", libCount);
+#endif
+    printf("}\n");
+  }
+  return 0;
+}
+"""
+
+
+def config_value(name):
+    with open(os.path.join(REPO, "src", "pomodoro_config.h")) as f:
+        m = re.search(r"^#define %s (\d+)" % name, f.read(), re.M)
+    return int(m.group(1))
+
+
+def cut_utf8(text, limit):
+    """The text as the parser keeps it: at most limit bytes, whole characters."""
+    data = text.encode()
+    if len(data) <= limit:
+        return text, False
+    data = data[:limit]
+    return data.decode(errors="ignore"), True
+
+
+def expected_updates(path, capacity, text_max):
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+    out = []
+    for update in doc.get("result", [])[:capacity]:
+        msg = next((update[k] for k in MESSAGE_KEYS if isinstance(update.get(k), dict)), {})
+        text, cut = cut_utf8(msg.get("text", ""), text_max - 1)
+        chat = msg.get("chat", {}).get("id")
+        out.append({"update_id": update.get("update_id", 0), "date": msg.get("date", 0),
+                    "chat": "" if chat is None else str(chat), "text": text, "truncated": cut})
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("payloads", nargs="*", help="getUpdates response bodies (default: tools/telegram_payloads)")
+    parser.add_argument("--runs", type=int, default=2000)
+    parser.add_argument("--arduinojson", metavar="DIR", help="directory with ArduinoJson.h (v6) to compare against")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--keep", metavar="DIR", help="write the harness to DIR and keep it")
+    args = parser.parse_args()
+    payloads = args.payloads or sorted(glob.glob(os.path.join(PAYLOADS, "*.json")))
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="telegram_parser_bench_")
+    os.makedirs(workdir, exist_ok=True)
+    source = os.path.join(workdir, "telegram_parser_bench.cpp")
+    binary = os.path.join(workdir, "telegram_parser_bench")
+    with open(source, "w") as f:
+        f.write(HARNESS)
+
+    cmd = [args.cxx, "-std=c++17", "-O2", "-I" + os.path.join(REPO, "src"), source,
+           os.path.join(REPO, "src", "telegram_json.cpp"), "-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc",
+           "-o", binary]
+    if args.arduinojson:
+        cmd[3:3] = ["-DBENCH_ARDUINOJSON", "-I" + args.arduinojson]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    if build.returncode != 0:
+        sys.stderr.write(build.stderr)
+        sys.exit("build failed: " + " ".join(cmd))
+    run = subprocess.run([binary, str(args.runs)] + payloads, capture_output=True, text=True, check=True)
+
+    capacity = config_value("TG_UPDATES_PER_POLL")
+    text_max = config_value("TG_TEXT_MAX")
+    mismatches = 0
+    for line in run.stdout.splitlines():
+        r = json.loads(line)
+        name = os.path.basename(r["file"])
+        print("%-12s %6d B  stream %8.1f us  %5.1f ns/B  %lu allocs" %
+              (name, r["bytes"], r["stream_us"], r["stream_us"] * 1000 / r["bytes"], r["stream_allocs"]))
+        if "library_us" in r:
+            print("%-12s %8s  ArduinoJson %3.1f us  %lu allocs%s" %
+                  ("", "", r["library_us"], r["library_allocs"], "" if r["library_ok"] else "  PARSE ERROR"))
+        if not (r["done"] and r["ok"]):
+            print("  parse failed")
+            mismatches += 1
+            continue
+        want = expected_updates(r["file"], capacity, text_max)
+        for got, exp in zip(r["updates"], want):
+            if got != exp:
+                print("  update %s differs:\n    parser %s\n    json   %s" % (exp["update_id"], got, exp))
+                mismatches += 1
+        if len(r["updates"]) != len(want):
+            print("  %d updates parsed, %d expected" % (len(r["updates"]), len(want)))
+            mismatches += 1
+    sys.exit(1 if mismatches else 0)
+
+
+if __name__ == "__main__":
+    main()
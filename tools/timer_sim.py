@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""Fast-forward the timer engine on a stepped fake clock and check its schedule.
+
+Builds timer_logic.cpp with the display code (indexed canvas, host panel
+bus, see host_build.py) and runs days of work/rest cycles in seconds. The
+fake clock steps straight to the next moment the engine has work to do,
+a frame or a phase end. Like the firmware loop, it only lands on a grid
+of --loop ms. Each step is one main.cpp loop pass: updateTimer(),
+updateDisplay(), flushDisplay(). Telegram events and session records are
+counted instead of sent.
+
+Every scenario is checked against a model of the same loop grid:
+
+  transitions and completed work phases match the model exactly
+  each phase change fires at the first loop tick after its deadline, so it
+  is never a full loop period late, and the accumulated drift matches
+  one frame per second: redraws between simulated s * 1000 / (1000 + loop)
+  and simulated s + 1
+  one REST_TIME per work phase, one WORK_TIME per rest phase, one
+  WORK_STARTED and one TIMER_STOPPED; a session record per phase
+
+    python3 tools/timer_sim.py
+    python3 tools/timer_sim.py --hours 240 --loop 7
+    python3 tools/timer_sim.py --cxx "riscv32-unknown-linux-gnu-g++ -march=rv32imac -mabi=ilp32 -static" \\
+        --runner qemu-riscv32
+
+The wrap scenarios start one hour before 2^32 ms. The engine keeps
+absolute times in 64 bits (appMillis64()), so those runs check that
+nothing changes across the boundary. On a 64-bit host appMillis() does
+not wrap with them. For the 32-bit debounce arithmetic, build for
+rv32imac as above.
+"""
+
+import argparse
+import shlex
+import subprocess
+import sys
+
+import host_build
+
+DRIVER = r"""
+#include "pomodoro_globals.h"
+#include "display_graphics.h"
+#include "display_updates.h"
+#include "timer_logic.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "input_trace.h"
+#include "session_log.h"
+#include "telegram_status.h"
+#include "host_clock.h"
+#include <stdlib.h>
+
+uint8_t batteryPercent() { return 80; }
+void traceAction(TraceAction) {}
+void traceFrameDone(bool) {}
+
+static uint32_t notifications[MSG_COUNT];
+static uint32_t sessionsStarted, sessionsEnded;
+
+void sendTelegramEvent(MessageId id) { notifications[id]++; }
+void sessionStarted() { sessionsStarted++; }
+void sessionEnded(bool, PomodoroMode, unsigned long, bool) { sessionsEnded++; }
+
+static void loopPass() {
+  updateTimer();
+  updateDisplay();
+  flushDisplay();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 5) return 2;
+  PomodoroMode mode = (PomodoroMode)atoi(argv[1]);
+  uint32_t hours = strtoul(argv[2], nullptr, 0);
+  uint64_t now = strtoull(argv[3], nullptr, 0);
+  uint64_t loopMs = strtoull(argv[4], nullptr, 0);
+  uint64_t end = now + hours * 3600000ULL;
+  uint64_t startMs = now;
+
+  gfx->begin();  // Its delays would move the fake clock
+  initUIColorSlots(selectedWorkColor);
+  gfx->setRotation(currentRotation);
+  hostClockSet(now * 1000);
+  currentMode = mode;
+  displayStoppedState();
+  flushDisplay();
+
+  startTimer();
+  loopPass();
+  uint32_t framesAtStart = displayFramesDrawn();
+
+  uint32_t steps = 0, transitions = 0, workPhases = 0, maxLateMs = 0;
+  uint64_t totalLateMs = 0;
+  bool crossedWrap = false;
+  while (true) {
+    uint64_t deadline = startTime + getCurrentDuration();
+    uint64_t frameDue = now + msUntilNextFrame();
+    uint64_t next = (deadline < frameDue) ? deadline : frameDue;
+    next = ((next + loopMs - 1) / loopMs) * loopMs;
+    if (next <= now) next = now + loopMs;
+    if (next > end) break;
+    if ((next >> 32) != (now >> 32)) crossedWrap = true;
+    now = next;
+    hostClockSet(now * 1000);
+
+    bool wasWork = isWorkSession;
+    loopPass();
+    steps++;
+    if (isWorkSession != wasWork) {
+      uint32_t late = (uint32_t)(now - deadline);
+      transitions++;
+      if (wasWork) workPhases++;
+      totalLateMs += late;
+      if (late > maxLateMs) maxLateMs = late;
+    }
+  }
+  uint32_t redraws = displayFramesDrawn() - framesAtStart;
+  stopTimer();
+
+  printf("simulated_ms %llu steps %u transitions %u work_phases %u max_late_ms %u total_late_ms %llu "
+         "redraws %u crossed_wrap %d work_started %u rest_time %u work_time %u stopped %u "
+         "sessions_started %u sessions_ended %u\n",
+         (unsigned long long)(now - startMs), steps, transitions, workPhases, maxLateMs,
+         (unsigned long long)totalLateMs, redraws, crossedWrap, notifications[MSG_WORK_STARTED],
+         notifications[MSG_REST_TIME], notifications[MSG_WORK_TIME], notifications[MSG_TIMER_STOPPED],
+         sessionsStarted, sessionsEnded);
+  return 0;
+}
+"""
+
+MODES = {"1/1": (0, 60000, 60000), "25/5": (1, 1500000, 300000), "50/10": (2, 3000000, 600000)}
+BOOT = 60000  # A minute after boot, past the 3 s Telegram debounce
+WRAP = (1 << 32) - 3600000
+
+
+def model(work_ms, rest_ms, start, hours, loop):
+    """Phase changes of an engine that sees time only on the loop grid."""
+    end = start + hours * 3600000
+    phase_start, work = start, True
+    transitions = work_phases = total_late = 0
+    while True:
+        deadline = phase_start + (work_ms if work else rest_ms)
+        fire = -(-deadline // loop) * loop
+        if fire > end:
+            break
+        transitions += 1
+        work_phases += work
+        total_late += fire - deadline
+        phase_start, work = fire, not work
+    return transitions, work_phases, total_late
+
+
+def run_scenario(args, binary, name, start, loop):
+    mode, work_ms, rest_ms = MODES[name]
+    cmd = shlex.split(args.runner) + [binary, str(mode), str(args.hours), str(start), str(loop)]
+    out = subprocess.run(cmd, capture_output=True, text=True)
+    if out.returncode != 0:
+        sys.stderr.write(out.stderr)
+        sys.exit("timer_sim failed: " + " ".join(cmd))
+    f = out.stdout.split()
+    r = {f[i]: int(f[i + 1]) for i in range(0, len(f), 2)}
+
+    transitions, work_phases, total_late = model(work_ms, rest_ms, start, args.hours, loop)
+    seconds = r["simulated_ms"] / 1000.0
+    checks = [
+        ("transitions", r["transitions"] == transitions, "%d, model %d" % (r["transitions"], transitions)),
+        ("work phases", r["work_phases"] == work_phases, "%d, model %d" % (r["work_phases"], work_phases)),
+        ("max late", r["max_late_ms"] < loop, "%d ms, loop %d ms" % (r["max_late_ms"], loop)),
+        ("drift", r["total_late_ms"] == total_late, "%d ms, model %d ms" % (r["total_late_ms"], total_late)),
+        ("redraws", seconds * 1000 / (1000 + loop) <= r["redraws"] <= seconds + 1,
+         "%d in %.0f s" % (r["redraws"], seconds)),
+        ("REST_TIME", r["rest_time"] == r["work_phases"], "%d" % r["rest_time"]),
+        ("WORK_TIME", r["work_time"] == r["transitions"] - r["work_phases"], "%d" % r["work_time"]),
+        ("start/stop", r["work_started"] == 1 and r["stopped"] == 1, "%d/%d" % (r["work_started"], r["stopped"])),
+        ("sessions", r["sessions_started"] == r["transitions"] + 1 and r["sessions_ended"] == r["transitions"] + 1,
+         "%d started, %d ended" % (r["sessions_started"], r["sessions_ended"])),
+    ]
+    if start == WRAP:
+        checks.append(("wrap", r["crossed_wrap"] == 1, "crossed 2^32 ms" if r["crossed_wrap"] else "not crossed"))
+
+    label = "%-5s loop %2d ms from %s" % (name, loop, "2^32 - 1 h" if start == WRAP else "1 min")
+    print("%s: %d transitions, %d steps, drift %d ms (max %d per change), %d redraws" %
+          (label, r["transitions"], r["steps"], r["total_late_ms"], r["max_late_ms"], r["redraws"]))
+    failures = []
+    for what, ok, detail in checks:
+        if not ok:
+            failures.append("%s: %s %s" % (label, what, detail))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    host_build.add_arguments(parser)
+    parser.add_argument("--hours", type=int, default=24, help="simulated hours per scenario")
+    parser.add_argument("--loop", type=int, default=0, help="only this loop period, ms (default 5 and 7)")
+    parser.add_argument("--runner", default="", help="prefix to run the binary with, e.g. qemu-riscv32")
+    args = parser.parse_args()
+
+    sources = ["src/pomodoro_globals.cpp", "src/display_graphics.cpp", "src/display_updates.cpp",
+               "src/icons.cpp", "src/color_utils.cpp", "src/timer_logic.cpp"]
+    binary = host_build.build(args, "timer_sim", DRIVER, sources=sources, gfx=True)
+
+    loops = [args.loop] if args.loop else [5, 7]
+    failures = []
+    for name in MODES:
+        for loop in loops:
+            for start in (BOOT, WRAP):
+                failures += run_scenario(args, binary, name, start, loop)
+    for f in failures:
+        print("FAIL " + f)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
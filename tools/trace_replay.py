@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+"""Replay an input trace through the firmware's input code on the host.
+
+Builds touch_handler.cpp, auto_rotation.cpp, remote_commands.cpp and
+timer_logic.cpp with the display code (indexed canvas, host panel bus,
+see host_build.py). The trace is a dump from the device: 't' on Serial
+records, 'd' prints it (input_trace.h). The driver puts the UI in the
+"# start" state of the dump. Then it steps a virtual clock through the
+trace one millisecond at a time from the recorded start time. Each step
+first applies the events that are due:
+
+  TP_INT levels go to digitalRead(TP_INT)
+  touch points become the touch controller's I2C reply, in its own
+  (unrotated) coordinates for the rotation the replay is in
+  IMU samples become the accelerometer reading, and the IMU is read at
+  the moments the recording did, not on a cadence of its own
+  Telegram commands set the command flags
+
+Then it makes one main.cpp loop pass: handleTouchInput(),
+processTelegramCommands(), updateTimer(), updateDisplay(),
+checkAutoRotation(), flushDisplay(). Settings, session records and
+Telegram messages are not kept. The checks:
+
+  the replay ends in the same actions (start, pause, tap, rotate...) in
+  the same order as the recording, each within --slack ms of its
+  recorded time
+  the UI state at the end matches the "# end" line; timer times within
+  --slack ms
+
+The device's loop passes are a few ms apart, and a frame or a settings
+write can stretch one. The replay reacts on the exact ms, so times can
+come out a little earlier than recorded.
+
+    python3 tools/trace_replay.py trace.txt       # a Serial capture with the 'd' output in it
+    python3 tools/trace_replay.py                 # tools/trace_samples/session.csv
+    python3 tools/trace_replay.py trace.txt -v    # print every action
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+import host_build
+
+REPO = host_build.REPO
+SAMPLE = os.path.join(REPO, "tools", "trace_samples", "session.csv")
+
+DRIVER = r"""
+#include "pomodoro_globals.h"
+#include "display_graphics.h"
+#include "display_updates.h"
+#include "timer_logic.h"
+#include "touch_handler.h"
+#include "auto_rotation.h"
+#include "remote_commands.h"
+#include "app_clock.h"
+#include "battery.h"
+#include "backlight.h"
+#include "input_trace.h"
+#include "session_log.h"
+#include "storage.h"
+#include "sd_export.h"
+#include "telegram_status.h"
+#include "wifi_telegram.h"
+#include "host_clock.h"
+#include "host_io.h"
+#include <stdio.h>
+#include <vector>
+
+// Neighbours of the input code whose effects stay off the host
+uint8_t batteryPercent() { return 80; }
+void sendTelegramEvent(MessageId) {}
+void sendTelegramMessage(const char*, bool) {}
+void sessionEnded(bool, PomodoroMode, unsigned long, bool) {}
+void sessionStarted() {}
+void saveSettings() {}
+bool startSdExport(SdExportFormat) { return false; }
+bool sdExportBusy() { return false; }
+const char* messageTemplate(MessageId) { return ""; }
+void backlightActivity() {}
+bool backlightDimmed() { return false; }
+void bsp_touch_init(TwoWire*, int, int, uint16_t, uint16_t, uint16_t) {}
+
+// The trace hooks: recording is the device's job, the actions are the result
+void traceRecordTouchInt(int) {}
+void traceRecordTouchPoints(const touch_data_t&) {}
+void traceRecordImu(int32_t, int32_t) {}
+void traceTelegramCommands() {}
+void traceInputEvent() {}
+void traceFrameDone(bool) {}
+
+static uint64_t traceStartMs = 0;
+
+void traceAction(TraceAction action) {
+  printf("action %llu %u\n", (unsigned long long)(appMillis64() - traceStartMs), action);
+}
+
+struct Event {
+  uint32_t ms;
+  uint8_t type;
+  uint8_t a;
+  int16_t x;
+  int16_t y;
+};
+
+// --- Helper: the controller's reply for a point in display coordinates ---
+// Inverse of the rotation readTouchData() applies
+static void setTouchReply(uint8_t num, int16_t dx, int16_t dy) {
+  int16_t w = gfx->width(), h = gfx->height();
+  int16_t x = dx, y = dy;
+  switch (gfx->getRotation()) {
+    case 0: x = w - 1 - dx; y = dy; break;
+    case 1: x = dy; y = dx; break;
+    case 2: x = dx; y = h - 1 - dy; break;
+    case 3: x = h - 1 - dy; y = w - 1 - dx; break;
+  }
+  uint8_t data[14] = { 0 };
+  data[1] = num;
+  data[2] = (x >> 8) & 0x0F;
+  data[3] = x & 0xFF;
+  data[4] = (y >> 8) & 0x0F;
+  data[5] = y & 0xFF;
+  hostI2cReply(0x63, data, sizeof(data));
+}
+
+static void printState(const char* which) {
+  uint64_t now = appMillis64();
+  unsigned long elapsed = (currentState == RUNNING) ? (now - startTime) : (currentState == PAUSED) ? elapsedBeforePause : 0;
+  unsigned long sinceStart = (timerStartTime > 0) ? (now - timerStartTime) : 0;
+  printf("# %s clock=%llu state=%u work=%u elapsed=%lu since_start=%lu mode=%u view=%u grid=%u "
+         "minutes_only=%u rotation=%u work_color=%u rest_color=%u\n",
+         which, (unsigned long long)now, currentState, isWorkSession, elapsed, sinceStart, currentMode,
+         currentViewMode, gridViewActive, showMinutesOnly, currentRotation, selectedWorkColor, selectedRestColor);
+}
+
+int main() {
+  unsigned long long clock;
+  unsigned state, work, mode, view, grid, minutesOnly, rotation, workColor, restColor;
+  unsigned long elapsed, sinceStart;
+  if (scanf("%llu %u %u %lu %lu %u %u %u %u %u %u %u", &clock, &state, &work, &elapsed, &sinceStart, &mode,
+            &view, &grid, &minutesOnly, &rotation, &workColor, &restColor) != 12) {
+    return 2;
+  }
+  std::vector<Event> events;
+  Event e;
+  unsigned type, a;
+  int x, y;
+  while (scanf("%u %u %u %d %d", &e.ms, &type, &a, &x, &y) == 5) {
+    e.type = type;
+    e.a = a;
+    e.x = x;
+    e.y = y;
+    events.push_back(e);
+  }
+  if (events.empty()) return 2;
+
+  gfx->begin();  // Its delays would move the virtual clock
+  initUIColorSlots(selectedWorkColor);
+  traceStartMs = clock;
+  hostClockSet(clock * 1000);
+
+  // The "# start" state
+  currentState = (TimerState)state;
+  isWorkSession = work;
+  startTime = clock - elapsed;
+  elapsedBeforePause = elapsed;
+  timerStartTime = sinceStart ? clock - sinceStart : 0;
+  currentMode = (PomodoroMode)mode;
+  currentViewMode = view;
+  gridViewActive = grid;
+  showMinutesOnly = minutesOnly;
+  currentRotation = rotation;
+  selectedWorkColor = workColor;
+  selectedRestColor = restColor;
+  imuInitialized = true;
+  gfx->setRotation(currentRotation);
+  setUIColor(getCurrentUIColor());
+  redrawCurrentView();
+  flushDisplay();
+
+  // The touch debounce starts out pressed after boot; a recording starts long after it settled
+  hostClockSet((clock - 2 * TP_INT_DEBOUNCE_MS) * 1000);
+  handleTouchInput();
+  hostClockSet((clock - TP_INT_DEBOUNCE_MS) * 1000);
+  handleTouchInput();
+
+  size_t next = 0;
+  uint32_t endMs = events.back().ms;
+  for (uint32_t t = 0; t <= endMs; t++) {
+    hostClockSet((clock + t) * 1000);
+    bool imuDue = false;
+    for (; next < events.size() && events[next].ms <= t; next++) {
+      const Event& ev = events[next];
+      switch (ev.type) {
+        case TRACE_TP_INT:
+          hostPinSet(TP_INT, ev.a);
+          break;
+        case TRACE_TOUCH:
+          setTouchReply(ev.a, ev.x, ev.y);
+          break;
+        case TRACE_IMU:
+          hostImuSet(ev.x / 1000.0f + (ev.x < 0 ? -0.0004f : 0.0004f),  // Truncates back to the same milli-g
+                     ev.y / 1000.0f + (ev.y < 0 ? -0.0004f : 0.0004f), 0.0f);
+          imuDue = true;
+          break;
+        case TRACE_TELEGRAM:
+          if (ev.a & TRACE_TG_START) telegramCmdStart = true;
+          if (ev.a & TRACE_TG_PAUSE) telegramCmdPause = true;
+          if (ev.a & TRACE_TG_RESUME) telegramCmdResume = true;
+          if (ev.a & TRACE_TG_STOP) telegramCmdStop = true;
+          if (ev.a & TRACE_TG_MODE) telegramCmdMode = true;
+          break;
+        default:
+          break;
+      }
+    }
+    // The IMU is read on the recorded samples only
+    lastRotationCheck = imuDue ? appMillis() - ROTATION_CHECK_INTERVAL : appMillis();
+
+    // Same order as loop()
+    handleTouchInput();
+    processTelegramCommands();
+    updateTimer();
+    updateDisplay();
+    checkAutoRotation();
+    flushDisplay();
+  }
+  printState("end");
+  return 0;
+}
+"""
+
+STATE_FIELDS = ["clock", "state", "work", "elapsed", "since_start", "mode", "view", "grid", "minutes_only",
+                "rotation", "work_color", "rest_color"]
+TIMED_FIELDS = ["elapsed", "since_start"]
+EVENT_ROW = re.compile(r"^(\d+),(\d+),(\d+),(-?\d+),(-?\d+)$")
+
+
+def load_header():
+    """Event type numbers and action names from src/input_trace.h."""
+    with open(os.path.join(REPO, "src", "input_trace.h")) as f:
+        text = f.read()
+    actions = [name for _, name in re.findall(r'X\((ACT_\w+),\s*"(\w+)"\)', text)]
+    body = re.search(r"enum TraceEventType[^{]*\{(.*?)\};", text, re.S).group(1)
+    types = re.findall(r"^\s*(TRACE_\w+)", body, re.M)
+    return {name: i for i, name in enumerate(types)}, actions
+
+
+def parse_state(line):
+    fields = dict(kv.split("=", 1) for kv in line.split()[2:])
+    return {k: int(fields[k]) for k in STATE_FIELDS}
+
+
+def load_trace(path):
+    """The start/end states and event rows of a dump; other Serial lines are skipped."""
+    start = end = None
+    rows = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("# start "):
+                start, end, rows = parse_state(line), None, []  # The last dump in a capture wins
+            elif line.startswith("# end "):
+                end = parse_state(line)
+            else:
+                m = EVENT_ROW.match(line)
+                if m and start is not None:
+                    rows.append(tuple(int(v) for v in m.groups()))
+    if start is None or not rows:
+        sys.exit("%s: no trace dump ('d' on Serial) found" % path)
+    if end is None:
+        sys.exit("%s: the dump was taken while recording, it has no '# end' state" % path)
+    return start, end, rows
+
+
+def compare_actions(recorded, replayed, names, slack, verbose):
+    """Failures and the largest time difference; stops at the first action that differs."""
+    def label(e):
+        return "%s %d ms" % (names[e[1]], e[0]) if e else "nothing"
+
+    failures = []
+    worst = 0
+    for i in range(max(len(recorded), len(replayed))):
+        rec = recorded[i] if i < len(recorded) else None
+        rep = replayed[i] if i < len(replayed) else None
+        if verbose:
+            print("  recorded %-16s replayed %s" % (label(rec), label(rep)))
+        if rec is None or rep is None or rec[1] != rep[1]:
+            failures.append("action %d: recorded %s, replayed %s" % (i, label(rec), label(rep)))
+            break
+        worst = max(worst, abs(rep[0] - rec[0]))
+        if abs(rep[0] - rec[0]) > slack:
+            failures.append("action %d: recorded %s, replayed %s" % (i, label(rec), label(rep)))
+    return failures, worst
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    host_build.add_arguments(parser)
+    parser.add_argument("trace", nargs="?", default=SAMPLE, help="device dump, default: the sample trace")
+    parser.add_argument("--slack", type=int, default=50, help="ms an action or timer time may differ by")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    types, action_names = load_header()
+    start, end, rows = load_trace(args.trace)
+
+    sources = ["src/pomodoro_globals.cpp", "src/display_graphics.cpp", "src/display_updates.cpp",
+               "src/icons.cpp", "src/color_utils.cpp", "src/timer_logic.cpp", "src/touch_handler.cpp",
+               "src/auto_rotation.cpp", "src/remote_commands.cpp"]
+    binary = host_build.build(args, "trace_replay", DRIVER, sources=sources, gfx=True)
+
+    stdin = " ".join(str(start[k]) for k in STATE_FIELDS) + "\n"
+    stdin += "".join("%d %d %d %d %d\n" % r for r in rows)
+    out = subprocess.run([binary], input=stdin, capture_output=True, text=True)
+    if out.returncode != 0:
+        sys.stderr.write(out.stderr)
+        sys.exit("trace_replay failed")
+
+    replayed = []
+    replay_end = None
+    for line in out.stdout.splitlines():
+        if line.startswith("action "):
+            _, ms, a = line.split()
+            replayed.append((int(ms), int(a)))
+        elif line.startswith("# end "):
+            replay_end = parse_state(line)
+    recorded = [(ms, a) for ms, t, a, _, _ in rows if t == types["TRACE_ACTION"]]
+
+    failures, worst = compare_actions(recorded, replayed, action_names, args.slack, args.verbose)
+    if replay_end is None:
+        failures.append("no end state from the replay")
+    else:
+        for k in STATE_FIELDS[1:]:
+            diff = abs(replay_end[k] - end[k])
+            if k in TIMED_FIELDS:
+                worst = max(worst, diff)
+            if diff > (args.slack if k in TIMED_FIELDS else 0):
+                failures.append("end state %s: recorded %d, replayed %d" % (k, end[k], replay_end[k]))
+
+    print("%s: %d events over %d ms, %d actions, worst time difference %d ms" %
+          (os.path.relpath(args.trace), len(rows), rows[-1][0], len(replayed), worst))
+    for f in failures:
+        print("FAIL " + f)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()